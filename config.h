@@ -43,28 +43,203 @@
 
 #include "cy_flash.h"
 
-/* Last Boot loader row. This field should be changed only when there is a
- * project level change, and should be coupled with a change in the linker settings
- * and boot-loadable placement settings for the firmware application.
- */
-#if (CY_FLASH_SIZEOF_ROW == 128)
-#define PMG1_BOOT_LOADER_LAST_ROW        (0x37)
-#elif (CY_FLASH_SIZEOF_ROW == 256)
-#define PMG1_BOOT_LOADER_LAST_ROW        (0x1B)
-#else
+/* The boot-loader takes the flash rows up to the end of its linked image, see
+ * flash_get_bl_last_row(). The post-build step writes the resulting layout for the
+ * firmware application linker scripts (pmg1_bl_layout.*, see README.md).
+ */
+#if ((CY_FLASH_SIZEOF_ROW != 128) && (CY_FLASH_SIZEOF_ROW != 256))
 #error "Selected device has unsupported flash row size."
 #endif /* CY_FLASH_SIZEOF_ROW */
 
 /* Size of firmware metadata.*/
 #define PMG1_FW_METADATA_SIZE            (128)
 
+/* Number of firmware image slots. Slots 1 and 2 are the FW1/FW2 images of the
+ * dual application layout. A third (golden) slot can be enabled on parts with
+ * enough flash to hold a recovery image that is never overwritten once valid.
+ */
+#ifndef PMG1_FW_SLOT_COUNT
+#define PMG1_FW_SLOT_COUNT               (2)
+#endif /* PMG1_FW_SLOT_COUNT */
+
+#if ((PMG1_FW_SLOT_COUNT < 2) || (PMG1_FW_SLOT_COUNT > 4))
+#error "PMG1_FW_SLOT_COUNT must be in the range 2 to 4."
+#endif /* PMG1_FW_SLOT_COUNT */
+
+/* Slot holding the golden image. The golden slot does not take part in the boot
+ * sequence number comparison and is only booted when no other slot is valid.
+ * Set to 0 to disable.
+ */
+#ifndef PMG1_FW_GOLDEN_SLOT
+#if (PMG1_FW_SLOT_COUNT > 2)
+#define PMG1_FW_GOLDEN_SLOT              (PMG1_FW_SLOT_COUNT)
+#else
+#define PMG1_FW_GOLDEN_SLOT              (0)
+#endif /* (PMG1_FW_SLOT_COUNT > 2) */
+#endif /* PMG1_FW_GOLDEN_SLOT */
+
+/* Order in which the slots are considered. Among valid slots with equal boot
+ * sequence numbers, the one listed first wins. The default order keeps the
+ * legacy preference for FW2 over FW1 and lists the golden slot last.
+ */
+#ifndef PMG1_FW_SLOT_FALLBACK_ORDER
+#if (PMG1_FW_SLOT_COUNT == 2)
+#define PMG1_FW_SLOT_FALLBACK_ORDER      {2, 1}
+#elif (PMG1_FW_SLOT_COUNT == 3)
+#define PMG1_FW_SLOT_FALLBACK_ORDER      {2, 1, 3}
+#else
+#define PMG1_FW_SLOT_FALLBACK_ORDER      {2, 1, 3, 4}
+#endif /* PMG1_FW_SLOT_COUNT */
+#endif /* PMG1_FW_SLOT_FALLBACK_ORDER */
+
+/* Read-while-write layout, for parts with two flash macros. When enabled, slot 1 takes
+ * the rows of macro 0 above the boot-loader and slot 2 the rows of macro 1, each with
+ * its metadata row at the top of its macro, and an image that reaches into the other
+ * macro is refused. An application running from one slot then never shares a macro with
+ * the rows written for the other slot. Slot 1 is smaller by the boot-loader rows.
+ * Requires two slots and two flash macros.
+ */
+#ifndef PMG1_FW_RWW_LAYOUT
+#define PMG1_FW_RWW_LAYOUT               (0)
+#endif /* PMG1_FW_RWW_LAYOUT */
+
+#if (PMG1_FW_RWW_LAYOUT && ((PMG1_FW_SLOT_COUNT != 2) || !defined(CPUSS_SPCIF_FLASH_MACROS) || (CPUSS_SPCIF_FLASH_MACROS != 2)))
+#error "PMG1_FW_RWW_LAYOUT needs two firmware slots and a device with two flash macros."
+#endif /* PMG1_FW_RWW_LAYOUT */
+
+/* Metadata location for firmware slot n (1 based). Metadata rows are packed
+ * downwards from the last flash row, or placed at the top of macro n - 1 in the
+ * read-while-write layout.
+ */
+#if PMG1_FW_RWW_LAYOUT
+#define PMG1_FW_METADATA_ROW(n)          ((PMG1_FLASH_MACRO_ROWS * (n)) - 1u)
+#else
+#define PMG1_FW_METADATA_ROW(n)          (PMG1_LAST_FLASH_ROW_NUM - ((n) - 1))
+#endif /* PMG1_FW_RWW_LAYOUT */
+#define PMG1_FW_METADATA_ADDR(n)         (((PMG1_FW_METADATA_ROW(n) + 1) << PMG1_FLASH_ROW_SHIFT_NUM) - PMG1_FW_METADATA_SIZE)
+
 /* Metadata location for FW1.*/
-#define PMG1_FW1_METADATA_ROW            (PMG1_LAST_FLASH_ROW_NUM)
-#define PMG1_FW1_METADATA_ADDR           (((PMG1_FW1_METADATA_ROW + 1) << PMG1_FLASH_ROW_SHIFT_NUM) - PMG1_FW_METADATA_SIZE)
+#define PMG1_FW1_METADATA_ROW            (PMG1_FW_METADATA_ROW(1))
+#define PMG1_FW1_METADATA_ADDR           (PMG1_FW_METADATA_ADDR(1))
 
 /* Metadata location for FW2.*/
-#define PMG1_FW2_METADATA_ROW            (PMG1_LAST_FLASH_ROW_NUM - 1)
-#define PMG1_FW2_METADATA_ADDR           (((PMG1_FW2_METADATA_ROW + 1) << PMG1_FLASH_ROW_SHIFT_NUM) - PMG1_FW_METADATA_SIZE)
+#define PMG1_FW2_METADATA_ROW            (PMG1_FW_METADATA_ROW(2))
+#define PMG1_FW2_METADATA_ADDR           (PMG1_FW_METADATA_ADDR(2))
+
+/* Authenticated boot. When enabled, an image is only booted if the SHA-256 digest
+ * in its metadata matches and boot_auth_verify_signature() accepts the digest. The
+ * full check is done once, when the image is validated, and its result is kept in
+ * a verification record in the metadata row that later boots check instead. The record
+ * is keyed with boot_auth_get_record_key(); without a key, every boot runs the full check.
+ */
+#ifndef PMG1_AUTH_BOOT_ENABLE
+#define PMG1_AUTH_BOOT_ENABLE            (0)
+#endif /* PMG1_AUTH_BOOT_ENABLE */
+
+/* Trial boot. An updated image is started at most PMG1_TRIAL_BOOT_ATTEMPTS times
+ * before the application confirms it with boot_trial_confirm(). After that, the
+ * boot-loader invalidates the image and goes back to the best remaining slot.
+ * The attempts are counted in no-init RAM, so only resets that keep the RAM
+ * contents (watchdog, fault, soft reset) are counted.
+ */
+#ifndef PMG1_TRIAL_BOOT_ENABLE
+#define PMG1_TRIAL_BOOT_ENABLE           (0)
+#endif /* PMG1_TRIAL_BOOT_ENABLE */
+
+#ifndef PMG1_TRIAL_BOOT_ATTEMPTS
+#define PMG1_TRIAL_BOOT_ATTEMPTS         (3)
+#endif /* PMG1_TRIAL_BOOT_ATTEMPTS */
+
+/* Direct handoff. When enabled, the boot-loader starts the application by returning
+ * the hardware it used to its reset state and jumping to the application entry,
+ * instead of going through a system reset and Cy_OnResetUser().
+ */
+#ifndef PMG1_BOOT_DIRECT_HANDOFF
+#define PMG1_BOOT_DIRECT_HANDOFF         (0)
+#endif /* PMG1_BOOT_DIRECT_HANDOFF */
+
+/* Background image check. When enabled, the HPI interface is brought up before the
+ * firmware images are checked and the images are checked a chunk at a time from the
+ * main loop, so that the EC sees the device ready within milliseconds of reset.
+ */
+#ifndef PMG1_BOOT_BG_CHECK_ENABLE
+#define PMG1_BOOT_BG_CHECK_ENABLE        (0)
+#endif /* PMG1_BOOT_BG_CHECK_ENABLE */
+
+/* Image bytes checked per main loop pass by the background image check. Sets the
+ * longest delay HPI command handling sees: about 330 us per KB at 48 MHz.
+ */
+#ifndef PMG1_BOOT_CHECK_CHUNK_SIZE
+#define PMG1_BOOT_CHECK_CHUNK_SIZE       (1024u)
+#endif /* PMG1_BOOT_CHECK_CHUNK_SIZE */
+
+/* Image check event. When enabled along with the background image check, the boot-loader
+ * raises HPI_EXT_EVENT_CHECK_DONE on the EC interrupt once all slots have been checked,
+ * with the boot mode reason and the slot states, so that the EC need not poll for them.
+ */
+#ifndef PMG1_BOOT_CHECK_EVENT_ENABLE
+#define PMG1_BOOT_CHECK_EVENT_ENABLE     (0)
+#endif /* PMG1_BOOT_CHECK_EVENT_ENABLE */
+
+/* UART flashing transport. When enabled, the flashing commands are also accepted as
+ * frames (see bl_cmd.h) on the SCB configured as BL_UART in the device configurator,
+ * at the baud rate set there. The HPI I2C interface stays available.
+ */
+#ifndef PMG1_UART_TRANSPORT_ENABLE
+#define PMG1_UART_TRANSPORT_ENABLE       (0)
+#endif /* PMG1_UART_TRANSPORT_ENABLE */
+
+/* Boot-decision record. When enabled, validating the image that is to be booted next
+ * stores a copy of its metadata (location, size, CRC, digest and boot sequence number)
+ * in an SFLASH user row. A boot that finds the metadata of a slot unchanged against the
+ * record takes the image as intact without reading it, and main flash is not written.
+ * Entering flashing mode drops the record while its slot can be written, and so do the
+ * flash writes of the boot-loader services. The record is not bound to the image rows:
+ * applications that update a slot have to write it through the boot-loader services
+ * (PMG1_BL_SERVICES_ENABLE), as a row written any other way leaves the record in place
+ * and the changed image would be booted without its CRC being checked. Needs
+ * PMG1_SFLASH_USER_ROW_BASE, the address of SFLASH user row 0 of the device.
+ */
+#ifndef PMG1_BOOT_RECORD_ENABLE
+#define PMG1_BOOT_RECORD_ENABLE          (0)
+#endif /* PMG1_BOOT_RECORD_ENABLE */
+
+/* SFLASH user row holding the boot-decision record: 0 to PMG1_SFLASH_USER_ROW_COUNT - 1.*/
+#ifndef PMG1_BOOT_RECORD_SFLASH_ROW
+#define PMG1_BOOT_RECORD_SFLASH_ROW      (0)
+#endif /* PMG1_BOOT_RECORD_SFLASH_ROW */
+
+/* Turbo clock profile. When enabled on parts whose CY_CLK_SYSTEM_FREQ_HZ is below 48 MHz,
+ * the boot-loader runs at 48 MHz for the image check at start-up and for the flashing
+ * session, from entering to leaving flashing mode. The clock dividers of the HPI and UART
+ * SCBs (CLK_I2C_SLAVE and CLK_BL_UART in the device configurator) are scaled with the
+ * clock, so the bus rates stay the same. If a divider cannot be scaled exactly, the
+ * flashing session stays at CY_CLK_SYSTEM_FREQ_HZ. pmg1_bsp_deinit() restores the reset
+ * clock before the firmware is started. With the default CY_CLK_SYSTEM_FREQ_HZ of 48 MHz,
+ * the profile changes nothing.
+ */
+#ifndef PMG1_CLK_TURBO_ENABLE
+#define PMG1_CLK_TURBO_ENABLE            (0)
+#endif /* PMG1_CLK_TURBO_ENABLE */
+
+/* Boot-loader services. When enabled, a table of boot-loader routines (bl_services.h) is
+ * placed at flash offset 0x100, right after the version block: flash row programming,
+ * CRC-32C, image validation, slot metadata and the boot sequence number of a new image.
+ * Applications updating another slot call them instead of linking their own copies.
+ */
+#ifndef PMG1_BL_SERVICES_ENABLE
+#define PMG1_BL_SERVICES_ENABLE          (0)
+#endif /* PMG1_BL_SERVICES_ENABLE */
+
+/* Low power idle. When enabled, the boot-loader sleeps whenever its main loop has
+ * nothing left to do. Deep sleep is used while no soft timer runs, e.g. when there is
+ * no valid image or in flashing mode, and the HPI SCB wakes the device on an I2C address
+ * match. The boot-wait window uses CPU sleep, as the SysTick does not run in deep sleep.
+ * Set through the DEFINES of the Makefile.
+ */
+#ifndef SYS_DEEPSLEEP_ENABLE
+#define SYS_DEEPSLEEP_ENABLE             (0)
+#endif /* SYS_DEEPSLEEP_ENABLE */
 
 /* Firmware Version Information is located at a fixed offset of 0xE0 from start of firmware location.*/
 #define PMG1_FW_VERSION_OFFSET           (0xE0)
@@ -49,6 +49,15 @@
 #include "timer.h"
 #include "pmg1_version.h"
 #include "pmg1_bsp.h"
+#include "mem_stats.h"
+#include "hpi_ext.h"
+#include "boot_auth.h"
+#include "boot_record.h"
+#include "boot_handoff.h"
+#include "bl_cmd.h"
+#if PMG1_UART_TRANSPORT_ENABLE
+#include "bl_uart.h"
+#endif /* PMG1_UART_TRANSPORT_ENABLE */
 
 /* Device silicon ID */
 #define CY_PMG1_SILICON_ID              CY_SILICON_ID
@@ -59,6 +68,9 @@
 /* HPI extended version info. */
 #define HPI_VERSION_EXT_INFO            0x00000001u
 
+/* Device mode: HPI Version v2, selected flash row size, selected no. of ports, boot-loader running.*/
+#define BL_DEVICE_MODE                  (0x80 | (PMG1_FLASH_ROW_SIZE_DEV_MODE_VAL << 4) | ((NO_OF_TYPEC_PORTS - 1) << 2))
+
 /* Linker symbol used by the cymcuelf tool.*/
 #if defined(__ARMCC_VERSION)
 __asm
@@ -144,6 +156,27 @@ static volatile bool glBootWaitElapsed = false;
 /* HPI SCB and interrupt pin configuration.*/
 static cy_stc_hpi_context_t glHpiContext;
 
+#if SYS_DEEPSLEEP_ENABLE
+/* Low power idle statistics, published at HPI_EXT_REG_SLEEP_STATS.*/
+typedef struct
+{
+    uint16_t deepSleeps;                /**< Deep sleep entries. */
+    uint16_t hpiWakes;                  /**< Deep sleeps ended by an HPI address match. */
+    uint16_t wakeLastUs;                /**< Last wake-to-ACK time in us. */
+    uint16_t wakeMaxUs;                 /**< Largest wake-to-ACK time in us. */
+} bl_sleep_stats_t;
+
+static bl_sleep_stats_t glBlSleepStats;
+
+/* Time the CPU resumed from deep sleep, while the first HPI interrupt is awaited.*/
+static uint32_t glBlWakeUs;
+static volatile bool glBlWakePending = false;
+
+/* Wake-to-ACK time measured by the HPI interrupt, for the main loop to publish.*/
+static volatile uint32_t glBlWakeAckUs;
+static volatile bool glBlWakeAckDone = false;
+#endif /* SYS_DEEPSLEEP_ENABLE */
+
 /* Additional metadata information used by the 'CyMCUElfToo' tool. */
 CY_SECTION(".cymeta") __USED
 const uint8_t cy_metadata[] = {
@@ -156,15 +189,28 @@ const uint8_t cy_metadata[] = {
     0x3Au, 0x0Bu, 0x14u, 0xAEu
 };
 
-cy_stc_hpi_hw_config_t glHpiHwConfig =
+/* HPI hardware configuration for a given I2C slave address.*/
+#define HPI_HW_CONFIG(addr)                         \
+{                                                   \
+    .scbBase = HPI_I2C_HW,                          \
+    .scbPort = HPI_I2C_SCL_PORT,                    \
+    .slaveAddr = (addr),                            \
+    .ecIntPort = HPI_EC_INT_PORT,                   \
+    .ecIntPin = HPI_EC_INT_PIN                      \
+}
+
+/* HPI hardware configurations, one per slave address selectable through HPI_ADDR_CFG.
+ * Kept in flash; only the pointer to the selected entry lives in RAM.*/
+static const cy_stc_hpi_hw_config_t glHpiHwConfig[] =
 {
-    .scbBase = HPI_I2C_HW,
-    .scbPort = HPI_I2C_SCL_PORT,
-    .slaveAddr = CY_HPI_ADDR_I2C_CFG_FLOAT,
-    .ecIntPort = HPI_EC_INT_PORT,
-    .ecIntPin = HPI_EC_INT_PIN
+    HPI_HW_CONFIG(CY_HPI_ADDR_I2C_CFG_FLOAT),
+    HPI_HW_CONFIG(CY_HPI_ADDR_I2C_CFG_LOW),
+    HPI_HW_CONFIG(CY_HPI_ADDR_I2C_CFG_HIGH)
 };
 
+/* HPI hardware configuration selected by get_hpi_slave_addr().*/
+static const cy_stc_hpi_hw_config_t *glHpiHwConfigP = &glHpiHwConfig[0];
+
 /* CYBSP_I2C_SCB_IRQ*/
 const cy_stc_sysint_t HPI_SCB_IRQ_CONFIG = {
      .intrSrc = (IRQn_Type) HPI_I2C_IRQ,
@@ -180,19 +226,89 @@ const cy_stc_sysint_t HPI_SCB_IRQ_CONFIG = {
  {
      /* ISR implementation for I2C*/
      Cy_Hpi_I2cInterruptHandler(&glHpiContext);
+
+#if SYS_DEEPSLEEP_ENABLE
+     /* First HPI interrupt after a deep sleep: the address has been acknowledged.*/
+     if (glBlWakePending)
+     {
+         glBlWakeAckUs   = timer_get_time_us() - glBlWakeUs;
+         glBlWakePending = false;
+         glBlWakeAckDone = true;
+     }
+#endif /* SYS_DEEPSLEEP_ENABLE */
  }
 
+/* Switch the clock profile, keeping the soft timer period. Returns the previous profile.*/
+static pmg1_clk_profile_t bl_clk_profile (pmg1_clk_profile_t profile)
+{
+#if PMG1_CLK_TURBO_ENABLE
+    profile = pmg1_bsp_clk_profile_set (profile);
+    timer_clock_changed ();
+    return profile;
+#else
+    (void)profile;
+    return PMG1_CLK_PROFILE_NOMINAL;
+#endif /* PMG1_CLK_TURBO_ENABLE */
+}
+
 /* Timer callback used to identify that boot-wait window has elapsed.*/
 static void bl_timer_cb (void)
 {
    glBootWaitElapsed = true;
 }
 
+/* Start the selected firmware once the boot-loader is done.*/
+static void bl_start_fw (bool hpiActive)
+{
+    /* Pass the boot results on to the application.*/
+    boot_handoff_publish (glHpiSlaveAddr);
+
+#if PMG1_BOOT_DIRECT_HANDOFF
+    /* Shut down everything the boot-loader brought up and jump straight to the application.*/
+    if (hpiActive)
+    {
+        NVIC_DisableIRQ ((IRQn_Type) HPI_SCB_IRQ_CONFIG.intrSrc);
+        Cy_SCB_I2C_DeInit (glHpiHwConfigP->scbBase);
+    }
+
+#if PMG1_UART_TRANSPORT_ENABLE
+    if (hpiActive)
+    {
+        bl_uart_deinit ();
+    }
+#endif /* PMG1_UART_TRANSPORT_ENABLE */
+
+    timer_stop ();
+    pmg1_bsp_deinit ();
+    boot_handoff_to_app ();
+#else
+    (void)hpiActive;
+#endif /* PMG1_BOOT_DIRECT_HANDOFF */
+
+    /* Start the firmware through a reset.*/
+    boot_jump_to_fw ();
+}
+
+/* Firmware has been selected for boot: start it now, or return the boot-wait time.*/
+static uint16_t bl_boot_decided (bool hpiActive)
+{
+    uint16_t wait;
+
+    glBootDataSignature = BL_APP_DATA_VALID_SIG;
+    wait = boot_get_wait_time ();
+    if (wait == 0)
+    {
+        bl_start_fw (hpiActive);
+    }
+
+    return wait;
+}
+
 /* EC Interrupt status.*/
 void hpi_ec_intr_write(bool value)
 {
     /* Handler to control the HPI EC interrupt pin.*/
-    Cy_GPIO_Write(glHpiHwConfig.ecIntPort, glHpiHwConfig.ecIntPin, value);
+    Cy_GPIO_Write(glHpiHwConfigP->ecIntPort, glHpiHwConfigP->ecIntPin, value);
 }
 
 /* Firmware run type signature.*/
@@ -202,40 +318,278 @@ void set_bootloader_run_type(uint32_t runType)
     cyBtldrRunType = runType;
 }
 
+/* Publish the RAM usage summary in the HPI extension registers.*/
+static void hpi_update_mem_stats(void)
+{
+    mem_stats_t stats;
+
+    mem_stats_get(&stats);
+    Cy_Hpi_UpdateRegs(&glHpiContext, (uint8_t)CY_HPI_REG_SECTION_DEV, HPI_EXT_REG_MEM_STATS,
+                      (uint8_t *)&stats, sizeof(stats));
+}
+
+#if PMG1_FLASH_VERIFY_ENABLE
+/* Publish the flash read back verification results in the HPI extension registers.*/
+static void hpi_update_flash_verify(void)
+{
+    flash_verify_stats_t stats;
+
+    flash_get_verify_stats(&stats);
+    Cy_Hpi_UpdateRegs(&glHpiContext, (uint8_t)CY_HPI_REG_SECTION_DEV, HPI_EXT_REG_FLASH_VERIFY,
+                      (uint8_t *)&stats, sizeof(stats));
+}
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+
+#if SYS_DEEPSLEEP_ENABLE
+/* Sleep until the next interrupt, once the main loop has nothing left to do. Deep sleep
+ * stops the SysTick, so it is only entered while no soft timer runs; the boot-wait window
+ * uses CPU sleep and is woken by the 1 ms tick. In deep sleep, the HPI SCB wakes the device
+ * on an address match and stretches the clock until the CPU has resumed. The SCB UART
+ * does not receive in deep sleep, so the UART transport keeps the device in CPU sleep.*/
+static void bl_idle (void)
+{
+    uint32_t state;
+    uint32_t ackUs = 0;
+    bool ackDone;
+
+    state = Cy_SysLib_EnterCriticalSection ();
+    ackDone         = glBlWakeAckDone;
+    ackUs           = glBlWakeAckUs;
+    glBlWakeAckDone = false;
+    glBlWakePending = false;
+
+    /* Interrupts stay masked from the last check to the WFI: any of them still wakes the CPU.*/
+    if ((!glBootWaitElapsed) && Cy_Hpi_SleepAllowed (&glHpiContext))
+    {
+        if ((!PMG1_UART_TRANSPORT_ENABLE) && (!timer_is_running ()) && Cy_Hpi_Sleep (&glHpiContext))
+        {
+            (void)Cy_SysPm_CpuEnterDeepSleep ();
+            glBlWakeUs      = timer_get_time_us ();
+            glBlWakePending = true;
+            if (glBlSleepStats.deepSleeps != UINT16_MAX)
+            {
+                glBlSleepStats.deepSleeps++;
+            }
+        }
+        else
+        {
+            (void)Cy_SysPm_CpuEnterSleep ();
+        }
+    }
+    Cy_SysLib_ExitCriticalSection (state);
+
+    /* Publish the wake-to-ACK time of the previous deep sleep.*/
+    if (ackDone)
+    {
+        ackUs = (ackUs > UINT16_MAX) ? UINT16_MAX : ackUs;
+        glBlSleepStats.wakeLastUs = (uint16_t)ackUs;
+        if (glBlSleepStats.wakeLastUs > glBlSleepStats.wakeMaxUs)
+        {
+            glBlSleepStats.wakeMaxUs = glBlSleepStats.wakeLastUs;
+        }
+        if (glBlSleepStats.hpiWakes != UINT16_MAX)
+        {
+            glBlSleepStats.hpiWakes++;
+        }
+        Cy_Hpi_UpdateRegs(&glHpiContext, (uint8_t)CY_HPI_REG_SECTION_DEV, HPI_EXT_REG_SLEEP_STATS,
+                          (uint8_t *)&glBlSleepStats, sizeof(glBlSleepStats));
+    }
+}
+#endif /* SYS_DEEPSLEEP_ENABLE */
+
 /* Flash row to be updated.*/
 int8_t hpi_flash_row_write(uint16_t rowNum, uint8_t *data, void *cbk)
 {
     /*Write the given data to the specified flash row.*/
+    int8_t status;
+
     (void)cbk;
-    return flash_row_write(data, rowNum);
+    status = flash_row_write(data, rowNum);
+
+    /* The flash write is the deepest call path: refresh the stack high-water mark.*/
+    hpi_update_mem_stats();
+#if PMG1_FLASH_VERIFY_ENABLE
+    hpi_update_flash_verify();
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+    return status;
+}
+
+#if ((HPI_EXT_FLASH_READ_MAX > 0xFFu) || (HPI_EXT_FLASH_READ_MAX > CY_FLASH_SIZEOF_ROW) || \
+     (HPI_EXT_FLASH_READ_MAX > PMG1_FLASH_READ_MAX_SIZE))
+#error "HPI_EXT_FLASH_READ_MAX does not fit the Cy_Hpi_UpdateRegs() length or the HPI flash memory region."
+#endif /* HPI_EXT_FLASH_READ_MAX */
+
+/* Handle the flash read command.*/
+static cy_en_hpi_response_t hpi_ext_flash_read(uint8_t size, uint8_t *data)
+{
+    const uint8_t *src;
+    uint32_t addr;
+    uint16_t length;
+    int8_t status;
+
+    if ((size < HPI_EXT_REG_FLASH_READ_SIZE) || (data[0] != HPI_EXT_FLASH_READ_SIG))
+    {
+        return CY_HPI_RESPONSE_INVALID_COMMAND;
+    }
+
+    length = (uint16_t)data[2] | ((uint16_t)data[3] << 8);
+    addr   = (uint32_t)data[4] | ((uint32_t)data[5] << 8) | ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+
+    /* flash_read() allows longer spans for the UART transport.*/
+    if (length > HPI_EXT_FLASH_READ_MAX)
+    {
+        return CY_HPI_RESPONSE_INVALID_ARGUMENT;
+    }
+
+    status = flash_read(addr, length, &src);
+    if (status == (int8_t)PMG1_STAT_NOT_READY)
+    {
+        return CY_HPI_RESPONSE_FLASH_UPDATE_FAILED;
+    }
+    if (status != (int8_t)PMG1_STAT_SUCCESS)
+    {
+        return CY_HPI_RESPONSE_INVALID_ARGUMENT;
+    }
+
+    /* Copy the span straight from flash into the flash memory region read by the host.*/
+    Cy_Hpi_UpdateRegs(&glHpiContext, (uint8_t)CY_HPI_REG_SECTION_DEV, HPI_EXT_FLASH_MEM_ADDR,
+                      (uint8_t *)src, (uint8_t)length);
+    return CY_HPI_RESPONSE_FLASH_DATA_AVAILABLE;
 }
 
+/* Handle the flash chunk write command.*/
+static cy_en_hpi_response_t hpi_ext_flash_chunk(uint8_t size, uint8_t *data)
+{
+    uint16_t rowNum;
+    uint16_t offset;
+    pmg1_status_t status;
+
+    if ((size < HPI_EXT_FLASH_CHUNK_HDR_SIZE) || (data[0] != HPI_EXT_FLASH_CHUNK_SIG))
+    {
+        return CY_HPI_RESPONSE_INVALID_COMMAND;
+    }
+    if ((data[1] > HPI_EXT_FLASH_CHUNK_MAX) || (size < (HPI_EXT_FLASH_CHUNK_HDR_SIZE + data[1])))
+    {
+        return CY_HPI_RESPONSE_INVALID_ARGUMENT;
+    }
+
+    rowNum = (uint16_t)data[2] | ((uint16_t)data[3] << 8);
+    offset = (uint16_t)data[4] | ((uint16_t)data[5] << 8);
+
+    status = flash_row_chunk_write(rowNum, offset, &data[HPI_EXT_FLASH_CHUNK_HDR_SIZE], data[1]);
+
+    /* Same refresh as hpi_flash_row_write() for the chunk that programmed the row.*/
+    hpi_update_mem_stats();
+#if PMG1_FLASH_VERIFY_ENABLE
+    hpi_update_flash_verify();
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+
+    switch (status)
+    {
+        case PMG1_STAT_SUCCESS:
+            return CY_HPI_RESPONSE_SUCCESS;
+        case PMG1_STAT_BUSY:
+            return CY_HPI_RESPONSE_BUSY;
+        case PMG1_STAT_NOT_READY:
+        case PMG1_STAT_FAILURE:
+            return CY_HPI_RESPONSE_FLASH_UPDATE_FAILED;
+        default:
+            return CY_HPI_RESPONSE_INVALID_ARGUMENT;
+    }
+}
+
+/* Handle host writes to the HPI extension command registers.*/
+static cy_en_hpi_response_t hpi_ext_write_handler(uint8_t regAddr, uint8_t size, uint8_t *data)
+{
+    switch (regAddr)
+    {
+        case HPI_EXT_REG_FLASH_READ:
+            return hpi_ext_flash_read(size, data);
+        case HPI_EXT_REG_FLASH_CHUNK:
+            return hpi_ext_flash_chunk(size, data);
+        default:
+            return CY_HPI_RESPONSE_INVALID_COMMAND;
+    }
+}
+
+#if (PMG1_BOOT_BG_CHECK_ENABLE && PMG1_BOOT_CHECK_EVENT_ENABLE)
+/* Tell the EC that the background image check is complete.*/
+static void hpi_raise_check_done(void)
+{
+    uint8_t data[HPI_EXT_EVENT_CHECK_DONE_SIZE];
+
+    data[0] = boot_mode_get_reason();
+    data[1] = gl_boot_handoff.slotState;
+    (void)Cy_Hpi_RegEnqueueEvent(&glHpiContext, CY_HPI_REG_SECTION_DEV, HPI_EXT_EVENT_CHECK_DONE,
+                                 sizeof(data), data);
+}
+#endif /* (PMG1_BOOT_BG_CHECK_ENABLE && PMG1_BOOT_CHECK_EVENT_ENABLE) */
+
 /*  Firmware which needs to be validated.*/
 int8_t hpi_boot_validate_fw_cmd(uint8_t fwMode)
 {
     /* This function is used to validate the firmware image.*/
-    fw_metadata_t *fwMetaLoc = NULL;
-    if(fwMode==PMG1_FW_MODE_FWIMAGE_1)
+    pmg1_status_t status = boot_validate_firmware(boot_slot_get_metadata(fwMode));
+
+#if PMG1_AUTH_BOOT_ENABLE
+    /* Authenticate a freshly written image now, so that the next boot only checks the record.*/
+    if (status == PMG1_STAT_SUCCESS)
     {
-        fwMetaLoc = (fw_metadata_t *)PMG1_FW1_METADATA_ADDR;
+        status = boot_auth_check(fwMode);
     }
-    else
+#endif /* PMG1_AUTH_BOOT_ENABLE */
+#if PMG1_BOOT_RECORD_ENABLE
+    /* Let the next boot take this image without reading it.*/
+    if (status == PMG1_STAT_SUCCESS)
     {
-        fwMetaLoc = (fw_metadata_t *)PMG1_FW2_METADATA_ADDR;
+        boot_record_commit(fwMode);
     }
-    return boot_validate_firmware(fwMetaLoc);
+#endif /* PMG1_BOOT_RECORD_ENABLE */
+    return (int8_t)status;
 }
 
 /*  Enable/Disable Flashing Mode.*/
 void hpi_flash_enter_mode(bool isEnable, uint8_t mode, bool dataInPlace)
 {
     /*Handle ENTER_FLASHING_MODE Command.*/
+    /* The flashing session runs at the turbo clock. The command has been received, so no
+     * transfer is in progress, and the SCB dividers follow the clock.*/
+    if (isEnable)
+    {
+        (void)bl_clk_profile(PMG1_CLK_PROFILE_TURBO);
+    }
+#if PMG1_BOOT_BG_CHECK_ENABLE
+    /* Golden slot protection relies on the slot states: complete the image check first.*/
+    if (isEnable)
+    {
+        boot_check_finish();
+    }
+#endif /* PMG1_BOOT_BG_CHECK_ENABLE */
+#if PMG1_AUTH_BOOT_ENABLE
+    /* Any slot that can be written loses its verification record before the first write.*/
+    if (isEnable)
+    {
+        boot_auth_revoke();
+    }
+#endif /* PMG1_AUTH_BOOT_ENABLE */
+#if PMG1_BOOT_RECORD_ENABLE
+    /* The same applies to the boot-decision record.*/
+    if (isEnable)
+    {
+        boot_record_revoke();
+    }
+#endif /* PMG1_BOOT_RECORD_ENABLE */
     flash_enter_mode(isEnable);
+    if (!isEnable)
+    {
+        (void)bl_clk_profile(PMG1_CLK_PROFILE_NOMINAL);
+    }
     (void)mode;
     (void)dataInPlace;
 }
 
-cy_stc_hpi_app_cbk_t hpiAppCbk =
+/* HPI application callbacks. Kept in flash as the table never changes.*/
+const cy_stc_hpi_app_cbk_t hpiAppCbk =
 {
     .ec_intr_write = hpi_ec_intr_write,
     .sys_get_custom_info_addr = NULL,
@@ -294,11 +648,49 @@ cy_stc_hpi_app_cbk_t hpiAppCbk =
 .ucsi_handle_hpi_commands = NULL,
 .hpi_update_ucsi_reg_space = NULL,
 #endif /* ((SROM_CODE_HPISS_HPI == MODULE_IN_ROM) || (CCG_UCSI_ENABLE)) */
-    .hpi_dev_wr_handler_ext = NULL,
+    .hpi_dev_wr_handler_ext = hpi_ext_write_handler,
     .hpi_port_wr_handler_ext = NULL,
 
 };
 
+#if PMG1_UART_TRANSPORT_ENABLE
+/* Boot-loader state reported by the framed command layer.*/
+static void bl_cmd_get_info_cb(bl_cmd_info_t *infoP)
+{
+    infoP->deviceMode = BL_DEVICE_MODE;
+    infoP->bootReason = boot_mode_get_reason();
+    infoP->blLastRow  = flash_get_bl_last_row();
+    infoP->rowSize    = PMG1_FLASH_ROW_SIZE;
+    infoP->readMax    = PMG1_FLASH_READ_MAX_SIZE;
+}
+
+static void bl_cmd_enter_flash_mode_cb(bool enable)
+{
+    hpi_flash_enter_mode(enable, 0, false);
+}
+
+static int8_t bl_cmd_row_write_cb(uint16_t rowNum, uint8_t *data)
+{
+    return hpi_flash_row_write(rowNum, data, NULL);
+}
+
+static void bl_cmd_reset_cb(void)
+{
+    NVIC_SystemReset();
+}
+
+/* The framed commands map to the same functions as the HPI flashing commands.*/
+static const bl_cmd_cbk_t glBlCmdCbk =
+{
+    .get_info         = bl_cmd_get_info_cb,
+    .enter_flash_mode = bl_cmd_enter_flash_mode_cb,
+    .row_write        = bl_cmd_row_write_cb,
+    .read             = flash_read,
+    .validate_fw      = hpi_boot_validate_fw_cmd,
+    .reset            = bl_cmd_reset_cb
+};
+#endif /* PMG1_UART_TRANSPORT_ENABLE */
+
 static void update_hpi_regs (void)
 {
     uint8_t mode, reason;
@@ -307,8 +699,7 @@ static void update_hpi_regs (void)
     fw_metadata_t *fw1Md, *fw2Md;
     uint8_t invalidVer[8] = {0};
 
-    /* HPI Version v2, selected flash row size, selected no. of ports, boot-loader running.*/
-    mode   = 0x80 | (PMG1_FLASH_ROW_SIZE_DEV_MODE_VAL << 4) | ((NO_OF_TYPEC_PORTS - 1) << 2);
+    mode   = BL_DEVICE_MODE;
 
     reason = boot_mode_get_reason ();
 
@@ -316,27 +707,27 @@ static void update_hpi_regs (void)
     Cy_Hpi_SetModeRegs(&glHpiContext, mode, reason);
 
     /* Calculate the firmware1 version and address from the firmware metadata.*/
-    if ((reason & 0x04) != 0)
+    if (!boot_slot_is_valid (PMG1_FW_MODE_FWIMAGE_1))
     {
         fw1Ver = (uint32_t)invalidVer;
         fw1Loc = PMG1_LAST_FLASH_ROW_NUM + 1;
     }
     else
     {
-        fw1Md  = (fw_metadata_t *)PMG1_FW1_METADATA_ADDR;
+        fw1Md  = boot_slot_get_metadata (PMG1_FW_MODE_FWIMAGE_1);
         fw1Ver = (((uint32_t)fw1Md->bootLastRow + 1) << PMG1_FLASH_ROW_SHIFT_NUM) + PMG1_FW_VERSION_OFFSET;
         fw1Loc = fw1Md->bootLastRow + 1;
     }
 
     /* Calculate the firmware2 version and address from the firmware metadata.*/
-    if ((reason & 0x08) != 0)
+    if (!boot_slot_is_valid (PMG1_FW_MODE_FWIMAGE_2))
     {
         fw2Ver = (uint32_t)invalidVer;
         fw2Loc = PMG1_LAST_FLASH_ROW_NUM + 1;
     }
     else
     {
-        fw2Md  = (fw_metadata_t *)PMG1_FW2_METADATA_ADDR;
+        fw2Md  = boot_slot_get_metadata (PMG1_FW_MODE_FWIMAGE_2);
         fw2Ver = (((uint32_t)fw2Md->bootLastRow + 1) << PMG1_FLASH_ROW_SHIFT_NUM) + PMG1_FW_VERSION_OFFSET;
         fw2Loc = fw2Md->bootLastRow + 1;
     }
@@ -355,17 +746,25 @@ static void update_hpi_regs (void)
     Cy_Hpi_UpdateFwLocations(&glHpiContext, fw1Loc, fw2Loc);
     /* Set flash parameters.*/
     Cy_Hpi_SetFlashParams(&glHpiContext, PMG1_FLASH_SIZE, PMG1_FLASH_ROW_SIZE,
-                          PMG1_LAST_FLASH_ROW_NUM + 1, PMG1_BOOT_LOADER_LAST_ROW);
+                          PMG1_LAST_FLASH_ROW_NUM + 1, flash_get_bl_last_row());
 
     /* Update Silicon ID. */
     Cy_Hpi_UpdateRegs(&glHpiContext,
                       (uint8_t)CY_HPI_REG_SECTION_DEV, 0x02,
                       ((uint8_t *) &glPmg1SiliconId) + 2, 0x02);
+
+    /* Update the RAM usage summary.*/
+    hpi_update_mem_stats();
+
+#if PMG1_FLASH_VERIFY_ENABLE
+    /* Rows may have been written before HPI was started.*/
+    hpi_update_flash_verify();
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
 }
 
 static void get_hpi_slave_addr(void)
 {
-    uint8_t slaveAddr = CY_HPI_ADDR_I2C_CFG_FLOAT;
+    uint8_t cfgIdx = 0;
 
     /* Check if IO is driven low.*/
     Cy_GPIO_SetDrivemode(HPI_ADDR_CFG_PORT, HPI_ADDR_CFG_PIN, CY_GPIO_DM_PULLUP);
@@ -373,7 +772,7 @@ static void get_hpi_slave_addr(void)
     Cy_SysLib_DelayUs(5);
     if (Cy_GPIO_Read(HPI_ADDR_CFG_PORT, HPI_ADDR_CFG_PIN) == 0)
     {
-        slaveAddr = CY_HPI_ADDR_I2C_CFG_LOW;
+        cfgIdx = 1;
     }
     else
     {
@@ -383,28 +782,37 @@ static void get_hpi_slave_addr(void)
         Cy_SysLib_DelayUs(5);
         if (Cy_GPIO_Read(HPI_ADDR_CFG_PORT, HPI_ADDR_CFG_PIN) != 0)
         {
-            slaveAddr = CY_HPI_ADDR_I2C_CFG_HIGH;
+            cfgIdx = 2;
         }
     }
     /* Disable the pull up/pull down on IO.*/
     Cy_GPIO_SetDrivemode(HPI_ADDR_CFG_PORT, HPI_ADDR_CFG_PIN, CY_GPIO_DM_HIGHZ);
 
     /* Update the slave address.*/
-    glHpiHwConfig.slaveAddr = slaveAddr;
-    glHpiSlaveAddr = slaveAddr;
+    glHpiHwConfigP = &glHpiHwConfig[cfgIdx];
+    glHpiSlaveAddr = glHpiHwConfigP->slaveAddr;
 }
 
 int main(void)
 {
-    uint32_t wait;
-
-    /* Initialize the device and board peripherals.*/
+    uint32_t wait = 0;
+    uint16_t blLastRow;
+#if PMG1_BOOT_BG_CHECK_ENABLE
+    bool checkBusy = true;
+    bool decided;
+#endif /* PMG1_BOOT_BG_CHECK_ENABLE */
+
+    /* Paint the unused stack so that its high-water mark can be measured.*/
+    mem_stats_paint_stack();
+
+    /* Initialize the system clock. The rest of the hardware is only brought up
+     * if the boot-loader does not start the firmware right away.*/
     pmg1_bsp_init();
 
     /*Enable the systick interrupt. This is used by the soft timer.*/
     NVIC_EnableIRQ(SysTick_IRQn);
 
-    /* Initialize the soft timer module.*/
+    /* Initialize the soft timer module. Also the time base for the boot phase times.*/
     timer_init();
 
     /* Enable global interrupts.*/
@@ -413,27 +821,46 @@ int main(void)
     /* Update the HPI slave address so that it can be passed to application.*/
     get_hpi_slave_addr();
 
-    /* If we have a valid firmware binary, load it.*/
-    if (boot_start () == true)
+    /* Nothing but the CPU and the flash is in use until the peripherals are brought up.*/
+    (void)bl_clk_profile (PMG1_CLK_PROFILE_TURBO);
+
+#if PMG1_BOOT_BG_CHECK_ENABLE
+    /* The images are checked from the main loop once HPI is up. If the image expected to
+     * be booted has no boot-wait window, check up to the boot decision right away instead.*/
+    if (boot_check_begin ())
     {
-        glBootDataSignature = BL_APP_DATA_VALID_SIG;
-        wait = boot_get_wait_time ();
-        if (wait == 0)
+        while (boot_check_get_decision () == BOOT_DECISION_PENDING)
         {
-            boot_jump_to_fw ();
+            (void)boot_check_task (PMG1_BOOT_CHECK_CHUNK_SIZE);
         }
-        else
-        {
-            /* Make sure boot-wait elapsed flag is cleared.*/
-            glBootWaitElapsed = false;
+    }
 
-            /* We need a timer to wait for the boot-wait timeout period.*/
-            timer_start (wait, bl_timer_cb);
-        }
+    if (boot_check_get_decision () == BOOT_DECISION_START)
+#else
+    /* If we have a valid firmware binary with no boot-wait window, load it.*/
+    if (boot_start () == true)
+#endif /* PMG1_BOOT_BG_CHECK_ENABLE */
+    {
+        wait = bl_boot_decided (false);
+    }
+
+    /* Initialize the board peripherals and pins, which are set up for the nominal clock.*/
+    (void)bl_clk_profile (PMG1_CLK_PROFILE_NOMINAL);
+    pmg1_bsp_init_peripherals();
+
+    if (wait != 0)
+    {
+        /* Make sure boot-wait elapsed flag is cleared.*/
+        glBootWaitElapsed = false;
+
+        /* We need a timer to wait for the boot-wait timeout period.*/
+        timer_start (wait, bl_timer_cb);
     }
 
     /* Initialize the HPI interface.*/
-    Cy_Hpi_Init(&glHpiContext, &glHpiHwConfig, &hpiAppCbk, NULL, NULL, 0);
+    /* The HPI middleware only reads the configuration and callback tables.*/
+    Cy_Hpi_Init(&glHpiContext, (cy_stc_hpi_hw_config_t *)glHpiHwConfigP,
+                (cy_stc_hpi_app_cbk_t *)&hpiAppCbk, NULL, NULL, 0);
     Cy_SysInt_Init(&HPI_SCB_IRQ_CONFIG, &hpi_scb_interrupt_IRQHandler);
     NVIC_EnableIRQ((IRQn_Type) HPI_SCB_IRQ_CONFIG.intrSrc);
 
@@ -442,15 +869,27 @@ int main(void)
 
     /* Send a reset complete event to the EC.*/
     Cy_Hpi_RegEnqueueEvent(&glHpiContext, CY_HPI_REG_SECTION_DEV, CY_HPI_EVENT_RESET_COMPLETE, 0, NULL);
+    boot_handoff_mark(BOOT_HANDOFF_PHASE_HPI);
+
+#if PMG1_UART_TRANSPORT_ENABLE
+    /* Flashing commands are accepted on the UART as well.*/
+    bl_cmd_init(&glBlCmdCbk, PMG1_FLASH_ROW_SIZE);
+    bl_uart_init();
+#endif /* PMG1_UART_TRANSPORT_ENABLE */
 
-    /* Set the flash access boundaries so that the boot-loader itself cannot be overwritten.*/
-    flash_set_access_limits (PMG1_BOOT_LOADER_LAST_ROW + 1, PMG1_LAST_FLASH_ROW_NUM,
-                             PMG1_LAST_FLASH_ROW_NUM, PMG1_BOOT_LOADER_LAST_ROW);
+    /* Set the flash access boundaries so that the boot-loader itself cannot be overwritten.
+     * The boot-loader ends at the row holding the end of its linked image.*/
+    blLastRow = flash_get_bl_last_row();
+    flash_set_access_limits (blLastRow + 1, PMG1_LAST_FLASH_ROW_NUM,
+                             PMG1_LAST_FLASH_ROW_NUM, blLastRow);
 
     for (;;)
     {
         /* Handle any pending HPI commands.*/
         Cy_Hpi_Task(&glHpiContext);
+#if PMG1_UART_TRANSPORT_ENABLE
+        (void)bl_cmd_task(&gl_bl_uart_transport);
+#endif /* PMG1_UART_TRANSPORT_ENABLE */
 
         /* If flashing mode is entered, disable the timer and stay in boot-loader mode.*/
         if (flash_access_enabled ())
@@ -459,11 +898,50 @@ int main(void)
             glBootWaitElapsed = false;
         }
 
+#if PMG1_BOOT_BG_CHECK_ENABLE
+        /* Check the next chunk of the images. Once the image to be booted has passed,
+         * open its boot-wait window while the other slots are checked.*/
+        if (checkBusy)
+        {
+            decided   = (boot_check_get_decision () != BOOT_DECISION_PENDING);
+            checkBusy = (boot_check_task (PMG1_BOOT_CHECK_CHUNK_SIZE) == PMG1_STAT_BUSY);
+
+            if ((!decided) && (boot_check_get_decision () == BOOT_DECISION_START))
+            {
+                wait = bl_boot_decided (true);
+                glBootWaitElapsed = false;
+                timer_start (wait, bl_timer_cb);
+            }
+
+            /* All slot states are known now.*/
+            if (!checkBusy)
+            {
+                update_hpi_regs ();
+#if PMG1_BOOT_CHECK_EVENT_ENABLE
+                if (!flash_access_enabled ())
+                {
+                    hpi_raise_check_done ();
+                }
+#endif /* PMG1_BOOT_CHECK_EVENT_ENABLE */
+            }
+        }
+#endif /* PMG1_BOOT_BG_CHECK_ENABLE */
+
         /* Jump to the selected firmware once the boot-wait window has elapsed.*/
         if (glBootWaitElapsed)
         {
-            boot_jump_to_fw();
+            bl_start_fw (true);
+        }
+
+#if SYS_DEEPSLEEP_ENABLE
+        /* Nothing left to do until the next interrupt.*/
+#if PMG1_BOOT_BG_CHECK_ENABLE
+        if (!checkBusy)
+#endif /* PMG1_BOOT_BG_CHECK_ENABLE */
+        {
+            bl_idle ();
         }
+#endif /* SYS_DEEPSLEEP_ENABLE */
     }
 }
 
@@ -0,0 +1,239 @@
+/******************************************************************************
+* File Name: bl_cmd.c
+*
+* Description: This source file implements the framed flashing command layer
+*              used by the byte stream transports. It has no device
+*              dependencies, so that host tools can build it as is.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stddef.h>
+
+#include "bl_cmd.h"
+#include "crc32.h"
+#include "status.h"
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static const bl_cmd_cbk_t *glBlCmdCbk = NULL;
+static uint16_t glBlCmdRowSize = 0;
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+static uint16_t bl_cmd_get_le16 (const uint8_t *p)
+{
+    return ((uint16_t)p[0] | (uint16_t)((uint16_t)p[1] << 8));
+}
+
+static uint32_t bl_cmd_get_le32 (const uint8_t *p)
+{
+    return ((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+static void bl_cmd_put_le32 (uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+/* Map a boot-loader status to the response code.*/
+static uint8_t bl_cmd_status_to_resp (int8_t status, uint8_t failure)
+{
+    switch (status)
+    {
+        case (int8_t)PMG1_STAT_SUCCESS:
+            return BL_RESP_SUCCESS;
+        case (int8_t)PMG1_STAT_BAD_PARAM:
+            return BL_RESP_INVALID_ARGUMENT;
+        case (int8_t)PMG1_STAT_NOT_READY:
+            return BL_RESP_FLASH_UPDATE_FAILED;
+        case (int8_t)PMG1_STAT_BUSY:
+            return BL_RESP_BUSY;
+        default:
+            return failure;
+    }
+}
+
+/* Send a response: header, status, data straight from its location, CRC.*/
+static void bl_cmd_respond (const bl_transport_t *transportP, uint8_t cmd, uint8_t resp,
+                            const uint8_t *data, uint16_t length)
+{
+    uint8_t hdr[BL_FRAME_HDR_SIZE + 1u];
+    uint8_t crcBuf[BL_FRAME_CRC_SIZE];
+    uint16_t payload = (uint16_t)(length + 1u);
+    uint32_t crc;
+
+    hdr[0] = BL_FRAME_SOF;
+    hdr[1] = (uint8_t)(cmd | BL_FRAME_RESP);
+    hdr[2] = (uint8_t)payload;
+    hdr[3] = (uint8_t)(payload >> 8);
+    hdr[4] = resp;
+
+    crc = crc32_update (CRC32_INIT, &hdr[1], sizeof (hdr) - 1u);
+    crc = crc32_update (crc, data, length);
+    bl_cmd_put_le32 (crcBuf, ~crc);
+
+    transportP->send (hdr, sizeof (hdr));
+    if (length != 0u)
+    {
+        transportP->send (data, length);
+    }
+    transportP->send (crcBuf, sizeof (crcBuf));
+}
+
+void bl_cmd_init (const bl_cmd_cbk_t *cbkP, uint16_t rowSize)
+{
+    glBlCmdCbk     = cbkP;
+    glBlCmdRowSize = rowSize;
+}
+
+bool bl_cmd_task (const bl_transport_t *transportP)
+{
+    bl_cmd_info_t info;
+    const uint8_t *data = NULL;
+    uint8_t *frame;
+    uint8_t *payload;
+    uint16_t frameLen;
+    uint16_t length;
+    uint16_t dataLen = 0;
+    uint8_t cmd;
+    uint8_t resp = BL_RESP_INVALID_COMMAND;
+    bool reset = false;
+
+    frame = transportP->receive (&frameLen);
+    if (frame == NULL)
+    {
+        return false;
+    }
+
+    cmd     = frame[1];
+    length  = bl_cmd_get_le16 (&frame[2]);
+    payload = &frame[BL_FRAME_HDR_SIZE];
+
+    /* The transport delivers whole frames: only the CRC is left to check.*/
+    if ((glBlCmdCbk == NULL) || (frameLen != (BL_FRAME_HDR_SIZE + length + BL_FRAME_CRC_SIZE)) ||
+        ((~crc32_update (CRC32_INIT, &frame[1], BL_FRAME_HDR_SIZE - 1u + length)) !=
+         bl_cmd_get_le32 (&payload[length])))
+    {
+        transportP->release ();
+        bl_cmd_respond (transportP, cmd, BL_RESP_TRANSACTION_FAILED, NULL, 0);
+        return true;
+    }
+
+    switch (cmd)
+    {
+        case BL_CMD_GET_INFO:
+            glBlCmdCbk->get_info (&info);
+            data    = (const uint8_t *)&info;
+            dataLen = sizeof (info);
+            resp    = BL_RESP_SUCCESS;
+            break;
+
+        case BL_CMD_ENTER_FLASH_MODE:
+            if (length == 1u)
+            {
+                glBlCmdCbk->enter_flash_mode (payload[0] == (uint8_t)'P');
+                resp = BL_RESP_SUCCESS;
+            }
+            break;
+
+        case BL_CMD_FLASH_WRITE:
+            /* The row is programmed straight from the frame buffer.*/
+            if (length == (BL_CMD_WRITE_HDR_SIZE + glBlCmdRowSize))
+            {
+                resp = bl_cmd_status_to_resp (glBlCmdCbk->row_write (bl_cmd_get_le16 (payload),
+                                                                     &payload[BL_CMD_WRITE_HDR_SIZE]),
+                                              BL_RESP_FLASH_UPDATE_FAILED);
+            }
+            break;
+
+        case BL_CMD_FLASH_READ:
+            if (length == 6u)
+            {
+                dataLen = bl_cmd_get_le16 (&payload[4]);
+                resp = bl_cmd_status_to_resp (glBlCmdCbk->read (bl_cmd_get_le32 (payload), dataLen, &data),
+                                              BL_RESP_INVALID_ARGUMENT);
+                if (resp == BL_RESP_SUCCESS)
+                {
+                    resp = BL_RESP_FLASH_DATA_AVAILABLE;
+                }
+                else
+                {
+                    dataLen = 0;
+                }
+            }
+            break;
+
+        case BL_CMD_VALIDATE_FW:
+            if (length == 1u)
+            {
+                resp = bl_cmd_status_to_resp (glBlCmdCbk->validate_fw (payload[0]), BL_RESP_INVALID_FW);
+            }
+            break;
+
+        case BL_CMD_RESET:
+            resp  = BL_RESP_SUCCESS;
+            reset = true;
+            break;
+
+        default:
+            break;
+    }
+
+    /* Commands that do not fit their payload length fall through as invalid.*/
+    if ((resp == BL_RESP_INVALID_COMMAND) && (cmd <= BL_CMD_RESET))
+    {
+        resp = BL_RESP_INVALID_ARGUMENT;
+    }
+
+    transportP->release ();
+    bl_cmd_respond (transportP, cmd, resp, data, dataLen);
+
+    if (reset)
+    {
+        transportP->flush ();
+        glBlCmdCbk->reset ();
+    }
+
+    return true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,161 @@
+/******************************************************************************
+* File Name: bl_cmd.h
+*
+* Description: This header file defines the framed flashing command layer used
+*              by the byte stream transports (UART) of the boot-loader.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __BL_CMD_H__
+#define __BL_CMD_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+
+/* Frame layout, in both directions. Multi-byte fields are little endian.
+ *   Offset 0: BL_FRAME_SOF
+ *   Offset 1: Command code. Responses carry the command code with BL_FRAME_RESP set.
+ *   Offset 2: Payload length
+ *   Offset 4: Payload
+ *   Then:     CRC-32C over the command code, the length and the payload
+ * The first payload byte of a response is the status, using the HPI response codes.
+ */
+#define BL_FRAME_SOF                        (0xA5u)
+#define BL_FRAME_RESP                       (0x80u)
+#define BL_FRAME_HDR_SIZE                   (4u)
+#define BL_FRAME_CRC_SIZE                   (4u)
+
+/* Payload of BL_CMD_FLASH_WRITE ahead of the row data: row number and two padding bytes
+ * that keep the row data word aligned in a word aligned frame buffer.*/
+#define BL_CMD_WRITE_HDR_SIZE               (4u)
+
+/* Largest command payload for a given flash row size.*/
+#define BL_CMD_MAX_PAYLOAD(rowSize)         (BL_CMD_WRITE_HDR_SIZE + (rowSize))
+
+/* Command codes.*/
+#define BL_CMD_GET_INFO                     (0x00u)     /**< Response: bl_cmd_info_t. */
+#define BL_CMD_ENTER_FLASH_MODE             (0x01u)     /**< 'P' to enter, 0 to leave flashing mode. */
+#define BL_CMD_FLASH_WRITE                  (0x02u)     /**< Row number, padding, row data. */
+#define BL_CMD_FLASH_READ                   (0x03u)     /**< Flash address (4), length (2). Response: data. */
+#define BL_CMD_VALIDATE_FW                  (0x04u)     /**< Slot number. */
+#define BL_CMD_RESET                        (0x05u)     /**< Device reset once the response has been sent. */
+
+/* Status codes: same values as the HPI response codes.*/
+#define BL_RESP_SUCCESS                     (0x02u)
+#define BL_RESP_FLASH_DATA_AVAILABLE        (0x03u)
+#define BL_RESP_INVALID_COMMAND             (0x05u)
+#define BL_RESP_FLASH_UPDATE_FAILED         (0x07u)
+#define BL_RESP_INVALID_FW                  (0x08u)
+#define BL_RESP_INVALID_ARGUMENT            (0x09u)
+#define BL_RESP_TRANSACTION_FAILED          (0x0Cu)
+#define BL_RESP_BUSY                        (0x0Eu)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/**
+ * @typedef bl_cmd_info_t
+ * @brief Response data of BL_CMD_GET_INFO.
+ */
+typedef struct __attribute__((__packed__))
+{
+    uint8_t  deviceMode;                /**< Offset 00: Same value as the HPI DEVICE_MODE register. */
+    uint8_t  bootReason;                /**< Offset 01: Same value as the HPI BOOT_MODE_REASON register. */
+    uint16_t blLastRow;                 /**< Offset 02: Last boot-loader row. */
+    uint16_t rowSize;                   /**< Offset 04: Flash row size in bytes. */
+    uint16_t readMax;                   /**< Offset 06: Largest BL_CMD_FLASH_READ length. */
+} bl_cmd_info_t;
+
+/**
+ * @typedef bl_transport_t
+ * @brief A byte stream transport carrying the command frames.
+ */
+typedef struct
+{
+    /** Return the next complete frame, starting with BL_FRAME_SOF, or NULL. The frame
+     *  stays valid until release() is called. */
+    uint8_t *(*receive)(uint16_t *lengthP);
+
+    /** Allow the next frame to be received. */
+    void (*release)(void);
+
+    /** Send data. Returns once the data has been queued. */
+    void (*send)(const uint8_t *data, uint16_t length);
+
+    /** Return once all data queued by send() is on the line. */
+    void (*flush)(void);
+} bl_transport_t;
+
+/**
+ * @typedef bl_cmd_cbk_t
+ * @brief Boot-loader functions the commands are mapped to. Statuses are pmg1_status_t values.
+ */
+typedef struct
+{
+    void   (*get_info)(bl_cmd_info_t *infoP);
+    void   (*enter_flash_mode)(bool enable);
+    int8_t (*row_write)(uint16_t rowNum, uint8_t *data);
+    int8_t (*read)(uint32_t addr, uint16_t length, const uint8_t **dataP);
+    int8_t (*validate_fw)(uint8_t slot);
+    void   (*reset)(void);
+} bl_cmd_cbk_t;
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+/**
+ * @brief Set up the command layer.
+ * @cbkP Boot-loader functions the commands are mapped to.
+ * @rowSize Flash row size in bytes.
+ */
+void bl_cmd_init (const bl_cmd_cbk_t *cbkP, uint16_t rowSize);
+
+/**
+ * @brief Handle the next complete frame of a transport, if any, and send the response.
+ * @transportP Transport to be served.
+ * @return true if a frame was handled.
+ */
+bool bl_cmd_task (const bl_transport_t *transportP);
+
+#endif /* __BL_CMD_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,145 @@
+/******************************************************************************
+* File Name: bl_services.c
+*
+* Description: This file provides the service table through which applications
+*              call the flash and image check routines of the PMG1 boot-loader.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "config.h"
+#include "cy_utils.h"
+#include "flash.h"
+#include "boot.h"
+#include "boot_handoff.h"
+#include "boot_record.h"
+#include "crc32.h"
+#include "bl_services.h"
+
+#if PMG1_BL_SERVICES_ENABLE
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+/* Check whether a row belongs to the golden image. Unlike boot_slot_row_is_protected(),
+   the image is taken as present from its metadata signature: the boot-time validity
+   flags are kept in boot-loader RAM.*/
+static bool bl_svc_row_is_golden (uint16_t rowNum)
+{
+#if (PMG1_FW_GOLDEN_SLOT != 0)
+    const boot_slot_desc_t *descP = boot_slot_get_desc (PMG1_FW_GOLDEN_SLOT);
+    const fw_metadata_t *mdP = boot_slot_get_metadata (PMG1_FW_GOLDEN_SLOT);
+    uint32_t addr = (uint32_t)rowNum << PMG1_FLASH_ROW_SHIFT_NUM;
+
+    if (mdP->metadataValid != PMG1_FW_METADATA_VALID_SIG)
+    {
+        return false;
+    }
+
+    return ((rowNum == descP->mdRow) ||
+            ((addr + PMG1_FLASH_ROW_SIZE > mdP->appFwStart) && (addr < mdP->appFwStart + mdP->appFwSize)));
+#else
+    (void)rowNum;
+    return false;
+#endif /* (PMG1_FW_GOLDEN_SLOT != 0) */
+}
+
+static int8_t bl_svc_flash_row_write (uint16_t rowNum, const uint8_t *data, uint32_t *workBuf)
+{
+    if (bl_svc_row_is_golden (rowNum))
+    {
+        return (int8_t)PMG1_STAT_BAD_PARAM;
+    }
+
+#if PMG1_BOOT_RECORD_ENABLE
+    /* The record no longer describes a slot whose rows change: drop it, as entering
+       flashing mode does.*/
+    if ((boot_record_covers_row (rowNum)) &&
+        (flash_row_program (PMG1_BOOT_RECORD_SFLASH_ROW, NULL, workBuf, true) != PMG1_STAT_SUCCESS))
+    {
+        return (int8_t)PMG1_STAT_FAILURE;
+    }
+#endif /* PMG1_BOOT_RECORD_ENABLE */
+
+    return (int8_t)flash_row_program (rowNum, data, workBuf, false);
+}
+
+static int8_t bl_svc_validate_firmware (const fw_metadata_t *mdP)
+{
+    return (int8_t)boot_validate_firmware ((fw_metadata_t *)mdP);
+}
+
+static const fw_metadata_t *bl_svc_slot_get_metadata (uint8_t slot)
+{
+    return (boot_slot_get_metadata (slot));
+}
+
+static uint8_t bl_svc_slot_get_state (uint8_t slot)
+{
+    if (!boot_handoff_is_valid (&gl_boot_handoff))
+    {
+        return BOOT_HANDOFF_SLOT_UNCHECKED;
+    }
+
+    return (boot_handoff_get_slot_state (&gl_boot_handoff, slot));
+}
+
+/* Capabilities of this build.*/
+#if PMG1_FW_RWW_LAYOUT
+#define BL_SVC_CAPS                         (BL_SERVICES_CAP_RWW)
+#else
+#define BL_SVC_CAPS                         (0u)
+#endif /* PMG1_FW_RWW_LAYOUT */
+
+/* Service table, placed right after the version block.*/
+CY_SECTION(".cy_bl_services") __USED
+const bl_services_t glBlServices =
+{
+    BL_SERVICES_SIG,
+    BL_SERVICES_VERSION,
+    (uint16_t)sizeof (bl_services_t),
+    bl_svc_flash_row_write,
+    calculate_crc32,
+    crc32_update,
+    bl_svc_validate_firmware,
+    bl_svc_slot_get_metadata,
+    boot_get_next_boot_seq,
+    bl_svc_slot_get_state,
+    BL_SVC_CAPS,
+};
+
+#endif /* PMG1_BL_SERVICES_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,141 @@
+/******************************************************************************
+* File Name: bl_services.h
+*
+* Description: This header file defines the service table through which
+*              applications call the flash and image check routines of the
+*              PMG1 boot-loader.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __BL_SERVICES_H__
+#define __BL_SERVICES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "status.h"
+#include "flash.h"
+#include "boot.h"
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+
+/* Service table signature: "BLSV".*/
+#define BL_SERVICES_SIG                     (0x56534C42u)
+
+/* Table version. Later versions only append entries, so callers check for a version
+ * and size at least as large as the ones they know.*/
+#define BL_SERVICES_VERSION                 (1u)
+
+/* Flash address of the table: right after the version block at offset 0xE0.*/
+#define BL_SERVICES_ADDR                    (0x100u)
+
+/* Service table of the boot-loader, as seen by the application.*/
+#define BL_SERVICES                         ((const bl_services_t *)BL_SERVICES_ADDR)
+
+/* Capability: the read-while-write layout (PMG1_FW_RWW_LAYOUT) is used, so the slot
+ * that the application does not run from lies wholly in the other flash macro.*/
+#define BL_SERVICES_CAP_RWW                 (0x00000001u)
+
+/* Size in words of the work buffer passed to flash_row_write.*/
+#define BL_SERVICES_FLASH_BUF_WORDS         (PMG1_FLASH_PROGRAM_BUF_WORDS)
+
+/*******************************************************************************
+* Data Struct Definition
+*******************************************************************************/
+
+/**
+ * @typedef bl_services_t
+ * @brief Boot-loader routines exported to the application. The services run on the
+ * caller's stack and use no boot-loader RAM, which belongs to the application once it
+ * runs: state is only taken from flash and from the shared handoff block. Status values
+ * are pmg1_status_t, passed as int8_t so that the layout does not depend on the enum
+ * size chosen by the compiler.
+ */
+typedef struct
+{
+    uint32_t sig;                                               /**< Offset 00: BL_SERVICES_SIG. */
+    uint16_t version;                                           /**< Offset 04: BL_SERVICES_VERSION of the boot-loader. */
+    uint16_t size;                                              /**< Offset 06: Size of the table in bytes. */
+
+    /** Offset 08: Program one flash row, or clear it if data is NULL, and read it back.
+        workBuf holds BL_SERVICES_FLASH_BUF_WORDS words. Boot-loader rows and the rows of
+        a golden image cannot be written. Interrupts are disabled while the row is
+        programmed. */
+    int8_t   (*flash_row_write)(uint16_t rowNum, const uint8_t *data, uint32_t *workBuf);
+
+    /** Offset 0C: CRC-32C of a memory range, as stored in the image metadata. */
+    uint32_t (*calculate_crc32)(const uint8_t *address, uint32_t length);
+
+    /** Offset 10: Continue a CRC-32C computation; start from CRC32_INIT and invert the result. */
+    uint32_t (*crc32_update)(uint32_t crc, const uint8_t *address, uint32_t length);
+
+    /** Offset 14: Check an image against its metadata: signature, location, size and CRC. */
+    int8_t   (*validate_firmware)(const fw_metadata_t *mdP);
+
+    /** Offset 18: Metadata of a slot in flash, NULL for an unknown slot. */
+    const fw_metadata_t *(*slot_get_metadata)(uint8_t slot);
+
+    /** Offset 1C: Boot sequence number to be stored in the metadata of a slot written next. */
+    uint32_t (*get_next_boot_seq)(uint8_t slot);
+
+    /** Offset 20: BOOT_HANDOFF_SLOT_XXX state in which the last boot found a slot. */
+    uint8_t  (*slot_get_state)(uint8_t slot);
+
+    /** Offset 24: BL_SERVICES_CAP_XXX flags of the boot-loader build. */
+    uint32_t caps;
+} bl_services_t;
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+/**
+ * @brief Check that the boot-loader provides a service table of the version known to
+ * the caller.
+ * @return true if the BL_SERVICES entries can be called.
+ */
+static inline bool bl_services_available (void)
+{
+    const bl_services_t *svcP = BL_SERVICES;
+
+    return ((svcP->sig == BL_SERVICES_SIG) && (svcP->version >= BL_SERVICES_VERSION) &&
+            (svcP->size >= sizeof (bl_services_t)));
+}
+
+#endif /* __BL_SERVICES_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,188 @@
+/******************************************************************************
+* File Name: bl_uart.c
+*
+* Description: This source file implements the SCB UART transport of the framed
+*              flashing command layer. Frames are collected by the RX interrupt
+*              and handed to the command layer from the main loop.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cycfg.h"
+#include "config.h"
+#include "flash.h"
+#include "bl_uart.h"
+
+#if PMG1_UART_TRANSPORT_ENABLE
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+/* Largest frame: a flash write command carrying one row.*/
+#define BL_UART_FRAME_MAX       (BL_FRAME_HDR_SIZE + BL_CMD_MAX_PAYLOAD (PMG1_FLASH_ROW_SIZE) + BL_FRAME_CRC_SIZE)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Frame buffer. Word aligned, so that the row data of a flash write is word aligned too.*/
+static uint32_t glBlUartFrame[(BL_UART_FRAME_MAX + 3u) / 4u];
+
+/* Bytes received into the frame buffer, and the full frame size once the header is in.*/
+static volatile uint16_t glBlUartCount = 0;
+static volatile uint16_t glBlUartExpected = 0;
+
+/* A complete frame waits for the command layer. Bytes received meanwhile are dropped.*/
+static volatile bool glBlUartReady = false;
+
+static const cy_stc_sysint_t glBlUartIrqConfig = {
+    .intrSrc = (IRQn_Type) BL_UART_IRQ,
+    .intrPriority = 3u
+};
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+/* Collect frame bytes. A byte that does not start a frame, or a header with an
+   oversized length, drops the frame so that the receiver finds the next one.*/
+static void bl_uart_rx_byte (uint8_t byte)
+{
+    uint8_t *frame = (uint8_t *)glBlUartFrame;
+    uint16_t length;
+
+    if (glBlUartReady)
+    {
+        return;
+    }
+
+    if ((glBlUartCount == 0u) && (byte != BL_FRAME_SOF))
+    {
+        return;
+    }
+
+    frame[glBlUartCount++] = byte;
+    if (glBlUartCount == BL_FRAME_HDR_SIZE)
+    {
+        length = (uint16_t)frame[2] | (uint16_t)((uint16_t)frame[3] << 8);
+        if (length > BL_CMD_MAX_PAYLOAD (PMG1_FLASH_ROW_SIZE))
+        {
+            glBlUartCount = 0;
+            return;
+        }
+        glBlUartExpected = (uint16_t)(BL_FRAME_HDR_SIZE + length + BL_FRAME_CRC_SIZE);
+    }
+
+    if ((glBlUartCount > BL_FRAME_HDR_SIZE) && (glBlUartCount == glBlUartExpected))
+    {
+        glBlUartReady = true;
+    }
+}
+
+static void bl_uart_interrupt_IRQHandler (void)
+{
+    while (Cy_SCB_UART_GetNumInRxFifo (BL_UART_HW) != 0u)
+    {
+        bl_uart_rx_byte ((uint8_t)Cy_SCB_UART_Get (BL_UART_HW));
+    }
+
+    /* An overflow loses bytes: the frame CRC catches it.*/
+    Cy_SCB_ClearRxInterrupt (BL_UART_HW, CY_SCB_RX_INTR_NOT_EMPTY | CY_SCB_RX_INTR_OVERFLOW);
+}
+
+static uint8_t *bl_uart_receive (uint16_t *lengthP)
+{
+    if (!glBlUartReady)
+    {
+        return NULL;
+    }
+
+    *lengthP = glBlUartCount;
+    return ((uint8_t *)glBlUartFrame);
+}
+
+static void bl_uart_release (void)
+{
+    glBlUartCount    = 0;
+    glBlUartExpected = 0;
+    glBlUartReady    = false;
+}
+
+static void bl_uart_send (const uint8_t *data, uint16_t length)
+{
+    Cy_SCB_UART_PutArrayBlocking (BL_UART_HW, (void *)data, length);
+}
+
+static void bl_uart_flush (void)
+{
+    while (!Cy_SCB_UART_IsTxComplete (BL_UART_HW))
+    {
+    }
+}
+
+const bl_transport_t gl_bl_uart_transport =
+{
+    .receive = bl_uart_receive,
+    .release = bl_uart_release,
+    .send    = bl_uart_send,
+    .flush   = bl_uart_flush
+};
+
+void bl_uart_init (void)
+{
+    /* The low level API is used: no driver context is needed.*/
+    (void)Cy_SCB_UART_Init (BL_UART_HW, &BL_UART_config, NULL);
+    Cy_SCB_SetRxInterruptMask (BL_UART_HW, CY_SCB_RX_INTR_NOT_EMPTY | CY_SCB_RX_INTR_OVERFLOW);
+    Cy_SCB_UART_Enable (BL_UART_HW);
+
+    bl_uart_release ();
+    Cy_SysInt_Init (&glBlUartIrqConfig, &bl_uart_interrupt_IRQHandler);
+    NVIC_EnableIRQ (glBlUartIrqConfig.intrSrc);
+}
+
+void bl_uart_deinit (void)
+{
+    NVIC_DisableIRQ (glBlUartIrqConfig.intrSrc);
+    Cy_SCB_UART_DeInit (BL_UART_HW);
+
+    Cy_GPIO_SetDrivemode (BL_UART_RX_PORT, BL_UART_RX_PIN, CY_GPIO_DM_ANALOG);
+    Cy_GPIO_SetHSIOM (BL_UART_RX_PORT, BL_UART_RX_PIN, HSIOM_SEL_GPIO);
+    Cy_GPIO_SetDrivemode (BL_UART_TX_PORT, BL_UART_TX_PIN, CY_GPIO_DM_ANALOG);
+    Cy_GPIO_SetHSIOM (BL_UART_TX_PORT, BL_UART_TX_PIN, HSIOM_SEL_GPIO);
+}
+
+#endif /* PMG1_UART_TRANSPORT_ENABLE */
+
+/* [] END OF FILE */
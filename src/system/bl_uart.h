@@ -0,0 +1,71 @@
+/******************************************************************************
+* File Name: bl_uart.h
+*
+* Description: This header file defines the SCB UART transport of the framed
+*              flashing command layer.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __BL_UART_H__
+#define __BL_UART_H__
+
+#include "bl_cmd.h"
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+
+/* UART transport, served by bl_cmd_task().*/
+extern const bl_transport_t gl_bl_uart_transport;
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+/**
+ * @brief Set up the SCB configured as BL_UART in the device configurator and start
+ * receiving frames. The peripherals and pins must have been initialized.
+ */
+void bl_uart_init (void);
+
+/**
+ * @brief Stop the UART and return its pins to their reset state.
+ */
+void bl_uart_deinit (void);
+
+#endif /* __BL_UART_H__ */
+
+/* [] END OF FILE */
@@ -43,12 +43,11 @@
 #include "config.h"
 #include "flash.h"
 #include "boot.h"
-
-/* A number of uint32_t elements in the CRC32 table.*/
-#define CRC_TABLE_SIZE                      (16U)
-#define CRC_INIT                            (0xFFFFFFFFU)
-#define NIBBLE_POS                          (4U)
-#define NIBBLE_MSK                          (0xFU)
+#include "boot_auth.h"
+#include "boot_handoff.h"
+#include "boot_record.h"
+#include "crc32.h"
+#include "timer.h"
 
 extern volatile uint32_t cyBtldrRunType;
 
@@ -59,6 +58,19 @@ CY_SECTION(".cy_boot_img_status") __USED
 #endif /* defined(__ARMCC_VERSION) */
 volatile fw_img_status_t gl_img_status;
 
+#if PMG1_TRIAL_BOOT_ENABLE
+#if defined(__ARMCC_VERSION)
+CY_SECTION(".bss.cy_boot_trial") __USED
+#else
+CY_SECTION(".cy_boot_trial") __USED
+#endif /* defined(__ARMCC_VERSION) */
+volatile boot_trial_t gl_boot_trial;
+#endif /* PMG1_TRIAL_BOOT_ENABLE */
+
+/* Boot results passed to the application.*/
+BOOT_HANDOFF_SECTION
+volatile boot_handoff_t gl_boot_handoff;
+
 /* Variable representing the current firmware mode.*/
 pmg1_fw_mode_t glActiveFw = PMG1_FW_MODE_INVALID;
 
@@ -66,35 +78,110 @@ pmg1_fw_mode_t glActiveFw = PMG1_FW_MODE_INVALID;
 
 /* Boot-wait duration specified by firmware metadata.*/
 static volatile uint16_t glBootWaitDelay = PMG1_BL_WAIT_DEFAULT;
+
+/* Budget which checks all remaining slots in one boot_check_task() call.*/
+#define BOOT_CHECK_ALL                      (0xFFFFFFFFu)
+
+/* Image check state. Slots are checked in the order in which they would be booted,
+   so that the boot decision is made as soon as the first valid image is found.*/
+typedef struct
+{
+    uint32_t crc;                               /* Running CRC of the image being checked. */
+    uint32_t offset;                            /* Image bytes checked so far. */
+    uint8_t  order[PMG1_FW_SLOT_COUNT];         /* Slots in boot order. */
+    uint8_t  count;                             /* Number of slots to be checked. */
+    uint8_t  idx;                               /* Position of the slot being checked in order[]. */
+    uint8_t  rqtSlot;                           /* Slot requested by the firmware, if any. */
+    uint8_t  decision;                          /* boot_decision_t. */
+    uint8_t  prevStatus;                        /* Invalid flags of the other slots on a slot request. */
+    uint8_t  trialSlot;                         /* Slot out of trial attempts, decided once all slots are checked. */
+} boot_check_t;
+
+static boot_check_t glBootCheck;
 #endif /* PMG1_BOOTLOAD_ENABLE */
 
 /* Pointer to function that is used to jump into address.*/
 typedef void (*cy_fn_jump_ptr_t)(void);
 
-uint32_t calculate_crc32(const uint8_t *address, uint32_t length)
+/* Slot flags derived from the golden slot selection.*/
+#define BOOT_SLOT_FLAGS(n)                  (((n) == PMG1_FW_GOLDEN_SLOT) ? PMG1_FW_SLOT_FLAG_GOLDEN : 0u)
+
+/* Firmware slot descriptors, indexed by slot number - 1.*/
+static const boot_slot_desc_t glBootSlots[PMG1_FW_SLOT_COUNT] =
+{
+    {PMG1_FW_METADATA_ROW(1), BOOT_SLOT_FLAGS(1), 0u},
+    {PMG1_FW_METADATA_ROW(2), BOOT_SLOT_FLAGS(2), 0u},
+#if (PMG1_FW_SLOT_COUNT > 2)
+    {PMG1_FW_METADATA_ROW(3), BOOT_SLOT_FLAGS(3), 0u},
+#endif /* (PMG1_FW_SLOT_COUNT > 2) */
+#if (PMG1_FW_SLOT_COUNT > 3)
+    {PMG1_FW_METADATA_ROW(4), BOOT_SLOT_FLAGS(4), 0u},
+#endif /* (PMG1_FW_SLOT_COUNT > 3) */
+};
+
+/* Order in which the slots are considered for boot.*/
+static const uint8_t glBootSlotOrder[PMG1_FW_SLOT_COUNT] = PMG1_FW_SLOT_FALLBACK_ORDER;
+
+/* Get the descriptor of a firmware slot.*/
+const boot_slot_desc_t *boot_slot_get_desc (uint8_t slot)
 {
-    /* Contains generated values to calculate CRC-32C by 4 bits per iteration.
-    CRC-32C is computed based on the polynomial (0x1EDC6F41).*/
-    static const uint32_t crcTable[CRC_TABLE_SIZE] =
+    if ((slot < (uint8_t)PMG1_FW_MODE_FWIMAGE_1) || (slot > PMG1_FW_SLOT_COUNT))
     {
-        0x00000000U, 0x105ec76fU, 0x20bd8edeU, 0x30e349b1U,
-        0x417b1dbcU, 0x5125dad3U, 0x61c69362U, 0x7198540dU,
-        0x82f63b78U, 0x92a8fc17U, 0xa24bb5a6U, 0xb21572c9U,
-        0xc38d26c4U, 0xd3d3e1abU, 0xe330a81aU, 0xf36e6f75U,
-    };
-    uint32_t crc = CRC_INIT;
-    if (length != 0U)
+        return NULL;
+    }
+
+    return (&glBootSlots[slot - 1u]);
+}
+
+/* Get the metadata of a firmware slot.*/
+fw_metadata_t *boot_slot_get_metadata (uint8_t slot)
+{
+    const boot_slot_desc_t *descP = boot_slot_get_desc (slot);
+
+    if (descP == NULL)
     {
-        do
+        return NULL;
+    }
+
+    return ((fw_metadata_t *)((((uint32_t)descP->mdRow + 1u) << PMG1_FLASH_ROW_SHIFT_NUM) - PMG1_FW_METADATA_SIZE));
+}
+
+/* Get the slot whose metadata is stored in the given flash row.*/
+uint8_t boot_slot_from_md_row (uint16_t rowNum)
+{
+    uint8_t slot;
+
+    BOOT_SLOT_FOREACH (slot)
+    {
+        if (glBootSlots[slot - 1u].mdRow == rowNum)
         {
-            crc = crc ^ *address;
-            crc = (crc >> NIBBLE_POS) ^ crcTable[crc & NIBBLE_MSK];
-            crc = (crc >> NIBBLE_POS) ^ crcTable[crc & NIBBLE_MSK];
-            --length;
-            ++address;
-        } while (length != 0U);
-    }
-    return (~crc);
+            return slot;
+        }
+    }
+
+    return ((uint8_t)PMG1_FW_MODE_INVALID);
+}
+
+/* Get the slot at a given position of the fallback order.*/
+uint8_t boot_slot_get_fallback (uint8_t index)
+{
+    if (index >= PMG1_FW_SLOT_COUNT)
+    {
+        return ((uint8_t)PMG1_FW_MODE_INVALID);
+    }
+
+    return (glBootSlotOrder[index]);
+}
+
+/* Check whether a slot was found valid during boot.*/
+bool boot_slot_is_valid (uint8_t slot)
+{
+    if (boot_slot_get_desc (slot) == NULL)
+    {
+        return false;
+    }
+
+    return ((gl_img_status.val & PMG1_FW_INVALID_MASK (slot)) == 0u);
 }
 
 /* Return the boot-wait setting to the user code.*/
@@ -103,38 +190,41 @@ uint16_t boot_get_wait_time (void)
     return (glBootWaitDelay);
 }
 
+/* Check the metadata fields describing the image: signature, location and size.
+   In the read-while-write layout, the image has to lie in the macro of its metadata row.*/
+static bool boot_metadata_is_sane (const fw_metadata_t *mdP)
+{
+#if PMG1_FW_RWW_LAYOUT
+    uint32_t mdMacro = PMG1_FLASH_MACRO_FROM_ROW ((uint32_t)mdP >> PMG1_FLASH_ROW_SHIFT_NUM);
+
+    if ((mdP->appFwSize == 0) ||
+        (PMG1_FLASH_MACRO_FROM_ROW (mdP->appFwStart >> PMG1_FLASH_ROW_SHIFT_NUM) != mdMacro) ||
+        (PMG1_FLASH_MACRO_FROM_ROW ((mdP->appFwStart + mdP->appFwSize - 1u) >> PMG1_FLASH_ROW_SHIFT_NUM) != mdMacro))
+    {
+        return false;
+    }
+#endif /* PMG1_FW_RWW_LAYOUT */
+
+    return ((mdP->metadataValid == PMG1_FW_METADATA_VALID_SIG) &&
+            ((mdP->appFwStart + mdP->appFwSize) < PMG1_FLASH_SIZE) &&
+            (mdP->appFwSize != 0));
+}
+
 /* Validate a firmware binary.*/
 pmg1_status_t boot_validate_firmware (fw_metadata_t *mdP)
 {
-    if(mdP==NULL)
+    /* Validate:
+       1) FW signature
+       2) FW entry and size
+       3) FW checksum
+     */
+    if ((mdP == NULL) || (!boot_metadata_is_sane (mdP)) ||
+        (mdP->fwCrc32 != calculate_crc32((uint8_t *)mdP->appFwStart, mdP->appFwSize)))
     {
         return PMG1_STAT_FAILURE;
     }
-    else
-    {
-        pmg1_status_t      status = PMG1_STAT_SUCCESS;
-        uint32_t          *appFwStart;
-        uint32_t          appFwSize;
-
-        appFwStart = (uint32_t *)mdP->appFwStart;
-        appFwSize  = mdP->appFwSize;
-
-        /* Validate:
-           1) FW signature
-           2) FW entry and size
-           3) FW checksum
-         */
-        if (
-            (mdP->metadataValid != PMG1_FW_METADATA_VALID_SIG)
-            ||(((uint32_t)appFwStart + appFwSize) >= PMG1_FLASH_SIZE)
-            ||(appFwSize == 0)
-            ||(mdP->fwCrc32 != calculate_crc32((uint8_t *)appFwStart, appFwSize))
-           )
-        {
-            status = PMG1_STAT_FAILURE;
-        }
-        return status;
-    }
+
+    return PMG1_STAT_SUCCESS;
 }
 
 #if PMG1_BOOTLOAD_ENABLE
@@ -155,26 +245,310 @@ static void boot_set_wait_timeout (fw_metadata_t *mdP)
     }
 }
 
-bool boot_start (void)
+/* Pick the slot to be booted from the valid slots.*/
+static uint8_t boot_select_slot (uint8_t rqtSlot)
 {
-    fw_metadata_t *md1P=NULL;
-    fw_metadata_t *md2P=NULL;
-    fw_metadata_t *mdP=NULL;
-    pmg1_fw_mode_t activeFw;
-    bool    bootFw1 = false;
-    bool    bootFw2 = false;
+    fw_metadata_t *mdP;
+    uint32_t bestSeq = 0;
+    uint8_t  bestSlot = (uint8_t)PMG1_FW_MODE_INVALID;
+    uint8_t  slot;
+    uint8_t  idx;
 
-    /* Clear the reason for boot mode. */
-    gl_img_status.val = 0;
+    /* If we have been asked to boot a specific slot and it is valid, do that.*/
+    if (boot_slot_is_valid (rqtSlot))
+    {
+        return rqtSlot;
+    }
+
+    /* Otherwise, choose the non-golden slot with the greatest sequence number.
+       Walking the slots in fallback order ensures that ties go to the slot listed first.
+     */
+    for (idx = 0; idx < PMG1_FW_SLOT_COUNT; idx++)
+    {
+        slot = glBootSlotOrder[idx];
+        if ((boot_slot_is_valid (slot)) &&
+            ((glBootSlots[slot - 1u].flags & PMG1_FW_SLOT_FLAG_GOLDEN) == 0u))
+        {
+            mdP = boot_slot_get_metadata (slot);
+            if ((bestSlot == (uint8_t)PMG1_FW_MODE_INVALID) || (mdP->bootSeq > bestSeq))
+            {
+                bestSlot = slot;
+                bestSeq  = mdP->bootSeq;
+            }
+        }
+    }
+
+    /* Fall back to the first valid slot in the list, which can only be a golden slot here.*/
+    for (idx = 0; (idx < PMG1_FW_SLOT_COUNT) && (bestSlot == (uint8_t)PMG1_FW_MODE_INVALID); idx++)
+    {
+        if (boot_slot_is_valid (glBootSlotOrder[idx]))
+        {
+            bestSlot = glBootSlotOrder[idx];
+        }
+    }
+
+    return bestSlot;
+}
+
+#if PMG1_TRIAL_BOOT_ENABLE
+/* Apply the trial boot rules to the selected slot, updating *slotP. Returns false if the
+   slot is out of trial attempts while other slots are still to be checked: the decision
+   then has to wait until they have been.*/
+static bool boot_trial_select (uint8_t *slotP)
+{
+    fw_metadata_t *mdP;
+    uint8_t slot = *slotP;
+    uint8_t next;
+
+    while (slot != (uint8_t)PMG1_FW_MODE_INVALID)
+    {
+        mdP = boot_slot_get_metadata (slot);
+
+        /* Confirmed and golden images are booted without a trial.*/
+        if ((mdP->bootConfirm == PMG1_FW_CONFIRM_SIG) ||
+            ((glBootSlots[slot - 1u].flags & PMG1_FW_SLOT_FLAG_GOLDEN) != 0u))
+        {
+            gl_boot_trial.sig = 0;
+            break;
+        }
+
+        /* Start counting for an image that was not on trial before.*/
+        if ((gl_boot_trial.sig != PMG1_BOOT_TRIAL_SIG) || (gl_boot_trial.slot != slot) ||
+            (gl_boot_trial.bootSeq != mdP->bootSeq))
+        {
+            gl_boot_trial.sig      = PMG1_BOOT_TRIAL_SIG;
+            gl_boot_trial.bootSeq  = mdP->bootSeq;
+            gl_boot_trial.slot     = slot;
+            gl_boot_trial.attempts = 0;
+        }
+
+        if (gl_boot_trial.attempts < PMG1_TRIAL_BOOT_ATTEMPTS)
+        {
+            gl_boot_trial.attempts++;
+            break;
+        }
+
+        /* Out of attempts: go back to the best of the other slots, which all need to have
+           been checked first. If there is none, keep starting this image.*/
+        if (glBootCheck.idx < glBootCheck.count)
+        {
+            *slotP = slot;
+            return false;
+        }
+        gl_img_status.val |= PMG1_FW_INVALID_MASK (slot);
+        next = boot_select_slot ((uint8_t)PMG1_FW_MODE_INVALID);
+        if (next == (uint8_t)PMG1_FW_MODE_INVALID)
+        {
+            gl_img_status.val &= ~PMG1_FW_INVALID_MASK (slot);
+            break;
+        }
+
+        /* Make the revert permanent by dropping the metadata signature of the image.*/
+        (void)flash_row_patch (glBootSlots[slot - 1u].mdRow,
+                               PMG1_FLASH_ROW_SIZE - PMG1_FW_METADATA_SIZE + PMG1_FW_METADATA_VALID_OFFSET,
+                               NULL, sizeof (mdP->metadataValid));
+        gl_img_status.status.trialRevert = 1;
+        gl_boot_trial.sig = 0;
+        slot = next;
+    }
+
+    *slotP = slot;
+    return true;
+}
+#endif /* PMG1_TRIAL_BOOT_ENABLE */
+
+/* Record the check result of a slot in the handoff block.*/
+static void boot_handoff_set_slot (uint8_t slot, uint8_t state, uint32_t crc)
+{
+    uint8_t shift = (uint8_t)((slot - 1u) * BOOT_HANDOFF_SLOT_STATE_BITS);
+
+    gl_boot_handoff.slotState = (uint8_t)((gl_boot_handoff.slotState & ~(BOOT_HANDOFF_SLOT_STATE_MASK << shift)) |
+                                          (state << shift));
+    gl_boot_handoff.slotCrc[slot - 1u] = crc;
+    gl_boot_handoff.slotSeq[slot - 1u] = boot_slot_get_metadata (slot)->bootSeq;
+}
+
+void boot_handoff_mark (uint8_t phase)
+{
+    gl_boot_handoff.phaseUs[phase] = timer_get_time_us ();
+}
+
+void boot_handoff_publish (uint8_t hpiSlaveAddr)
+{
+    boot_handoff_mark (BOOT_HANDOFF_PHASE_START);
+
+    gl_boot_handoff.version      = BOOT_HANDOFF_VERSION;
+    gl_boot_handoff.size         = sizeof (boot_handoff_t);
+    gl_boot_handoff.activeSlot   = (uint8_t)glActiveFw;
+    gl_boot_handoff.imgStatus    = gl_img_status.val;
+    gl_boot_handoff.hpiSlaveAddr = hpiSlaveAddr;
+    gl_boot_handoff.crc          = boot_handoff_calc_crc (&gl_boot_handoff);
+    gl_boot_handoff.sig          = BOOT_HANDOFF_SIG;
+}
+
+/* Make the boot decision once the first valid slot in boot order is known.*/
+static void boot_decide (uint8_t slot)
+{
+    boot_handoff_mark (BOOT_HANDOFF_PHASE_DECISION);
+    glBootCheck.decision = (uint8_t)BOOT_DECISION_STAY;
+
+    /* Firmware has asked to stay in boot mode: only the slot states are needed.*/
+    if (gl_img_status.status.bootModeRequest != 0u)
+    {
+        return;
+    }
+
+#if PMG1_BOOT_DIRECT_HANDOFF
+    /* A jump to a specific slot only needs that slot to be checked. The other slots keep
+       the state found by the boot which started the running application.*/
+    if ((slot != (uint8_t)PMG1_FW_MODE_INVALID) && (slot == glBootCheck.rqtSlot))
+    {
+        gl_img_status.val = glBootCheck.prevStatus;
+        glBootCheck.idx   = glBootCheck.count;
+    }
+#endif /* PMG1_BOOT_DIRECT_HANDOFF */
+
+#if PMG1_TRIAL_BOOT_ENABLE
+    if (!boot_trial_select (&slot))
+    {
+        /* boot_check_task() decides again once the remaining slots have been checked.*/
+        glBootCheck.decision  = (uint8_t)BOOT_DECISION_PENDING;
+        glBootCheck.trialSlot = slot;
+        return;
+    }
+#endif /* PMG1_TRIAL_BOOT_ENABLE */
+    if (slot != (uint8_t)PMG1_FW_MODE_INVALID)
+    {
+        /* If we are in the middle of a jump-to-alt-fw command, do not provide the boot wait window.*/
+        if (glBootCheck.rqtSlot != (uint8_t)PMG1_FW_MODE_INVALID)
+            glBootWaitDelay = PMG1_BL_WAIT_NO_DELAY;
+        else
+            boot_set_wait_timeout (boot_slot_get_metadata (slot));
+
+        glActiveFw = (pmg1_fw_mode_t)slot;
+        glBootCheck.decision = (uint8_t)BOOT_DECISION_START;
+    }
+}
+
+/* Sort the slots in the order in which boot_select_slot() would choose them.*/
+static void boot_check_order (uint8_t rqtSlot)
+{
+    uint8_t first = 0;
+    uint8_t count;
+    uint8_t slot;
+    uint8_t pos;
+    uint8_t idx;
+    uint32_t seq;
+
+    if (boot_slot_get_desc (rqtSlot) != NULL)
+    {
+        glBootCheck.order[first++] = rqtSlot;
+    }
+    count = first;
+
+    /* Non-golden slots by descending boot sequence. Equal numbers keep the fallback order.*/
+    for (idx = 0; idx < PMG1_FW_SLOT_COUNT; idx++)
+    {
+        slot = glBootSlotOrder[idx];
+        if ((slot != rqtSlot) && ((glBootSlots[slot - 1u].flags & PMG1_FW_SLOT_FLAG_GOLDEN) == 0u))
+        {
+            seq = boot_slot_get_metadata (slot)->bootSeq;
+            for (pos = count; (pos > first) && (boot_slot_get_metadata (glBootCheck.order[pos - 1u])->bootSeq < seq); pos--)
+            {
+                glBootCheck.order[pos] = glBootCheck.order[pos - 1u];
+            }
+            glBootCheck.order[pos] = slot;
+            count++;
+        }
+    }
 
-    /* Check the two firmware binaries for validity.*/
-    if (boot_validate_firmware ((fw_metadata_t *)PMG1_FW1_METADATA_ADDR) != PMG1_STAT_SUCCESS)
+    /* Golden slots go last.*/
+    for (idx = 0; idx < PMG1_FW_SLOT_COUNT; idx++)
     {
-        gl_img_status.status.fw1Invalid  = PMG1_FW_INVALID;
+        slot = glBootSlotOrder[idx];
+        if ((slot != rqtSlot) && ((glBootSlots[slot - 1u].flags & PMG1_FW_SLOT_FLAG_GOLDEN) != 0u))
+        {
+            glBootCheck.order[count++] = slot;
+        }
     }
-    if (boot_validate_firmware ((fw_metadata_t *)PMG1_FW2_METADATA_ADDR) != PMG1_STAT_SUCCESS)
+
+    glBootCheck.count = count;
+}
+
+/* Complete the check of the current slot and move on to the next one.*/
+static void boot_check_next (pmg1_status_t status)
+{
+    uint8_t slot = glBootCheck.order[glBootCheck.idx];
+
+#if PMG1_AUTH_BOOT_ENABLE
+    /* Intact images must also be authentic. This normally takes the verification record only.*/
+    if (status == PMG1_STAT_SUCCESS)
+    {
+        status = boot_auth_check (slot);
+    }
+#endif /* PMG1_AUTH_BOOT_ENABLE */
+
+    if (status == PMG1_STAT_SUCCESS)
+    {
+        gl_img_status.val &= (uint8_t)~PMG1_FW_INVALID_MASK (slot);
+    }
+
+    boot_handoff_set_slot (slot, (status == PMG1_STAT_SUCCESS) ? BOOT_HANDOFF_SLOT_VALID : BOOT_HANDOFF_SLOT_INVALID,
+                           ~glBootCheck.crc);
+
+    glBootCheck.idx++;
+    glBootCheck.offset = 0;
+    glBootCheck.crc    = CRC32_INIT;
+
+    /* The first valid slot in boot order is the one to be booted.*/
+    if ((status == PMG1_STAT_SUCCESS) && (glBootCheck.decision == (uint8_t)BOOT_DECISION_PENDING) &&
+        (glBootCheck.trialSlot == (uint8_t)PMG1_FW_MODE_INVALID))
+    {
+        boot_decide (slot);
+    }
+}
+
+bool boot_check_begin (void)
+{
+    volatile uint32_t *hoP = (volatile uint32_t *)&gl_boot_handoff;
+    fw_metadata_t *mdP;
+    uint8_t slot;
+    uint8_t idx;
+
+    /* Start a new handoff block. It stays unpublished until the firmware is started.*/
+    for (idx = 0; idx < (sizeof (boot_handoff_t) / sizeof (uint32_t)); idx++)
+    {
+        hoP[idx] = 0;
+    }
+    gl_boot_handoff.resetReason = Cy_SysLib_GetResetReason ();
+    boot_handoff_mark (BOOT_HANDOFF_PHASE_CHECK);
+
+    glBootCheck.rqtSlot    = (uint8_t)PMG1_FW_MODE_INVALID;
+    glBootCheck.decision   = (uint8_t)BOOT_DECISION_PENDING;
+    glBootCheck.idx        = 0;
+    glBootCheck.offset     = 0;
+    glBootCheck.crc        = CRC32_INIT;
+    glBootCheck.prevStatus = 0;
+    glBootCheck.trialSlot  = (uint8_t)PMG1_FW_MODE_INVALID;
+
+    /* Check if we have been asked to boot a specific slot.*/
+    BOOT_SLOT_FOREACH (slot)
+    {
+        if ((cyBtldrRunType & 0xFFFF) == PMG1_FW_BOOT_RQT_SIG (slot))
+        {
+            glBootCheck.rqtSlot = slot;
+        }
+        else
+        {
+            glBootCheck.prevStatus |= (uint8_t)(gl_img_status.val & PMG1_FW_INVALID_MASK (slot));
+        }
+    }
+
+    /* Clear the reason for boot mode. Slots are reported invalid until they have been checked.*/
+    gl_img_status.val = 0;
+    BOOT_SLOT_FOREACH (slot)
     {
-        gl_img_status.status.fw2Invalid = PMG1_FW_INVALID;
+        gl_img_status.val |= (uint8_t)PMG1_FW_INVALID_MASK (slot);
     }
 
     /* Check for the boot mode request.*/
@@ -183,76 +557,135 @@ bool boot_start (void)
      * for signature. */
     if ((cyBtldrRunType & 0xFFFF) == PMG1_BOOT_MODE_RQT_SIG)
     {
-        /* FW has made a request to stay in boot mode. Return
-         * from here after clearing the variable.*/
+        /* FW has made a request to stay in boot mode. Clear the variable.*/
         cyBtldrRunType = PMG1_BOOT_TYPE_STAY_IN_BOOT;
         /* Set the reason for boot mode.*/
         gl_img_status.status.bootModeRequest = 1;
-        return false;
     }
 
-    /* Check if we have been asked to boot FW1 or FW2 specifically.*/
-    if ((cyBtldrRunType & 0xFFFF) == PMG1_FW1_BOOT_RQT_SIG)
+    boot_check_order (glBootCheck.rqtSlot);
+
+    /* Tell the caller whether the image most likely to be booted starts without a boot-wait window.*/
+    if ((gl_img_status.status.bootModeRequest != 0u) || (glBootCheck.count == 0u))
     {
-        bootFw1 = true;
+        return false;
     }
-    if ((cyBtldrRunType & 0xFFFF) == PMG1_FW2_BOOT_RQT_SIG)
+
+    mdP = boot_slot_get_metadata (glBootCheck.order[0]);
+    return ((glBootCheck.rqtSlot != (uint8_t)PMG1_FW_MODE_INVALID) ||
+            (mdP->bootWaitTime == PMG1_FWMETA_WAIT_TIME_0));
+}
+
+pmg1_status_t boot_check_task (uint32_t budget)
+{
+    fw_metadata_t *mdP;
+    uint32_t count;
+
+    while ((glBootCheck.idx < glBootCheck.count) && (budget != 0u))
     {
-        bootFw2 = true;
-    }
+        mdP = boot_slot_get_metadata (glBootCheck.order[glBootCheck.idx]);
 
-    /* Check image pointer values and try to boot the newer image.*/
-    md1P = (fw_metadata_t *)PMG1_FW1_METADATA_ADDR;
-    md2P = (fw_metadata_t *)PMG1_FW2_METADATA_ADDR;
+        /* Slots with broken metadata fail without their image being read.*/
+        if ((glBootCheck.offset == 0u) && (!boot_metadata_is_sane (mdP)))
+        {
+            boot_check_next (PMG1_STAT_FAILURE);
+            continue;
+        }
 
-    /* If we have been specifically asked to boot FW2, do that.
-       Otherwise, if we have not been specifically asked to boot FW1; choose the binary with
-       greater sequence number.
-     */
-    if (!gl_img_status.status.fw2Invalid)
-    {
-        /* FW2 is valid.
-           We can boot this if:
-           1. We have been asked to boot FW2.
-           2. FW1 is not valid.
-           3. FW2 is newer than FW1, and we have not been asked to boot FW1.
-         */
-        if ((bootFw2) || (gl_img_status.status.fw1Invalid) || ((!bootFw1) && (md2P->bootSeq >= md1P->bootSeq)))
+#if PMG1_BOOT_RECORD_ENABLE
+        /* Image validated since its metadata was last written: take the recorded CRC.*/
+        if ((glBootCheck.offset == 0u) && (boot_record_matches (glBootCheck.order[glBootCheck.idx])))
         {
-            mdP = md2P;
-            activeFw  =  PMG1_FW_MODE_FWIMAGE_2;
+            glBootCheck.crc = ~mdP->fwCrc32;
+            boot_check_next (PMG1_STAT_SUCCESS);
+            continue;
         }
-        else
+#endif /* PMG1_BOOT_RECORD_ENABLE */
+
+        count = mdP->appFwSize - glBootCheck.offset;
+        if (count > budget)
         {
-            mdP = md1P;
-            activeFw  = PMG1_FW_MODE_FWIMAGE_1;
+            count = budget;
         }
-    }
-    else
-    {
-        /* FW2 is invalid.
-           Load FW1 if it is valid.
-         */
-        if (!gl_img_status.status.fw1Invalid)
+
+        glBootCheck.crc = crc32_update (glBootCheck.crc, (const uint8_t *)(mdP->appFwStart + glBootCheck.offset), count);
+        glBootCheck.offset += count;
+        budget -= count;
+
+        if (glBootCheck.offset == mdP->appFwSize)
         {
-            mdP = md1P;
-            activeFw  = PMG1_FW_MODE_FWIMAGE_1;
+            boot_check_next ((~glBootCheck.crc == mdP->fwCrc32) ? PMG1_STAT_SUCCESS : PMG1_STAT_FAILURE);
         }
     }
 
-    if (mdP != NULL)
+    if (glBootCheck.idx < glBootCheck.count)
     {
-        /* If we are in the middle of a jump-to-alt-fw command, do not provide the boot wait window.*/
-        if ((bootFw1) || (bootFw2))
-            glBootWaitDelay = PMG1_BL_WAIT_NO_DELAY;
-        else
-            boot_set_wait_timeout (mdP);
+        return PMG1_STAT_BUSY;
+    }
+
+    /* No valid image found, or a slot out of trial attempts waited for the other slots.*/
+    if (glBootCheck.decision == (uint8_t)BOOT_DECISION_PENDING)
+    {
+        boot_decide (glBootCheck.trialSlot);
+    }
+
+    return PMG1_STAT_SUCCESS;
+}
+
+void boot_check_finish (void)
+{
+    /* A decision made from here on would come too late: stay in boot mode.*/
+    if (glBootCheck.decision == (uint8_t)BOOT_DECISION_PENDING)
+    {
+        glBootCheck.decision = (uint8_t)BOOT_DECISION_STAY;
+    }
 
-        glActiveFw = activeFw;
-        return true;
+    while (boot_check_task (BOOT_CHECK_ALL) == PMG1_STAT_BUSY)
+    {
+    }
+}
+
+boot_decision_t boot_check_get_decision (void)
+{
+    return ((boot_decision_t)glBootCheck.decision);
+}
+
+bool boot_start (void)
+{
+    (void)boot_check_begin ();
+
+    /* Check all slots, as the application is told which of them are valid.*/
+    while (boot_check_task (BOOT_CHECK_ALL) == PMG1_STAT_BUSY)
+    {
+    }
+
+    return (glBootCheck.decision == (uint8_t)BOOT_DECISION_START);
+}
+
+/* Check whether a flash row belongs to a write protected slot.*/
+bool boot_slot_row_is_protected (uint16_t rowNum)
+{
+    fw_metadata_t *mdP;
+    uint32_t firstRow;
+    uint32_t lastRow;
+    uint8_t  slot;
+
+    BOOT_SLOT_FOREACH (slot)
+    {
+        /* A golden slot can only be written while it does not hold a valid image.*/
+        if (((glBootSlots[slot - 1u].flags & PMG1_FW_SLOT_FLAG_GOLDEN) != 0u) && (boot_slot_is_valid (slot)))
+        {
+            mdP      = boot_slot_get_metadata (slot);
+            firstRow = mdP->appFwStart >> PMG1_FLASH_ROW_SHIFT_NUM;
+            lastRow  = (mdP->appFwStart + mdP->appFwSize - 1u) >> PMG1_FLASH_ROW_SHIFT_NUM;
+
+            if ((rowNum == glBootSlots[slot - 1u].mdRow) || ((rowNum >= firstRow) && (rowNum <= lastRow)))
+            {
+                return true;
+            }
+        }
     }
 
-    /* Boot failed. Continue in boot mode.*/
     return false;
 }
 
@@ -263,6 +696,45 @@ void boot_jump_to_fw (void)
     Cy_SysLib_ClearResetReason();
     NVIC_SystemReset();
 }
+
+#if PMG1_BOOT_DIRECT_HANDOFF
+/* Return the core to its reset state and start the FW without a reset.*/
+void boot_handoff_to_app (void)
+{
+    fw_metadata_t *mdP = boot_slot_get_metadata ((uint8_t)glActiveFw);
+
+    if (mdP == NULL)
+    {
+        return;
+    }
+
+    __disable_irq ();
+
+    /* Stop the SysTick and drop a tick that may be pending.*/
+    SysTick->CTRL = 0;
+    SysTick->VAL  = 0;
+    SCB->ICSR     = SCB_ICSR_PENDSTCLR_Msk;
+
+    /* Disable and clear all interrupts enabled by the boot-loader.*/
+    NVIC->ICER[0] = 0xFFFFFFFFu;
+    NVIC->ICPR[0] = 0xFFFFFFFFu;
+
+    /* Vectors are fetched from flash after reset. Point the core at the application table
+       until its startup code sets up its own.*/
+    CPUSS_CONFIG &= ~CPUSS_CONFIG_VECS_IN_RAM_Msk;
+#if defined (__VTOR_PRESENT) && (__VTOR_PRESENT == 1U)
+    SCB->VTOR = mdP->appFwStart;
+#endif /* defined (__VTOR_PRESENT) && (__VTOR_PRESENT == 1U) */
+
+    /* Same state as Cy_OnResetUser() leaves behind.*/
+    cyBtldrRunType = PMG1_BOOT_TYPE_STAY_IN_BOOT;
+
+    /* Interrupts are enabled after reset: the application expects PRIMASK clear.*/
+    __enable_irq ();
+
+    boot_jump_to_app ();
+}
+#endif /* PMG1_BOOT_DIRECT_HANDOFF */
 #endif /* PMG1_BOOTLOAD_ENABLE */
 
 /* Return the reason for boot mode.*/
@@ -274,24 +746,68 @@ uint8_t boot_mode_get_reason (void)
 /* Get the boot sequence number value for the specified firmware image.*/
 uint32_t boot_get_boot_seq (uint8_t fwId)
 {
-    fw_metadata_t *mdP;
+    fw_metadata_t *mdP = boot_slot_get_metadata (fwId);
 
-    if (fwId == PMG1_FW_MODE_FWIMAGE_1)
+    if (boot_validate_firmware (mdP) == PMG1_STAT_SUCCESS)
     {
-        mdP = (fw_metadata_t *)PMG1_FW1_METADATA_ADDR;
+        return (mdP->bootSeq);
     }
-    else
+
+    return 0;
+}
+
+/* Get the boot sequence number to be assigned to a newly written slot.*/
+uint32_t boot_get_next_boot_seq (uint8_t slot)
+{
+    uint32_t seqNum = 0;
+    uint32_t otherSeq;
+    uint8_t  other;
+
+    BOOT_SLOT_FOREACH (other)
     {
-        mdP = (fw_metadata_t *)PMG1_FW2_METADATA_ADDR;
+        if (other != slot)
+        {
+            otherSeq = boot_get_boot_seq (other);
+            if (otherSeq > seqNum)
+            {
+                seqNum = otherSeq;
+            }
+        }
     }
 
-    if (boot_validate_firmware (mdP) == PMG1_STAT_SUCCESS)
+    return (seqNum + 1u);
+}
+
+#if PMG1_TRIAL_BOOT_ENABLE
+/* Confirm the image on trial.*/
+pmg1_status_t boot_trial_confirm (void)
+{
+    const boot_slot_desc_t *descP;
+    uint32_t sig = PMG1_FW_CONFIRM_SIG;
+    pmg1_status_t status;
+
+    /* Nothing to do if the running image is not on trial.*/
+    if (gl_boot_trial.sig != PMG1_BOOT_TRIAL_SIG)
     {
-        return (mdP->bootSeq);
+        return PMG1_STAT_SUCCESS;
     }
 
-    return 0;
+    descP = boot_slot_get_desc (gl_boot_trial.slot);
+    if (descP == NULL)
+    {
+        return PMG1_STAT_FAILURE;
+    }
+
+    status = flash_row_patch (descP->mdRow, PMG1_FLASH_ROW_SIZE - PMG1_FW_METADATA_SIZE + PMG1_FW_METADATA_CONFIRM_OFFSET,
+                              (const uint8_t *)&sig, sizeof (sig));
+    if (status == PMG1_STAT_SUCCESS)
+    {
+        gl_boot_trial.sig = 0;
+    }
+
+    return status;
 }
+#endif /* PMG1_TRIAL_BOOT_ENABLE */
 
 static void SwitchToApp(uint32_t stackPointer, uint32_t address)
 {
@@ -306,15 +822,10 @@ static void SwitchToApp(uint32_t stackPointer, uint32_t address)
 /* Function gets the active image meta data and jumps to the application.*/
 void boot_jump_to_app(void)
 {
-    if(glActiveFw!=PMG1_FW_MODE_INVALID)
-    {
-        fw_metadata_t *mdP = (fw_metadata_t *)PMG1_FW1_METADATA_ADDR;
-
-        if(glActiveFw == PMG1_FW_MODE_FWIMAGE_2)
-        {
-            mdP = (fw_metadata_t *)PMG1_FW2_METADATA_ADDR;
-        }
+    fw_metadata_t *mdP = boot_slot_get_metadata ((uint8_t)glActiveFw);
 
+    if(mdP != NULL)
+    {
         uint32_t fwStart = mdP->appFwStart;
         /* The Stack Pointer of the app to switch to.*/
         uint32_t stackPointer = ((uint32_t *)fwStart)[0];
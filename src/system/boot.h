@@ -60,12 +60,22 @@
 /* Signature used to indicate boot FW2 request.*/
 #define PMG1_FW2_BOOT_RQT_SIG            (0x4232)
 
+/* Signature used to indicate a boot request for firmware slot n: "B1", "B2", ...*/
+#define PMG1_FW_BOOT_RQT_SIG(n)          (0x4230 + (n))
+
 /* Firmware image is valid*/
 #define PMG1_FW_VALID                    (0)
 
 /* Firmware image is invalid*/
 #define PMG1_FW_INVALID                  (1)
 
+/* Bit in fw_img_status_t.val which flags firmware slot n as invalid.*/
+#define PMG1_FW_INVALID_MASK(n)          (1u << ((n) + 1u))
+
+/* Slot flag: golden image. Excluded from boot sequence comparison and write
+ * protected while it holds a valid image.*/
+#define PMG1_FW_SLOT_FLAG_GOLDEN         (0x01u)
+
 /* Firmware metadata valid signature: "IF" */
 #define PMG1_FW_METADATA_VALID_SIG       (0x4946)
 
@@ -78,6 +88,25 @@
 /* Firmware boot sequence number offset.*/
 #define PMG1_FW_METADATA_BOOTSEQ_OFFSET  (0x14)
 
+/* Offset and size of the verification record (authMagic and authTag) in metadata.*/
+#define PMG1_FW_METADATA_AUTH_OFFSET     (0x18)
+#define PMG1_FW_METADATA_AUTH_SIZE       (20)
+
+/* Verification record signature: "AUTH" */
+#define PMG1_FW_AUTH_RECORD_SIG          (0x41555448u)
+
+/* Offset of the metadata valid signature field.*/
+#define PMG1_FW_METADATA_VALID_OFFSET    (0x56)
+
+/* Offset of the image confirmation field in metadata.*/
+#define PMG1_FW_METADATA_CONFIRM_OFFSET  (0x0C)
+
+/* Image confirmation signature: "CONF" */
+#define PMG1_FW_CONFIRM_SIG              (0x434F4E46u)
+
+/* Trial boot record signature: "TRIA" */
+#define PMG1_BOOT_TRIAL_SIG              (0x54524941u)
+
 /* No delay for PMG1 boot-loader: 0 ms */
 #define PMG1_BL_WAIT_NO_DELAY            (0)
 
@@ -109,9 +138,26 @@ typedef enum
     PMG1_FW_MODE_BOOTLOADER = 0,     /**< Bootloader mode.*/
     PMG1_FW_MODE_FWIMAGE_1,          /**< Firmware Image #1*/
     PMG1_FW_MODE_FWIMAGE_2,          /**< Firmware Image #2*/
+#if (PMG1_FW_SLOT_COUNT > 2)
+    PMG1_FW_MODE_FWIMAGE_3,          /**< Firmware Image #3*/
+#endif /* (PMG1_FW_SLOT_COUNT > 2) */
+#if (PMG1_FW_SLOT_COUNT > 3)
+    PMG1_FW_MODE_FWIMAGE_4,          /**< Firmware Image #4*/
+#endif /* (PMG1_FW_SLOT_COUNT > 3) */
     PMG1_FW_MODE_INVALID             /**< Invalid value.*/
 } pmg1_fw_mode_t;
 
+/**
+ * @typedef boot_decision_t
+ * @brief Outcome of the image check started by boot_check_begin().
+ */
+typedef enum
+{
+    BOOT_DECISION_PENDING = 0,       /**< No valid image found yet.*/
+    BOOT_DECISION_STAY,              /**< Stay in boot mode.*/
+    BOOT_DECISION_START              /**< Start the firmware selected in glActiveFw.*/
+} boot_decision_t;
+
 /*****************************************************************************
 * Data Struct Definition
 *****************************************************************************/
@@ -126,14 +172,21 @@ typedef struct __attribute__((__packed__))
     uint32_t appFwSize;             /**< Offset 04: Firmware Size */
     uint16_t bootWaitTime;          /**< Offset 08: Boot wait time */
     uint16_t bootLastRow;           /**< Offset 0A: Last Flash row of Bootloader or previous firmware. */
-    uint32_t reserved1[2];          /**< Offset 0C: Reserved. */
+    uint32_t bootConfirm;           /**< Offset 0C: Set to PMG1_FW_CONFIRM_SIG by the application once the image
+                                         has started successfully. Cleared by the boot-loader on every update. */
+    uint32_t reserved1;             /**< Offset 10: Reserved. */
     uint32_t bootSeq;               /**< Offset 14: Boot sequence number field. Boot-loader will load the valid
                                          FW copy that has the higher sequence number associated with it. */
-    uint32_t reserved2[15];         /**< Offset 18: Reserved. */
+    uint32_t authMagic;             /**< Offset 18: Verification record signature. Written by the boot-loader
+                                         once the image has been authenticated. */
+    uint32_t authTag[4];            /**< Offset 1C: Verification record tag binding the record to the device
+                                         and to the metadata, including the image digest and sequence number. */
+    uint32_t reserved2[10];         /**< Offset 2C: Reserved. */
     uint16_t metadataVersion;       /**< Offset 54: Version of the metadata structure. */
     uint16_t metadataValid;         /**< Offset 56: Metadata Valid field. Valid if contains "IF". */
     uint32_t fwCrc32;               /**< Offset 58: Verify Fw CRC32 checksum */
-    uint32_t reserved3[8];          /**< Offset 5C: Reserved. */
+    uint32_t fwDigest[8];           /**< Offset 5C: SHA-256 digest of the firmware image. Only checked when
+                                         PMG1_AUTH_BOOT_ENABLE is set. */
     uint32_t reserved;              /**< Offset 7C: Reserved for Metadata CRC32 checksum. */
 } fw_metadata_t;
 
@@ -150,10 +203,38 @@ typedef union
         uint8_t reserved1        : 1;      /**< Reserved for later use. */
         uint8_t fw1Invalid       : 1;      /**< FW1 image invalid: 0=Valid, 1=Invalid. */
         uint8_t fw2Invalid       : 1;      /**< FW2 image invalid: 0=Valid, 1=Invalid. */
-        uint8_t reserved2        : 4;      /**< Reserved for later use. */
+        uint8_t fw3Invalid       : 1;      /**< FW3 image invalid: 0=Valid, 1=Invalid. Formerly reserved. */
+        uint8_t fw4Invalid       : 1;      /**< FW4 image invalid: 0=Valid, 1=Invalid. Formerly reserved. */
+        uint8_t trialRevert      : 1;      /**< An image ran out of trial boot attempts and was invalidated.
+                                                Formerly reserved. */
+        uint8_t reserved2        : 1;      /**< Reserved for later use. */
     } status;
 } fw_img_status_t;
 
+/**
+ * @typedef boot_trial_t
+ * @brief Trial boot state, kept in no-init RAM shared with the application.
+ */
+typedef struct
+{
+    uint32_t sig;                   /**< PMG1_BOOT_TRIAL_SIG while an image is on trial. */
+    uint32_t bootSeq;               /**< Boot sequence number of the image on trial. */
+    uint8_t  slot;                  /**< Slot holding the image on trial. */
+    uint8_t  attempts;              /**< Number of times the image has been started. */
+    uint16_t reserved;              /**< Reserved for later use. */
+} boot_trial_t;
+
+/**
+ * @typedef boot_slot_desc_t
+ * @brief Descriptor of a firmware image slot.
+ */
+typedef struct
+{
+    uint16_t mdRow;                 /**< Flash row holding the slot metadata. */
+    uint8_t  flags;                 /**< Slot flags: PMG1_FW_SLOT_FLAG_XXX. */
+    uint8_t  reserved;              /**< Reserved for later use. */
+} boot_slot_desc_t;
+
 
 /*****************************************************************************
 * Global Function Declaration
@@ -169,6 +250,48 @@ typedef union
  * @return bool
  */
 bool boot_start (void);
+
+/**
+ * @brief Start a resumable check of the firmware images. All slots read as invalid
+ * until they have been checked.
+ * @return true if the image expected to be booted has no boot-wait window, so that
+ * the caller can finish the check before bringing up the HPI interface.
+ */
+bool boot_check_begin (void);
+
+/**
+ * @brief Continue the image check started by boot_check_begin(). The boot decision
+ * is made as soon as the first valid image in boot order has been checked, and the
+ * remaining slots are checked after that.
+ * @budget Maximum number of image bytes to read in this call.
+ * @return PMG1_STAT_BUSY while slots remain to be checked, PMG1_STAT_SUCCESS once done.
+ */
+pmg1_status_t boot_check_task (uint32_t budget);
+
+/**
+ * @brief Check all remaining slots at once. A boot decision still pending becomes
+ * BOOT_DECISION_STAY. Used before the slot states are relied on to protect flash.
+ */
+void boot_check_finish (void);
+
+/**
+ * @brief Get the boot decision made by the image check.
+ * @return Boot decision.
+ */
+boot_decision_t boot_check_get_decision (void);
+
+/**
+ * @brief Record the time of a boot phase in the handoff block.
+ * @phase BOOT_HANDOFF_PHASE_XXX.
+ */
+void boot_handoff_mark (uint8_t phase);
+
+/**
+ * @brief Complete the handoff block and make it valid. Called right before the
+ * firmware is started.
+ * @hpiSlaveAddr HPI I2C slave address in use.
+ */
+void boot_handoff_publish (uint8_t hpiSlaveAddr);
 #endif /* PMG1_BOOTLOAD_ENABLE */
 
 /**
@@ -184,6 +307,16 @@ uint16_t boot_get_wait_time (void);
  */
 void boot_jump_to_fw (void);
 
+#if PMG1_BOOT_DIRECT_HANDOFF
+/**
+ * @brief Starts the FW app without a RESET. The SysTick, the NVIC and the vector table
+ * location are returned to their reset state before jumping. The caller must have shut
+ * down the peripherals, pins and clocks it configured. Does not return unless no
+ * valid firmware has been selected.
+ */
+void boot_handoff_to_app (void);
+#endif /* PMG1_BOOT_DIRECT_HANDOFF */
+
 /**
  * Returns Bit map containing the reason for boot mode.
  * @param NONE
@@ -210,6 +343,75 @@ uint32_t boot_get_boot_seq (uint8_t fwId);
  */
 void boot_jump_to_app(void);
 
+/**
+ * @brief Iterate over all firmware slots in slot number order.
+ * @slot uint8_t variable used as the loop counter.
+ */
+#define BOOT_SLOT_FOREACH(slot)                                               \
+    for ((slot) = (uint8_t)PMG1_FW_MODE_FWIMAGE_1; (slot) <= PMG1_FW_SLOT_COUNT; (slot)++)
+
+/**
+ * @brief Get the descriptor of a firmware slot.
+ * @slot Slot number: PMG1_FW_MODE_FWIMAGE_1 onwards.
+ * @return Pointer to the slot descriptor, NULL if the slot does not exist.
+ */
+const boot_slot_desc_t *boot_slot_get_desc (uint8_t slot);
+
+/**
+ * @brief Get the metadata of a firmware slot.
+ * @slot Slot number: PMG1_FW_MODE_FWIMAGE_1 onwards.
+ * @return Pointer to the slot metadata in flash, NULL if the slot does not exist.
+ */
+fw_metadata_t *boot_slot_get_metadata (uint8_t slot);
+
+/**
+ * @brief Get the slot whose metadata is stored in the given flash row.
+ * @rowNum Flash row number.
+ * @return Slot number, PMG1_FW_MODE_INVALID if the row holds no slot metadata.
+ */
+uint8_t boot_slot_from_md_row (uint16_t rowNum);
+
+/**
+ * @brief Get the slot at a given position of the configured fallback order.
+ * @index Position in the fallback order, starting at 0.
+ * @return Slot number, PMG1_FW_MODE_INVALID once the end of the list is reached.
+ */
+uint8_t boot_slot_get_fallback (uint8_t index);
+
+/**
+ * @brief Check whether a slot was found valid by the last boot_start() call.
+ * @slot Slot number: PMG1_FW_MODE_FWIMAGE_1 onwards.
+ * @return true if the slot holds a valid image.
+ */
+bool boot_slot_is_valid (uint8_t slot);
+
+/**
+ * @brief Get the boot sequence number to be assigned to a newly written slot.
+ * @slot Slot whose metadata is being written.
+ * @return One more than the highest sequence number of the other valid slots.
+ */
+uint32_t boot_get_next_boot_seq (uint8_t slot);
+
+#if PMG1_TRIAL_BOOT_ENABLE
+/**
+ * @brief Confirm the running image. To be called by the application once it has
+ * started successfully. Until then, the image is on trial: after
+ * PMG1_TRIAL_BOOT_ATTEMPTS starts without confirmation, the boot-loader invalidates
+ * it and boots the previous image.
+ * @return PMG1_STAT_SUCCESS if the image is confirmed or was not on trial.
+ */
+pmg1_status_t boot_trial_confirm (void);
+#endif /* PMG1_TRIAL_BOOT_ENABLE */
+
+#if PMG1_BOOTLOAD_ENABLE
+/**
+ * @brief Check whether a flash row belongs to a write protected slot.
+ * @rowNum Flash row number.
+ * @return true if the row is part of a valid golden image or its metadata.
+ */
+bool boot_slot_row_is_protected (uint16_t rowNum);
+#endif /* PMG1_BOOTLOAD_ENABLE */
+
 #endif /* __BOOT_H__ */
 
 /* [] END OF FILE */
@@ -0,0 +1,230 @@
+/******************************************************************************
+* File Name: boot_auth.c
+*
+* Description: This source file implements firmware authentication for the
+*              PMG1 boot-loader.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "cy_pdl.h"
+#include "config.h"
+#include "flash.h"
+#include "boot.h"
+#include "boot_auth.h"
+#include "sha256.h"
+
+#if PMG1_AUTH_BOOT_ENABLE
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+/* Metadata bytes ahead of the confirmation field: location, size, boot-wait and last row.*/
+#define BOOT_AUTH_MD_HEAD_SIZE              (PMG1_FW_METADATA_CONFIRM_OFFSET)
+
+/* Metadata bytes from the version field up to the metadata checksum: signature, CRC and digest.*/
+#define BOOT_AUTH_MD_TAIL_OFFSET            (0x54u)
+#define BOOT_AUTH_MD_TAIL_SIZE              (0x7Cu - BOOT_AUTH_MD_TAIL_OFFSET)
+
+/* HMAC-SHA256 pad bytes.*/
+#define BOOT_AUTH_HMAC_IPAD                 (0x36u)
+#define BOOT_AUTH_HMAC_OPAD                 (0x5Cu)
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+/*
+ * Compute the verification tag of a slot: an HMAC-SHA256, keyed with the record key,
+ * over the device unique ID and every metadata field except the record itself and the
+ * confirmation field, which the application writes. As the boot sequence number is
+ * assigned by the boot-loader on each metadata write, the tag changes with every update
+ * of the slot even if the same image is written again.
+ */
+static void boot_auth_calc_tag (const uint8_t *keyP, const fw_metadata_t *mdP, uint8_t *tagP)
+{
+    sha256_ctx_t ctx;
+    uint8_t pad[SHA256_BLOCK_SIZE];
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    uint64_t uniqueId = Cy_SysLib_GetUniqueId ();
+    uint32_t sig = PMG1_FW_AUTH_RECORD_SIG;
+    uint8_t idx;
+
+    /* Inner hash: key ^ ipad, then the message.*/
+    memset (pad, BOOT_AUTH_HMAC_IPAD, sizeof (pad));
+    for (idx = 0; idx < BOOT_AUTH_KEY_SIZE; idx++)
+    {
+        pad[idx] ^= keyP[idx];
+    }
+
+    sha256_init (&ctx);
+    sha256_update (&ctx, pad, sizeof (pad));
+    sha256_update (&ctx, (const uint8_t *)&uniqueId, sizeof (uniqueId));
+    sha256_update (&ctx, (const uint8_t *)&sig, sizeof (sig));
+    sha256_update (&ctx, (const uint8_t *)mdP, BOOT_AUTH_MD_HEAD_SIZE);
+    sha256_update (&ctx, (const uint8_t *)&mdP->bootSeq, sizeof (mdP->bootSeq));
+    sha256_update (&ctx, (const uint8_t *)mdP + BOOT_AUTH_MD_TAIL_OFFSET, BOOT_AUTH_MD_TAIL_SIZE);
+    sha256_final (&ctx, digest);
+
+    /* Outer hash: key ^ opad, then the inner digest.*/
+    for (idx = 0; idx < SHA256_BLOCK_SIZE; idx++)
+    {
+        pad[idx] ^= (uint8_t)(BOOT_AUTH_HMAC_IPAD ^ BOOT_AUTH_HMAC_OPAD);
+    }
+
+    sha256_init (&ctx);
+    sha256_update (&ctx, pad, sizeof (pad));
+    sha256_update (&ctx, digest, sizeof (digest));
+    sha256_final (&ctx, digest);
+
+    /* Do not leave key material on the stack.*/
+    memset (pad, 0, sizeof (pad));
+
+    memcpy (tagP, digest, BOOT_AUTH_TAG_SIZE);
+}
+
+/* Check whether the slot holds a verification record matching its current contents.*/
+static bool boot_auth_record_valid (const uint8_t *keyP, const fw_metadata_t *mdP)
+{
+    uint8_t tag[BOOT_AUTH_TAG_SIZE];
+    uint8_t diff = 0;
+    uint8_t idx;
+
+    if (mdP->authMagic != PMG1_FW_AUTH_RECORD_SIG)
+    {
+        return false;
+    }
+
+    boot_auth_calc_tag (keyP, mdP, tag);
+
+    /* Compare all bytes so that the time taken does not depend on the tag.*/
+    for (idx = 0; idx < BOOT_AUTH_TAG_SIZE; idx++)
+    {
+        diff |= tag[idx] ^ ((const uint8_t *)mdP->authTag)[idx];
+    }
+
+    return (diff == 0u);
+}
+
+/* Hash the image and check its digest and signature.*/
+static pmg1_status_t boot_auth_verify_image (const fw_metadata_t *mdP)
+{
+    sha256_ctx_t ctx;
+    uint8_t digest[SHA256_DIGEST_SIZE];
+
+    sha256_init (&ctx);
+    sha256_update (&ctx, (const uint8_t *)mdP->appFwStart, mdP->appFwSize);
+    sha256_final (&ctx, digest);
+
+    if (memcmp (digest, (const uint8_t *)mdP->fwDigest, SHA256_DIGEST_SIZE) != 0)
+    {
+        return PMG1_STAT_FAILURE;
+    }
+
+    return boot_auth_verify_signature (mdP, digest);
+}
+
+pmg1_status_t boot_auth_check (uint8_t slot)
+{
+    const boot_slot_desc_t *descP = boot_slot_get_desc (slot);
+    fw_metadata_t *mdP = boot_slot_get_metadata (slot);
+    const uint8_t *keyP = boot_auth_get_record_key ();
+    uint32_t record[PMG1_FW_METADATA_AUTH_SIZE / sizeof (uint32_t)];
+
+    if ((descP == NULL) || (mdP == NULL))
+    {
+        return PMG1_STAT_FAILURE;
+    }
+
+    /* Fast path: the image has been authenticated since the slot was last written.
+       Without a record key, every check is a full one.*/
+    if ((keyP != NULL) && (boot_auth_record_valid (keyP, mdP)))
+    {
+        return PMG1_STAT_SUCCESS;
+    }
+
+    if (boot_auth_verify_image (mdP) != PMG1_STAT_SUCCESS)
+    {
+        return PMG1_STAT_FAILURE;
+    }
+
+    if (keyP == NULL)
+    {
+        return PMG1_STAT_SUCCESS;
+    }
+
+    /* Record the result for later boots. Failing to store it only costs another full check.*/
+    record[0] = PMG1_FW_AUTH_RECORD_SIG;
+    boot_auth_calc_tag (keyP, mdP, (uint8_t *)&record[1]);
+    (void)flash_row_patch (descP->mdRow, PMG1_FLASH_ROW_SIZE - PMG1_FW_METADATA_SIZE + PMG1_FW_METADATA_AUTH_OFFSET,
+                           (const uint8_t *)record, PMG1_FW_METADATA_AUTH_SIZE);
+
+    return PMG1_STAT_SUCCESS;
+}
+
+void boot_auth_revoke (void)
+{
+    const boot_slot_desc_t *descP;
+    uint8_t slot;
+
+    BOOT_SLOT_FOREACH (slot)
+    {
+        descP = boot_slot_get_desc (slot);
+
+        /* Slots that cannot be written keep their record.*/
+        if ((boot_slot_get_metadata (slot)->authMagic != 0u) && (!boot_slot_row_is_protected (descP->mdRow)))
+        {
+            (void)flash_row_patch (descP->mdRow, PMG1_FLASH_ROW_SIZE - PMG1_FW_METADATA_SIZE + PMG1_FW_METADATA_AUTH_OFFSET,
+                                   NULL, PMG1_FW_METADATA_AUTH_SIZE);
+        }
+    }
+}
+
+__WEAK const uint8_t *boot_auth_get_record_key (void)
+{
+    return NULL;
+}
+
+__WEAK pmg1_status_t boot_auth_verify_signature (const fw_metadata_t *mdP, const uint8_t *digestP)
+{
+    (void)mdP;
+    (void)digestP;
+
+    return PMG1_STAT_FAILURE;
+}
+
+#endif /* PMG1_AUTH_BOOT_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name: boot_auth.h
+*
+* Description: This header file defines the firmware authentication interface
+*              of the PMG1 boot-loader.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __BOOT_AUTH_H__
+#define __BOOT_AUTH_H__
+
+#include <stdint.h>
+#include "config.h"
+#include "status.h"
+#include "boot.h"
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+
+/* Number of verification tag bytes kept in the metadata.*/
+#define BOOT_AUTH_TAG_SIZE                  (16u)
+
+/* Size of the key of the verification record tag.*/
+#define BOOT_AUTH_KEY_SIZE                  (32u)
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+#if PMG1_AUTH_BOOT_ENABLE
+/**
+ * @brief Check that the image in a slot is authentic. A matching verification record
+ * makes this an HMAC over the metadata only. Otherwise, the SHA-256 digest of the image
+ * is computed and checked, and a new record is stored on success. The caller must have
+ * checked the image with boot_validate_firmware() first.
+ * @slot Slot number: PMG1_FW_MODE_FWIMAGE_1 onwards.
+ * @return PMG1_STAT_SUCCESS if the image is authentic, PMG1_STAT_FAILURE otherwise.
+ */
+pmg1_status_t boot_auth_check (uint8_t slot);
+
+/**
+ * @brief Drop the verification records of all slots that can be written. Called when
+ * flashing mode is entered, before any image row can change.
+ */
+void boot_auth_revoke (void);
+
+/**
+ * @brief Check the signature of an image digest. The default implementation rejects
+ * all images: products enabling PMG1_AUTH_BOOT_ENABLE provide their own, which looks
+ * up the signature and verifies it against the product key.
+ * @mdP Metadata of the image.
+ * @digestP SHA-256 digest of the image, SHA256_DIGEST_SIZE bytes.
+ * @return PMG1_STAT_SUCCESS if the signature is good.
+ */
+pmg1_status_t boot_auth_verify_signature (const fw_metadata_t *mdP, const uint8_t *digestP);
+
+/**
+ * @brief Get the key of the verification record tag. Anyone who can read the key can
+ * forge a record for a metadata row they write, so the key has to be kept where the
+ * application cannot read it, for example in a flash region that the product locks
+ * before jumping to the application. The default implementation returns NULL: no
+ * records are kept and every boot runs the full check.
+ * @return BOOT_AUTH_KEY_SIZE key bytes, or NULL if the product has no record key.
+ */
+const uint8_t *boot_auth_get_record_key (void);
+#endif /* PMG1_AUTH_BOOT_ENABLE */
+
+#endif /* __BOOT_AUTH_H__ */
+
+/* [] END OF FILE */
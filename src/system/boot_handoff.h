@@ -0,0 +1,177 @@
+/******************************************************************************
+* File Name: boot_handoff.h
+*
+* Description: This header file defines the block through which the PMG1
+*              boot-loader passes its results to the application. It is
+*              self-contained so that applications can include it as is.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __BOOT_HANDOFF_H__
+#define __BOOT_HANDOFF_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "cy_utils.h"
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+
+/* Signature of a published handoff block: "HOFF".*/
+#define BOOT_HANDOFF_SIG                    (0x46464F48u)
+
+/* Layout version. Later versions only append fields, so readers check for a
+ * version and size at least as large as the ones they know.*/
+#define BOOT_HANDOFF_VERSION                (1u)
+
+/* Largest block size accepted by the reader.*/
+#define BOOT_HANDOFF_MAX_SIZE               (256u)
+
+/* Number of slot entries in the block, independent of PMG1_FW_SLOT_COUNT.*/
+#define BOOT_HANDOFF_SLOTS                  (4u)
+
+/* Slot states, BOOT_HANDOFF_SLOT_STATE_BITS bits per slot in slotState.*/
+#define BOOT_HANDOFF_SLOT_UNCHECKED         (0u)    /* Not checked by this boot. */
+#define BOOT_HANDOFF_SLOT_VALID             (1u)    /* Passed all checks. */
+#define BOOT_HANDOFF_SLOT_INVALID           (2u)    /* Failed a check. */
+#define BOOT_HANDOFF_SLOT_STATE_BITS        (2u)
+#define BOOT_HANDOFF_SLOT_STATE_MASK        (3u)
+
+/* Boot phases timed in phaseUs[]. Times count from the start of the boot-loader
+ * soft timer, which is set up right after the system clock.*/
+#define BOOT_HANDOFF_PHASE_CHECK            (0u)    /* Image check started. */
+#define BOOT_HANDOFF_PHASE_DECISION         (1u)    /* Boot decision made. */
+#define BOOT_HANDOFF_PHASE_HPI              (2u)    /* HPI ready; 0 if HPI was not started. */
+#define BOOT_HANDOFF_PHASE_START            (3u)    /* Control passed to the application. */
+#define BOOT_HANDOFF_PHASES                 (4u)
+
+/* Section attribute placing a variable in the shared handoff section. Applications
+ * that are not built with boot.c define the block with it.*/
+#if defined(__ARMCC_VERSION)
+#define BOOT_HANDOFF_SECTION                CY_SECTION(".bss.cy_boot_handoff") __USED
+#else
+#define BOOT_HANDOFF_SECTION                CY_SECTION(".cy_boot_handoff") __USED
+#endif /* defined(__ARMCC_VERSION) */
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/**
+ * @typedef boot_handoff_t
+ * @brief Boot-loader results, kept in no-init RAM shared with the application.
+ */
+typedef struct
+{
+    uint32_t sig;                               /**< Offset 00: BOOT_HANDOFF_SIG once published. */
+    uint16_t version;                           /**< Offset 04: BOOT_HANDOFF_VERSION of the writer. */
+    uint16_t size;                              /**< Offset 06: Size of the block in bytes. */
+    uint32_t crc;                               /**< Offset 08: CRC-32C of the bytes from offset 0C up to size. */
+    uint8_t  activeSlot;                        /**< Offset 0C: Slot started by the boot-loader. */
+    uint8_t  imgStatus;                         /**< Offset 0D: Boot mode reason, as in gl_img_status. */
+    uint8_t  hpiSlaveAddr;                      /**< Offset 0E: HPI I2C slave address. */
+    uint8_t  slotState;                         /**< Offset 0F: BOOT_HANDOFF_SLOT_XXX per slot, slot 1 lowest. */
+    uint32_t resetReason;                       /**< Offset 10: Cy_SysLib_GetResetReason() at boot. */
+    uint32_t slotCrc[BOOT_HANDOFF_SLOTS];       /**< Offset 14: Image CRC computed for each checked slot. */
+    uint32_t slotSeq[BOOT_HANDOFF_SLOTS];       /**< Offset 24: Boot sequence number of each checked slot. */
+    uint32_t phaseUs[BOOT_HANDOFF_PHASES];      /**< Offset 34: Boot phase times in microseconds. */
+} boot_handoff_t;
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+/**
+ * @brief Compute the CRC of a handoff block: CRC-32C, as used for the firmware images.
+ * @hoP Handoff block with a valid size field.
+ * @return CRC value to be stored in or compared with the crc field.
+ */
+static inline uint32_t boot_handoff_calc_crc (const volatile boot_handoff_t *hoP)
+{
+    const volatile uint8_t *dataP = (const volatile uint8_t *)hoP;
+    uint32_t crc = 0xFFFFFFFFu;
+    uint32_t idx;
+    uint8_t  bit;
+
+    for (idx = offsetof (boot_handoff_t, activeSlot); idx < hoP->size; idx++)
+    {
+        crc ^= dataP[idx];
+        for (bit = 0; bit < 8u; bit++)
+        {
+            crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+        }
+    }
+
+    return (~crc);
+}
+
+/**
+ * @brief Check that a handoff block has been published by the boot which started
+ * the running application.
+ * @hoP Handoff block.
+ * @return true if the block can be used.
+ */
+static inline bool boot_handoff_is_valid (const volatile boot_handoff_t *hoP)
+{
+    return ((hoP->sig == BOOT_HANDOFF_SIG) && (hoP->version >= BOOT_HANDOFF_VERSION) &&
+            (hoP->size >= sizeof (boot_handoff_t)) && (hoP->size <= BOOT_HANDOFF_MAX_SIZE) &&
+            (hoP->crc == boot_handoff_calc_crc (hoP)));
+}
+
+/**
+ * @brief Get the state in which the boot-loader found a slot.
+ * @hoP Valid handoff block.
+ * @slot Slot number, starting at 1.
+ * @return BOOT_HANDOFF_SLOT_XXX.
+ */
+static inline uint8_t boot_handoff_get_slot_state (const volatile boot_handoff_t *hoP, uint8_t slot)
+{
+    if ((slot == 0u) || (slot > BOOT_HANDOFF_SLOTS))
+    {
+        return BOOT_HANDOFF_SLOT_UNCHECKED;
+    }
+
+    return (uint8_t)((hoP->slotState >> ((slot - 1u) * BOOT_HANDOFF_SLOT_STATE_BITS)) & BOOT_HANDOFF_SLOT_STATE_MASK);
+}
+
+/* Handoff block, defined by boot.c or by the application with BOOT_HANDOFF_SECTION.*/
+extern volatile boot_handoff_t gl_boot_handoff;
+
+#endif /* __BOOT_HANDOFF_H__ */
+
+/* [] END OF FILE */
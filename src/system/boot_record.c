@@ -0,0 +1,165 @@
+/******************************************************************************
+* File Name: boot_record.c
+*
+* Description: Boot-decision record kept in an SFLASH user row. It lets the
+*              boot-loader skip the image CRC check of a slot whose metadata is
+*              unchanged since the image was last validated.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "config.h"
+#include "flash.h"
+#include "boot.h"
+#include "boot_record.h"
+#include "crc32.h"
+
+#if PMG1_BOOT_RECORD_ENABLE
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+#ifndef PMG1_SFLASH_USER_ROW_BASE
+#error "PMG1_BOOT_RECORD_ENABLE needs PMG1_SFLASH_USER_ROW_BASE: the address of SFLASH user row 0 of the device."
+#endif
+
+#if ((PMG1_BOOT_RECORD_SFLASH_ROW) >= (PMG1_SFLASH_USER_ROW_COUNT))
+#error "PMG1_BOOT_RECORD_SFLASH_ROW is not an SFLASH user row."
+#endif
+
+/* The record as stored in the SFLASH user row.*/
+#define BOOT_RECORD_STORED                  ((const boot_record_t *)PMG1_SFLASH_USER_ROW_ADDR (PMG1_BOOT_RECORD_SFLASH_ROW))
+
+/* Bytes covered by the record CRC.*/
+#define BOOT_RECORD_CRC_SIZE                (sizeof (boot_record_t) - sizeof (uint32_t))
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+/* Build the record of a slot from its current metadata.*/
+static void boot_record_make (uint8_t slot, const fw_metadata_t *mdP, boot_record_t *recP)
+{
+    memset (recP, 0, sizeof (boot_record_t));
+    recP->sig        = PMG1_BOOT_RECORD_SIG;
+    recP->slot       = slot;
+    recP->appFwStart = mdP->appFwStart;
+    recP->appFwSize  = mdP->appFwSize;
+    recP->bootSeq    = mdP->bootSeq;
+    recP->fwCrc32    = mdP->fwCrc32;
+    memcpy (recP->fwDigest, (const void *)mdP->fwDigest, sizeof (recP->fwDigest));
+    recP->crc        = calculate_crc32 ((const uint8_t *)recP, BOOT_RECORD_CRC_SIZE);
+}
+
+/* Check that the stored record is intact. An erased or torn row fails the CRC.*/
+static bool boot_record_is_valid (void)
+{
+    const boot_record_t *recP = BOOT_RECORD_STORED;
+
+    return ((recP->sig == PMG1_BOOT_RECORD_SIG) &&
+            (recP->crc == calculate_crc32 ((const uint8_t *)recP, BOOT_RECORD_CRC_SIZE)));
+}
+
+bool boot_record_matches (uint8_t slot)
+{
+    const fw_metadata_t *mdP = boot_slot_get_metadata (slot);
+    boot_record_t record;
+
+    if ((mdP == NULL) || (!boot_record_is_valid ()))
+    {
+        return false;
+    }
+
+    boot_record_make (slot, mdP, &record);
+    return (memcmp (&record, BOOT_RECORD_STORED, sizeof (boot_record_t)) == 0);
+}
+
+void boot_record_commit (uint8_t slot)
+{
+    const fw_metadata_t *mdP = boot_slot_get_metadata (slot);
+    boot_record_t record;
+
+    if (mdP == NULL)
+    {
+        return;
+    }
+
+    /* Validating the same image again leaves the SFLASH row alone.*/
+    boot_record_make (slot, mdP, &record);
+    if (memcmp (&record, BOOT_RECORD_STORED, sizeof (boot_record_t)) == 0)
+    {
+        return;
+    }
+
+    /* Failing to store the record only costs a full check on the next boot.*/
+    (void)flash_sflash_row_write (PMG1_BOOT_RECORD_SFLASH_ROW, (const uint8_t *)&record, sizeof (record));
+}
+
+void boot_record_revoke (void)
+{
+    const boot_slot_desc_t *descP;
+
+    if (!boot_record_is_valid ())
+    {
+        return;
+    }
+
+    /* A slot that cannot be written keeps its record.*/
+    descP = boot_slot_get_desc (BOOT_RECORD_STORED->slot);
+    if ((descP == NULL) || (!boot_slot_row_is_protected (descP->mdRow)))
+    {
+        (void)flash_sflash_row_write (PMG1_BOOT_RECORD_SFLASH_ROW, NULL, 0);
+    }
+}
+
+bool boot_record_covers_row (uint16_t rowNum)
+{
+    const boot_record_t *recP = BOOT_RECORD_STORED;
+    const boot_slot_desc_t *descP;
+    uint32_t addr = (uint32_t)rowNum << PMG1_FLASH_ROW_SHIFT_NUM;
+
+    if (!boot_record_is_valid ())
+    {
+        return false;
+    }
+
+    descP = boot_slot_get_desc (recP->slot);
+    return (((descP != NULL) && (descP->mdRow == rowNum)) ||
+            ((addr + PMG1_FLASH_ROW_SIZE > recP->appFwStart) && (addr < recP->appFwStart + recP->appFwSize)));
+}
+
+#endif /* PMG1_BOOT_RECORD_ENABLE */
+
+/* [] END OF FILE */
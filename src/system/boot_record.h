@@ -0,0 +1,118 @@
+/******************************************************************************
+* File Name: boot_record.h
+*
+* Description: This header file defines the boot-decision record kept in an
+*              SFLASH user row by the PMG1 boot-loader.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __BOOT_RECORD_H__
+#define __BOOT_RECORD_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "status.h"
+#include "boot.h"
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+
+/* Boot-decision record signature: "BREC" */
+#define PMG1_BOOT_RECORD_SIG                (0x43455242u)
+
+/*******************************************************************************
+* Data Struct Definition
+*******************************************************************************/
+
+/**
+ * @brief Boot-decision record. It holds the metadata fields describing the image of
+ * the slot validated last. The boot sequence number serves as the generation of the
+ * metadata: the boot-loader assigns a new one on every metadata write.
+ */
+typedef struct __attribute__((__packed__))
+{
+    uint32_t sig;                   /**< PMG1_BOOT_RECORD_SIG. */
+    uint8_t  slot;                  /**< Slot the record applies to. */
+    uint8_t  reserved[3];           /**< Reserved, zero. */
+    uint32_t appFwStart;            /**< Image location. */
+    uint32_t appFwSize;             /**< Image size. */
+    uint32_t bootSeq;               /**< Boot sequence number of the metadata. */
+    uint32_t fwCrc32;               /**< Image CRC-32. */
+    uint32_t fwDigest[8];           /**< Image SHA-256 digest. */
+    uint32_t crc;                   /**< CRC-32 of the fields above. */
+} boot_record_t;
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+#if PMG1_BOOT_RECORD_ENABLE
+/**
+ * @brief Check whether the boot-decision record applies to a slot, i.e. the image of
+ * the slot has been validated and its metadata has not changed since.
+ * @slot Slot number: PMG1_FW_MODE_FWIMAGE_1 onwards.
+ * @return true if the image can be taken as intact without reading it.
+ */
+bool boot_record_matches (uint8_t slot);
+
+/**
+ * @brief Store the boot-decision record of a slot whose image has just been validated.
+ * The SFLASH row is only written if the record changes.
+ * @slot Slot number: PMG1_FW_MODE_FWIMAGE_1 onwards.
+ */
+void boot_record_commit (uint8_t slot);
+
+/**
+ * @brief Drop the boot-decision record unless its slot is write protected. Called when
+ * flashing mode is entered, before any image row can change.
+ */
+void boot_record_revoke (void);
+
+/**
+ * @brief Check whether writing a flash row invalidates the boot-decision record: the row
+ * holds the metadata or part of the image of the recorded slot. Uses no RAM, so that the
+ * boot-loader services can call it on behalf of the application.
+ * @rowNum Flash row number.
+ * @return true if the record is valid and covers the row.
+ */
+bool boot_record_covers_row (uint16_t rowNum);
+#endif /* PMG1_BOOT_RECORD_ENABLE */
+
+#endif /* __BOOT_RECORD_H__ */
+
+/* [] END OF FILE */
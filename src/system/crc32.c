@@ -0,0 +1,86 @@
+/******************************************************************************
+* File Name: crc32.c
+*
+* Description: This source file implements the CRC-32C used to check firmware
+*              images. It has no device dependencies, so that host tools can
+*              build it as is.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "crc32.h"
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+/* A number of uint32_t elements in the CRC32 table.*/
+#define CRC_TABLE_SIZE                      (16U)
+#define NIBBLE_POS                          (4U)
+#define NIBBLE_MSK                          (0xFU)
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+uint32_t crc32_update(uint32_t crc, const uint8_t *address, uint32_t length)
+{
+    /* Contains generated values to calculate CRC-32C by 4 bits per iteration.
+    CRC-32C is computed based on the polynomial (0x1EDC6F41).*/
+    static const uint32_t crcTable[CRC_TABLE_SIZE] =
+    {
+        0x00000000U, 0x105ec76fU, 0x20bd8edeU, 0x30e349b1U,
+        0x417b1dbcU, 0x5125dad3U, 0x61c69362U, 0x7198540dU,
+        0x82f63b78U, 0x92a8fc17U, 0xa24bb5a6U, 0xb21572c9U,
+        0xc38d26c4U, 0xd3d3e1abU, 0xe330a81aU, 0xf36e6f75U,
+    };
+    if (length != 0U)
+    {
+        do
+        {
+            crc = crc ^ *address;
+            crc = (crc >> NIBBLE_POS) ^ crcTable[crc & NIBBLE_MSK];
+            crc = (crc >> NIBBLE_POS) ^ crcTable[crc & NIBBLE_MSK];
+            --length;
+            ++address;
+        } while (length != 0U);
+    }
+    return (crc);
+}
+
+uint32_t calculate_crc32(const uint8_t *address, uint32_t length)
+{
+    return (~crc32_update(CRC32_INIT, address, length));
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,78 @@
+/******************************************************************************
+* File Name: crc32.h
+*
+* Description: This header file defines the CRC-32C interface used to check
+*              firmware images.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __CRC32_H__
+#define __CRC32_H__
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+
+/* Initial value of a running CRC-32C.*/
+#define CRC32_INIT                          (0xFFFFFFFFU)
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+/**
+ * @brief Add data to a running CRC-32C. The CRC starts at CRC32_INIT and is
+ * inverted once complete.
+ * @crc Running CRC value.
+ * @address Data to be added.
+ * @length Length of the data in bytes.
+ * @return Updated CRC value.
+ */
+uint32_t crc32_update (uint32_t crc, const uint8_t *address, uint32_t length);
+
+/**
+ * @brief Compute the CRC-32C (polynomial 0x1EDC6F41) of a block of data.
+ * @address Data to be checked.
+ * @length Length of the data in bytes.
+ * @return CRC value, as stored in the fwCrc32 metadata field.
+ */
+uint32_t calculate_crc32 (const uint8_t *address, uint32_t length);
+
+#endif /* __CRC32_H__ */
+
+/* [] END OF FILE */
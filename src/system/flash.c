@@ -76,6 +76,24 @@
 /* CPUSS parameter size */
 #define FLASH_CPUSS_PARAM_SIZE                  (8u)
 
+/* Data area of the shared row buffer. It follows the SROM parameter words so
+ * that a row assembled in place can be handed to the SROM without a copy. */
+#define FLASH_ROW_BUF_DATA                      ((uint8_t *)(&glFlashRowBuf[FLASH_CPUSS_PARAM_SIZE / sizeof(uint32_t)]))
+
+/* End of the boot-loader image in flash, provided by the linker script: the load
+ * region limit for ARM, the end of the read-only block (which holds the initializers
+ * of the RAM data) for IAR, and the load end of .data for GCC.*/
+#if defined(__ARMCC_VERSION)
+extern uint8_t Load$$LR$$LR_ROM$$Limit[];
+#define FLASH_BL_IMAGE_END                      ((uint32_t)Load$$LR$$LR_ROM$$Limit)
+#elif defined(__ICCARM__)
+#pragma section = "RO"
+#define FLASH_BL_IMAGE_END                      ((uint32_t)__section_end("RO"))
+#else
+extern uint8_t __cy_bl_flash_end[];
+#define FLASH_BL_IMAGE_END                      ((uint32_t)__cy_bl_flash_end)
+#endif /* defined(__ARMCC_VERSION) */
+
 
 /*******************************************************************************
 * Global variables
@@ -95,49 +113,63 @@ static uint16_t glFlashMetadataRow = PMG1_LAST_FLASH_ROW_NUM + 1;
 /* Last boot loader flash row. Used for read protection.*/
 static uint16_t glFlashBlLastRow = PMG1_LAST_FLASH_ROW_NUM;
 
+/* Row buffer shared by all flash paths: SROM parameter words followed by one row of data.
+ * QAC suppression 0312: volatile qualifier is dropped where the buffer is handed to
+ * memory copy routines, which make sure that each byte is written. */
+static volatile uint32_t glFlashRowBuf[(CY_FLASH_SIZEOF_ROW + FLASH_CPUSS_PARAM_SIZE) / sizeof(uint32_t)];
+
+/* Current owner of the shared row buffer.*/
+static volatile flash_row_buf_owner_t glFlashRowBufOwner = FLASH_ROW_BUF_FREE;
+
+/* Row being assembled by flash_row_chunk_write(), and the offset of the next chunk.*/
+static uint16_t glFlashChunkRow;
+static uint16_t glFlashChunkNext;
+
+#if PMG1_FLASH_VERIFY_ENABLE
+/* Read back verification results since start-up.*/
+static flash_verify_stats_t glFlashVerifyStats;
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+
 
 /*******************************************************************************
 * Function definitions
 *******************************************************************************/
-/*
- * This function invokes the SROM API to do a flash row write.
- * This function is used instead of the CySysFlashWriteRow, so as to avoid
- * the clock trim updates that are done as part of that API.
+/**
+ * @brief Take ownership of the shared flash row buffer.
+ * @owner Identity of the caller.
+ * @return Pointer to the row sized data area, NULL if the buffer is owned by someone else.
  */
-static pmg1_status_t flash_trig_row_write(uint32_t row_num, uint8_t *data_p, bool is_sflash)
+uint8_t *flash_row_buf_acquire (flash_row_buf_owner_t owner)
 {
-    volatile uint32_t params[(CY_FLASH_SIZEOF_ROW+ FLASH_CPUSS_PARAM_SIZE) / sizeof(uint32_t)];
-    pmg1_status_t status = PMG1_STAT_SUCCESS;
-
-    uint8_t intmask = SYS_CALL_MAP(Cy_SysLib_EnterCriticalSection)();
-    uint32_t imosel = SRSSLT_CLK_IMO_SELECT;
-    uint32_t clksel = SRSSLT_CLK_SELECT;
-
+    uint8_t *bufP = NULL;
+    uint32_t intmask = SYS_CALL_MAP(Cy_SysLib_EnterCriticalSection)();
 
-    /* If the IMO/HFCLK frequency is not 48 MHz, we have to change the frequency. */
-    if ((imosel & SRSSLT_CLK_IMO_SELECT_FREQ_Msk) != 0x06)
+    if ((glFlashRowBufOwner == FLASH_ROW_BUF_FREE) || (glFlashRowBufOwner == owner))
     {
-        SRSSLT_CLK_IMO_SELECT = 0x06;
-        __NOP();
+        glFlashRowBufOwner = owner;
+        bufP = FLASH_ROW_BUF_DATA; /* PRQA S 0312 */
     }
 
-    if ((clksel & (SRSSLT_CLK_SELECT_HFCLK_SEL_Msk | SRSSLT_CLK_SELECT_HFCLK_DIV_Msk)) != 0x00)
+    SYS_CALL_MAP(Cy_SysLib_ExitCriticalSection)(intmask);
+    return bufP;
+}
+
+/**
+ * @brief Give up ownership of the shared flash row buffer.
+ * @owner Identity of the caller. The call is ignored if it does not own the buffer.
+ */
+void flash_row_buf_release (flash_row_buf_owner_t owner)
+{
+    if (glFlashRowBufOwner == owner)
     {
-        SRSSLT_CLK_SELECT &= ~(SRSSLT_CLK_SELECT_HFCLK_SEL_Msk | SRSSLT_CLK_SELECT_HFCLK_DIV_Msk);
-        __NOP();
+        glFlashRowBufOwner = FLASH_ROW_BUF_FREE;
     }
+}
 
-    /* Connect the charge pump to IMO clock for flash write. */
-#ifdef PAG1S
-    SRSS_CLK_SELECT = (SRSS_CLK_SELECT & ~SRSS_CLK_SELECT_PUMP_SEL_Msk) | (1 << SRSS_CLK_SELECT_PUMP_SEL_Pos);
-#else /* !PAG1S */
-    SRSSLT_CLK_SELECT = (SRSSLT_CLK_SELECT & ~SRSSLT_CLK_SELECT_PUMP_SEL_Msk) | (1u << SRSSLT_CLK_SELECT_PUMP_SEL_Pos);
-#endif /* PAG1S */
-
-    /* Copy the data into the parameter buffer. */
-    /* QAC suppression 0312: volatile qualifier for params[] is not mandatory as
-     * Cy_PdUtils_MemCopy never reads params[], and it makes sure that each byte is written. */
-    TIMER_CALL_MAP(Cy_PdUtils_MemCopy) ((uint8_t *)(&params[2]), (const uint8_t *)data_p, CY_FLASH_SIZEOF_ROW); /* PRQA S 0312 */
+/* Load the row latch from the parameter buffer and program the row.*/
+static pmg1_status_t flash_srom_row_program (volatile uint32_t *params, uint32_t row_num, bool is_sflash)
+{
+    pmg1_status_t status = PMG1_STAT_SUCCESS;
 
     /* Set the parameters for load data into latch operation. */
     params[0] = FLASH_PARAM_KEY_ONE |
@@ -193,6 +225,91 @@ static pmg1_status_t flash_trig_row_write(uint32_t row_num, uint8_t *data_p, boo
         status = PMG1_STAT_FAILURE;
     }
 
+
+    return status;
+}
+
+#if PMG1_FLASH_VERIFY_ENABLE
+/* Compare a flash row against the data it was programmed from, one word at a time.*/
+static bool flash_row_matches (uint32_t row_num, volatile uint32_t *data_p)
+{
+    const uint32_t *rowP = (const uint32_t *)(row_num << PMG1_FLASH_ROW_SHIFT_NUM);
+    uint32_t idx;
+
+    for (idx = 0; idx < (CY_FLASH_SIZEOF_ROW / sizeof (uint32_t)); idx++)
+    {
+        if (rowP[idx] != data_p[idx])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+
+/*
+ * Program a row from a parameter block holding the row data after the SROM parameter
+ * words, running the SROM with the clocks it needs. Touches no RAM other than the
+ * parameter block and the stack. The number of programming attempts that did not read
+ * back as written goes to mismatchesP.
+ */
+static pmg1_status_t flash_srom_row_write(volatile uint32_t *params, uint32_t row_num, bool is_sflash,
+                                          uint8_t *mismatchesP)
+{
+    pmg1_status_t status;
+#if PMG1_FLASH_VERIFY_ENABLE
+    uint8_t attempt;
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+
+    uint8_t intmask = SYS_CALL_MAP(Cy_SysLib_EnterCriticalSection)();
+    uint32_t imosel = SRSSLT_CLK_IMO_SELECT;
+    uint32_t clksel = SRSSLT_CLK_SELECT;
+
+    *mismatchesP = 0;
+
+    /* If the IMO/HFCLK frequency is not 48 MHz, we have to change the frequency. */
+    if ((imosel & SRSSLT_CLK_IMO_SELECT_FREQ_Msk) != 0x06)
+    {
+        SRSSLT_CLK_IMO_SELECT = 0x06;
+        __NOP();
+    }
+
+    if ((clksel & (SRSSLT_CLK_SELECT_HFCLK_SEL_Msk | SRSSLT_CLK_SELECT_HFCLK_DIV_Msk)) != 0x00)
+    {
+        SRSSLT_CLK_SELECT &= ~(SRSSLT_CLK_SELECT_HFCLK_SEL_Msk | SRSSLT_CLK_SELECT_HFCLK_DIV_Msk);
+        __NOP();
+    }
+
+    /* Connect the charge pump to IMO clock for flash write. */
+#ifdef PAG1S
+    SRSS_CLK_SELECT = (SRSS_CLK_SELECT & ~SRSS_CLK_SELECT_PUMP_SEL_Msk) | (1 << SRSS_CLK_SELECT_PUMP_SEL_Pos);
+#else /* !PAG1S */
+    SRSSLT_CLK_SELECT = (SRSSLT_CLK_SELECT & ~SRSSLT_CLK_SELECT_PUMP_SEL_Msk) | (1u << SRSSLT_CLK_SELECT_PUMP_SEL_Pos);
+#endif /* PAG1S */
+
+    status = flash_srom_row_program (params, row_num, is_sflash);
+
+#if PMG1_FLASH_VERIFY_ENABLE
+    /* Read the row back and program it again, from the data still held in the
+       parameter buffer, while it does not match.*/
+    attempt = 1;
+    while ((status == PMG1_STAT_SUCCESS) && (!is_sflash) && (!flash_row_matches (row_num, &params[2])))
+    {
+        (*mismatchesP)++;
+
+        if (attempt > PMG1_FLASH_VERIFY_RETRIES)
+        {
+            status = PMG1_STAT_FAILURE;
+        }
+        else
+        {
+            attempt++;
+            status = flash_srom_row_program (params, row_num, false);
+        }
+    }
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+
     /* Disconnect the clock to the charge pump after flash write is complete. */
 #ifdef PAG1S
     SRSSULT->clk_select = (SRSSULT->clk_select & ~CLK_SELECT_PUMP_SEL_MASK);
@@ -212,6 +329,78 @@ static pmg1_status_t flash_trig_row_write(uint32_t row_num, uint8_t *data_p, boo
     return status;
 }
 
+/*
+ * This function invokes the SROM API to do a flash row write.
+ * This function is used instead of the CySysFlashWriteRow, so as to avoid
+ * the clock trim updates that are done as part of that API.
+ */
+static pmg1_status_t flash_trig_row_write(uint32_t row_num, uint8_t *data_p, bool is_sflash)
+{
+    /* The caller owns the shared row buffer, which is used as the SROM parameter block.*/
+    volatile uint32_t *params = glFlashRowBuf;
+    pmg1_status_t status;
+    uint8_t mismatches;
+
+    /* Copy the data into the parameter buffer, unless it has been assembled there in place. */
+    /* QAC suppression 0312: volatile qualifier for params[] is not mandatory as
+     * Cy_PdUtils_MemCopy never reads params[], and it makes sure that each byte is written. */
+    if (data_p != FLASH_ROW_BUF_DATA) /* PRQA S 0312 */
+    {
+        TIMER_CALL_MAP(Cy_PdUtils_MemCopy) ((uint8_t *)(&params[2]), (const uint8_t *)data_p, CY_FLASH_SIZEOF_ROW); /* PRQA S 0312 */
+    }
+
+    status = flash_srom_row_write (params, row_num, is_sflash, &mismatches);
+
+#if PMG1_FLASH_VERIFY_ENABLE
+    if (mismatches != 0u)
+    {
+        glFlashVerifyStats.mismatches += mismatches;
+        glFlashVerifyStats.lastRow = (uint16_t)row_num;
+
+        /* The row is programmed once more after each mismatch, up to the retry limit.*/
+        if (mismatches > PMG1_FLASH_VERIFY_RETRIES)
+        {
+            glFlashVerifyStats.failedRows++;
+            glFlashVerifyStats.lastAttempts = PMG1_FLASH_VERIFY_RETRIES + 1u;
+        }
+        else
+        {
+            glFlashVerifyStats.lastAttempts = mismatches + 1u;
+        }
+    }
+#else
+    (void)mismatches;
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+
+    return status;
+}
+
+#if PMG1_BOOTLOAD_ENABLE
+/* Prepare a metadata row for writing: the boot sequence number becomes 1 + the highest
+   of the other slots, a new image starts on trial and verification records are only
+   created by the boot-loader. Other rows are left unchanged. Only flash and constant
+   data is read, so that flash_row_program() can use it as well.*/
+static void flash_md_row_scrub (uint16_t rowNum, uint8_t *row)
+{
+    uint8_t slot = boot_slot_from_md_row (rowNum);
+
+    if (slot == (uint8_t)PMG1_FW_MODE_INVALID)
+    {
+        return;
+    }
+
+    ((uint32_t *)row)[(PMG1_FLASH_ROW_SIZE - PMG1_FW_METADATA_SIZE + PMG1_FW_METADATA_BOOTSEQ_OFFSET) / 4] =
+        boot_get_next_boot_seq (slot);
+#if PMG1_TRIAL_BOOT_ENABLE
+    ((uint32_t *)row)[(PMG1_FLASH_ROW_SIZE - PMG1_FW_METADATA_SIZE + PMG1_FW_METADATA_CONFIRM_OFFSET) / 4] = 0;
+#endif /* PMG1_TRIAL_BOOT_ENABLE */
+#if PMG1_AUTH_BOOT_ENABLE
+    memset (&row[PMG1_FLASH_ROW_SIZE - PMG1_FW_METADATA_SIZE + PMG1_FW_METADATA_AUTH_OFFSET], 0,
+            PMG1_FW_METADATA_AUTH_SIZE);
+#endif /* PMG1_AUTH_BOOT_ENABLE */
+}
+#endif /* PMG1_BOOTLOAD_ENABLE */
+
 /**
  * @brief Write data in buffer to flash row at rowNum.
  * @buffer Buffer containing the data to be written to the flash row.
@@ -219,8 +408,11 @@ static pmg1_status_t flash_trig_row_write(uint32_t row_num, uint8_t *data_p, boo
  */
 pmg1_status_t flash_row_write ( uint8_t *buffer, uint16_t rowNum)
 {
+    pmg1_status_t status;
+#if !PMG1_BOOTLOAD_ENABLE
     uint32_t seqNum;
     uint16_t offset;
+#endif /* !PMG1_BOOTLOAD_ENABLE */
 
     /* Return device/stack not ready if flashing mode is disabled.*/
     if (!glFlashModeEn)
@@ -236,40 +428,43 @@ pmg1_status_t flash_row_write ( uint8_t *buffer, uint16_t rowNum)
         return PMG1_STAT_BAD_PARAM;
     }
 
-    /* Byte offset to the sequence number field in metadata.*/
-    offset  = (PMG1_FLASH_ROW_SIZE - PMG1_FW_METADATA_SIZE + PMG1_FW_METADATA_BOOTSEQ_OFFSET);
-
 #if PMG1_BOOTLOAD_ENABLE
-    if (rowNum == PMG1_FW1_METADATA_ROW)
+    /* Do not allow a valid golden image to be overwritten.*/
+    if (boot_slot_row_is_protected (rowNum))
     {
-        /* Set sequence number to 1 + that of FW2.*/
-        seqNum = boot_get_boot_seq (PMG1_FW_MODE_FWIMAGE_2) + 1;
-        ((uint32_t *)buffer)[offset / 4] = seqNum;
-    }
-    if (rowNum == PMG1_FW2_METADATA_ROW)
-    {
-        /* Set sequence number to 1 + that of FW1.*/
-        seqNum = boot_get_boot_seq (PMG1_FW_MODE_FWIMAGE_1) + 1;
-        ((uint32_t *)buffer)[offset / 4] = seqNum;
+        return PMG1_STAT_BAD_PARAM;
     }
+
+    flash_md_row_scrub (rowNum, buffer);
 #else
     /* Update the image boot sequence number value.*/
     if (rowNum == glFlashMetadataRow)
     {
-        /* Set the sequence number for the newly updated firmware image to 1 + seq no. of the other image.*/
-        if (glActiveFw == PMG1_FW_MODE_FWIMAGE_1)
-        {
-            seqNum = boot_get_boot_seq (PMG1_FW_MODE_FWIMAGE_1) + 1;
-        }
-        else
-        {
-            seqNum = boot_get_boot_seq (PMG1_FW_MODE_FWIMAGE_2) + 1;
-        }
+        /* Byte offset to the sequence number field in metadata.*/
+        offset  = (PMG1_FLASH_ROW_SIZE - PMG1_FW_METADATA_SIZE + PMG1_FW_METADATA_BOOTSEQ_OFFSET);
+
+        /* Set the sequence number for the newly updated firmware image to 1 + seq no. of the active image.*/
+        seqNum = boot_get_boot_seq ((uint8_t)glActiveFw) + 1;
         ((uint32_t *)buffer)[offset / 4] = seqNum;
     }
 #endif
 
-     return flash_trig_row_write(rowNum, buffer, false);
+    /* Data assembled in the shared row buffer is already owned by the caller. Otherwise,
+       borrow the buffer for the duration of the write.*/
+    if (buffer == FLASH_ROW_BUF_DATA) /* PRQA S 0312 */
+    {
+        return flash_trig_row_write(rowNum, buffer, false);
+    }
+
+    if (flash_row_buf_acquire (FLASH_ROW_BUF_OWNER_WRITE) == NULL)
+    {
+        return PMG1_STAT_BUSY;
+    }
+
+    status = flash_trig_row_write(rowNum, buffer, false);
+    flash_row_buf_release (FLASH_ROW_BUF_OWNER_WRITE);
+
+    return status;
 }
 
 /**
@@ -279,19 +474,48 @@ pmg1_status_t flash_row_write ( uint8_t *buffer, uint16_t rowNum)
  */
 int8_t flash_row_read (uint16_t rowNum, uint8_t *buffer)
 {
+    const uint8_t *src;
+    int8_t status;
+
+    if (buffer == 0)
+    {
+        return (int8_t)PMG1_STAT_BAD_PARAM;
+    }
+
+    status = flash_read ((uint32_t)rowNum << PMG1_FLASH_ROW_SHIFT_NUM, PMG1_FLASH_ROW_SIZE, &src);
+    if (status == (int8_t)PMG1_STAT_SUCCESS)
+    {
+        memcpy (buffer, src, PMG1_FLASH_ROW_SIZE);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Locate a span of flash for reading.
+ * @addr Flash address of the first byte.
+ * @length Number of bytes, up to PMG1_FLASH_READ_MAX_SIZE.
+ * @dataP Set to the location of the data.
+ */
+int8_t flash_read (uint32_t addr, uint16_t length, const uint8_t **dataP)
+{
+    const uint32_t flashEnd = (uint32_t)(PMG1_LAST_FLASH_ROW_NUM + 1) << PMG1_FLASH_ROW_SHIFT_NUM;
+
      /* Return device/stack not ready if flashing mode is disabled.*/
     if (!glFlashModeEn)
     {
         return (int8_t)PMG1_STAT_NOT_READY;
     }
 
-    /* We allow any row outside of the boot-loader to be read.*/
-    if ((buffer == 0) || (rowNum <= glFlashBlLastRow) || (rowNum > PMG1_LAST_FLASH_ROW_NUM))
+    /* We allow any span outside of the boot-loader to be read.*/
+    if ((dataP == 0) || (length == 0u) || (length > PMG1_FLASH_READ_MAX_SIZE) ||
+        (addr >= flashEnd) || (length > (flashEnd - addr)) ||
+        ((addr >> PMG1_FLASH_ROW_SHIFT_NUM) <= glFlashBlLastRow))
     {
         return (int8_t)PMG1_STAT_BAD_PARAM;
     }
 
-    memcpy (buffer, (void *)(rowNum << PMG1_FLASH_ROW_SHIFT_NUM), PMG1_FLASH_ROW_SIZE);
+    *dataP = (const uint8_t *)addr;
 
     return (int8_t)PMG1_STAT_SUCCESS;
 }
@@ -302,10 +526,223 @@ int8_t flash_row_read (uint16_t rowNum, uint8_t *buffer)
  */
 pmg1_status_t flash_row_clear (uint16_t rowNum)
 {
-    uint8_t buffer[PMG1_FLASH_ROW_SIZE] = {0};
-    return flash_row_write (buffer, rowNum);
+    pmg1_status_t status;
+    uint8_t *buffer = flash_row_buf_acquire (FLASH_ROW_BUF_OWNER_CLEAR);
+
+    if (buffer == NULL)
+    {
+        return PMG1_STAT_BUSY;
+    }
+
+    /* Zero the row in place so that it is programmed without another copy.*/
+    memset (buffer, 0, PMG1_FLASH_ROW_SIZE);
+    status = flash_row_write (buffer, rowNum);
+    flash_row_buf_release (FLASH_ROW_BUF_OWNER_CLEAR);
+
+    return status;
+}
+
+pmg1_status_t flash_row_chunk_write (uint16_t rowNum, uint16_t offset, const uint8_t *data, uint16_t length)
+{
+    pmg1_status_t status;
+    uint8_t *buffer;
+
+    if (!glFlashModeEn)
+    {
+        return PMG1_STAT_NOT_READY;
+    }
+
+    if ((data == NULL) || (length == 0u) || (offset >= PMG1_FLASH_ROW_SIZE) ||
+        (length > (PMG1_FLASH_ROW_SIZE - offset)))
+    {
+        return PMG1_STAT_BAD_PARAM;
+    }
+
+    if (offset == 0u)
+    {
+        /* Start a new row, dropping any row left incomplete.*/
+        buffer = flash_row_buf_acquire (FLASH_ROW_BUF_OWNER_CHUNK);
+        if (buffer == NULL)
+        {
+            return PMG1_STAT_BUSY;
+        }
+        glFlashChunkRow  = rowNum;
+        glFlashChunkNext = 0;
+    }
+    else
+    {
+        /* Chunks arrive in order. A chunk sent again after a lost response is refused:
+           the host restarts the row from offset 0.*/
+        if ((glFlashRowBufOwner != FLASH_ROW_BUF_OWNER_CHUNK) || (rowNum != glFlashChunkRow) ||
+            (offset != glFlashChunkNext))
+        {
+            return PMG1_STAT_BAD_PARAM;
+        }
+        buffer = FLASH_ROW_BUF_DATA; /* PRQA S 0312 */
+    }
+
+    memcpy (&buffer[offset], data, length);
+    glFlashChunkNext = offset + length;
+    if (glFlashChunkNext != PMG1_FLASH_ROW_SIZE)
+    {
+        return PMG1_STAT_SUCCESS;
+    }
+
+    /* Row complete: program it in place.*/
+    status = flash_row_write (buffer, rowNum);
+    flash_row_buf_release (FLASH_ROW_BUF_OWNER_CHUNK);
+
+    return status;
+}
+
+#ifdef PMG1_SFLASH_USER_ROW_BASE
+pmg1_status_t flash_sflash_row_write (uint8_t userRow, const uint8_t *data, uint16_t length)
+{
+    pmg1_status_t status;
+    uint8_t *buffer;
+
+    if ((userRow >= PMG1_SFLASH_USER_ROW_COUNT) || (length > PMG1_FLASH_ROW_SIZE))
+    {
+        return PMG1_STAT_BAD_PARAM;
+    }
+
+    buffer = flash_row_buf_acquire (FLASH_ROW_BUF_OWNER_SFLASH);
+    if (buffer == NULL)
+    {
+        return PMG1_STAT_BUSY;
+    }
+
+    memset (buffer, 0, PMG1_FLASH_ROW_SIZE);
+    if (data != NULL)
+    {
+        memcpy (buffer, data, length);
+    }
+
+    /* The SROM request takes the user row number. The row is not verified by
+       flash_trig_row_write(): compare it here, without a retry.*/
+    status = flash_trig_row_write (userRow, buffer, true);
+    if ((status == PMG1_STAT_SUCCESS) &&
+        (memcmp ((const void *)PMG1_SFLASH_USER_ROW_ADDR (userRow), buffer, PMG1_FLASH_ROW_SIZE) != 0))
+    {
+        status = PMG1_STAT_FAILURE;
+    }
+    flash_row_buf_release (FLASH_ROW_BUF_OWNER_SFLASH);
+
+    return status;
+}
+#endif /* PMG1_SFLASH_USER_ROW_BASE */
+
+pmg1_status_t flash_row_program (uint16_t rowNum, const uint8_t *data, uint32_t *workBuf, bool isSflash)
+{
+    uint8_t *rowP = (uint8_t *)(&workBuf[FLASH_CPUSS_PARAM_SIZE / sizeof (uint32_t)]);
+    const void *flashP;
+    pmg1_status_t status;
+    uint8_t mismatches;
+
+    if (workBuf == NULL)
+    {
+        return PMG1_STAT_BAD_PARAM;
+    }
+
+    if (isSflash)
+    {
+#ifdef PMG1_SFLASH_USER_ROW_BASE
+        if (rowNum >= PMG1_SFLASH_USER_ROW_COUNT)
+        {
+            return PMG1_STAT_BAD_PARAM;
+        }
+        flashP = (const void *)PMG1_SFLASH_USER_ROW_ADDR (rowNum);
+#else
+        return PMG1_STAT_BAD_PARAM;
+#endif /* PMG1_SFLASH_USER_ROW_BASE */
+    }
+    else
+    {
+        if ((rowNum <= flash_get_bl_last_row ()) || (rowNum > PMG1_LAST_FLASH_ROW_NUM))
+        {
+            return PMG1_STAT_BAD_PARAM;
+        }
+        flashP = (const void *)((uint32_t)rowNum << PMG1_FLASH_ROW_SHIFT_NUM);
+    }
+
+    if (data != NULL)
+    {
+        memcpy (rowP, data, PMG1_FLASH_ROW_SIZE);
+#if PMG1_BOOTLOAD_ENABLE
+        /* Metadata rows get the same treatment as over HPI.*/
+        if (!isSflash)
+        {
+            flash_md_row_scrub (rowNum, rowP);
+        }
+#endif /* PMG1_BOOTLOAD_ENABLE */
+    }
+    else
+    {
+        memset (rowP, 0, PMG1_FLASH_ROW_SIZE);
+    }
+
+    /* Read the row back in either case: flash_srom_row_write() only retries main flash rows.*/
+    status = flash_srom_row_write (workBuf, rowNum, isSflash, &mismatches);
+    if ((status == PMG1_STAT_SUCCESS) && (memcmp (flashP, rowP, PMG1_FLASH_ROW_SIZE) != 0))
+    {
+        status = PMG1_STAT_FAILURE;
+    }
+
+    return status;
 }
 
+/**
+ * @brief Update part of a flash row, keeping the rest of its contents.
+ * @rowNum Row number to be updated.
+ * @offset Byte offset of the data within the row.
+ * @data New data, NULL to clear the range.
+ * @length Length of the data in bytes.
+ */
+pmg1_status_t flash_row_patch (uint16_t rowNum, uint16_t offset, const uint8_t *data, uint16_t length)
+{
+    pmg1_status_t status;
+    uint8_t *buffer;
+
+    if ((rowNum <= flash_get_bl_last_row ()) || (rowNum > PMG1_LAST_FLASH_ROW_NUM) ||
+        (((uint32_t)offset + length) > PMG1_FLASH_ROW_SIZE))
+    {
+        return PMG1_STAT_BAD_PARAM;
+    }
+
+    buffer = flash_row_buf_acquire (FLASH_ROW_BUF_OWNER_PATCH);
+    if (buffer == NULL)
+    {
+        return PMG1_STAT_BUSY;
+    }
+
+    /* Assemble the row in place: current contents with the new data on top.*/
+    memcpy (buffer, (void *)((uint32_t)rowNum << PMG1_FLASH_ROW_SHIFT_NUM), PMG1_FLASH_ROW_SIZE);
+    if (data != NULL)
+    {
+        memcpy (&buffer[offset], data, length);
+    }
+    else
+    {
+        memset (&buffer[offset], 0, length);
+    }
+
+    status = flash_trig_row_write (rowNum, buffer, false);
+    flash_row_buf_release (FLASH_ROW_BUF_OWNER_PATCH);
+
+    return status;
+}
+
+#if PMG1_FLASH_VERIFY_ENABLE
+/**
+ * @brief Get the read back verification results.
+ * @statsP Structure to be filled in.
+ */
+void flash_get_verify_stats (flash_verify_stats_t *statsP)
+{
+    *statsP = glFlashVerifyStats;
+}
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+
 /**
  * @brief Check whether flashing mode has been entered.
  */
@@ -320,6 +757,8 @@ bool flash_access_get_status (uint8_t modes)
  */
 void flash_enter_mode (bool enable)
 {
+    /* A row assembled from chunks does not outlive the flashing session.*/
+    flash_row_buf_release (FLASH_ROW_BUF_OWNER_CHUNK);
     glFlashModeEn = enable;
 }
 
@@ -354,4 +793,9 @@ void flash_set_access_limits ( uint16_t startRow, uint16_t lastRow,
     glFlashBlLastRow = blLastRow;
 }
 
+uint16_t flash_get_bl_last_row (void)
+{
+    return (uint16_t)((FLASH_BL_IMAGE_END - 1u) >> PMG1_FLASH_ROW_SHIFT_NUM);
+}
+
 /* END OF FILE */
@@ -52,9 +52,10 @@
 *******************************************************************************/
 
 /** PMG1 FLASH OPTIONS **/
-/* Only the boot-loader last row and the configuration table size is expected
- * to change to match the project requirement. With a fixed boot-loader, none
- * of this fields should be modified.
+/* Only the configuration table size is expected to change to match the project
+ * requirement. With a fixed boot-loader, none of this fields should be modified.
+ * The boot-loader last row follows from the linked image, see
+ * flash_get_bl_last_row().
  */
 
 /**  Flash row size for DEVICE_MODE register
@@ -77,6 +78,25 @@
 #define PMG1_FLASH_ROW_SIZE_DEV_MODE_VAL    (1u)
 #endif /* CY_FLASH_SIZEOF_ROW */
 
+/* Read back every programmed row and compare it with the source data. A row that
+ * does not match is programmed again, up to PMG1_FLASH_VERIFY_RETRIES times, before
+ * the write is reported as failed.
+ */
+#ifndef PMG1_FLASH_VERIFY_ENABLE
+#define PMG1_FLASH_VERIFY_ENABLE            (1u)
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+
+#ifndef PMG1_FLASH_VERIFY_RETRIES
+#define PMG1_FLASH_VERIFY_RETRIES           (2u)
+#endif /* PMG1_FLASH_VERIFY_RETRIES */
+
+/* Largest span returned by one flash_read() call. A span may cross row boundaries.
+ * The HPI flash read command takes at most HPI_EXT_FLASH_READ_MAX bytes of it.
+ */
+#ifndef PMG1_FLASH_READ_MAX_SIZE
+#define PMG1_FLASH_READ_MAX_SIZE            (256u)
+#endif /* PMG1_FLASH_READ_MAX_SIZE */
+
 /* Total size of device flash. */
 #define PMG1_FLASH_SIZE                     (CY_FLASH_SIZE)
 
@@ -89,9 +109,81 @@
 /* Flash row size. This depends on the device type.*/
 #define PMG1_FLASH_ROW_SIZE                 (CY_FLASH_SIZEOF_ROW)
 
+/* Flash macros: the rows are numbered across the macros, each macro holding the same
+ * number of rows.*/
+#ifdef CPUSS_SPCIF_FLASH_MACROS
+#define PMG1_FLASH_MACRO_COUNT              (CPUSS_SPCIF_FLASH_MACROS)
+#else
+#define PMG1_FLASH_MACRO_COUNT              (1u)
+#endif /* CPUSS_SPCIF_FLASH_MACROS */
+#define PMG1_FLASH_MACRO_ROWS               (CY_FLASH_NUMBER_ROWS / PMG1_FLASH_MACRO_COUNT)
+
+/* Flash macro holding row n.*/
+#define PMG1_FLASH_MACRO_FROM_ROW(n)        ((uint32_t)(n) / PMG1_FLASH_MACRO_ROWS)
+
+/* SFLASH user rows: number of rows. They are written through the SROM WriteUserSFlash
+ * request, one whole row at a time. The address of user row 0 is not part of the PDL
+ * device headers: PMG1_SFLASH_USER_ROW_BASE has to be defined from the device TRM
+ * (DEFINES in the Makefile) for the user rows to be used.
+ */
+#define PMG1_SFLASH_USER_ROW_COUNT          (4u)
+
+#ifdef PMG1_SFLASH_USER_ROW_BASE
+/* Address of SFLASH user row n.*/
+#define PMG1_SFLASH_USER_ROW_ADDR(n)        (PMG1_SFLASH_USER_ROW_BASE + ((uint32_t)(n) << PMG1_FLASH_ROW_SHIFT_NUM))
+#endif /* PMG1_SFLASH_USER_ROW_BASE */
+
+/* Size in words of the buffer passed to flash_row_program(): the SROM parameter words
+ * followed by one row of data.*/
+#define PMG1_FLASH_PROGRAM_BUF_WORDS        ((PMG1_FLASH_ROW_SIZE + 8u) / sizeof (uint32_t))
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/**
+ * @typedef flash_row_buf_owner_t
+ * @brief Owners of the shared flash row buffer.
+ */
+typedef enum
+{
+    FLASH_ROW_BUF_FREE = 0,         /**< Buffer is not in use. */
+    FLASH_ROW_BUF_OWNER_WRITE,      /**< Row write from a caller supplied buffer. */
+    FLASH_ROW_BUF_OWNER_CLEAR,      /**< Row clear. */
+    FLASH_ROW_BUF_OWNER_PATCH,      /**< Read-modify-write of part of a row. */
+    FLASH_ROW_BUF_OWNER_SFLASH,     /**< SFLASH user row write. */
+    FLASH_ROW_BUF_OWNER_CHUNK       /**< Row assembled from chunks sent by the host. */
+} flash_row_buf_owner_t;
+
+/**
+ * @typedef flash_verify_stats_t
+ * @brief Read back verification results reported through the HPI_EXT_REG_FLASH_VERIFY register.
+ */
+typedef struct __attribute__((__packed__))
+{
+    uint16_t mismatches;            /**< Offset 00: Programming attempts that did not read back as written. */
+    uint16_t failedRows;            /**< Offset 02: Rows still not matching after all retries. */
+    uint16_t lastRow;               /**< Offset 04: Last row that did not read back as written. */
+    uint16_t lastAttempts;          /**< Offset 06: Number of times that row was programmed. */
+} flash_verify_stats_t;
+
 /*******************************************************************************
 * Function definitions
 *******************************************************************************/
+/**
+ * @brief Take ownership of the shared flash row buffer. A row assembled in this
+ * buffer is programmed by flash_row_write() without being copied again.
+ * @owner Identity of the caller.
+ * @return Pointer to the row sized data area, NULL if the buffer is owned by someone else.
+ */
+uint8_t *flash_row_buf_acquire (flash_row_buf_owner_t owner);
+
+/**
+ * @brief Give up ownership of the shared flash row buffer.
+ * @owner Identity of the caller.
+ */
+void flash_row_buf_release (flash_row_buf_owner_t owner);
+
 /**
  * @brief Write data in buffer to flash row at rowNum.
  * @buffer Buffer containing the data to be written to the flash row.
@@ -106,12 +198,87 @@ pmg1_status_t flash_row_write (uint8_t *buffer, uint16_t rowNum);
  */
 int8_t flash_row_read (uint16_t rowNum, uint8_t *buffer);
 
+/**
+ * @brief Locate a span of flash for reading. The data is not copied: the caller reads
+ * it straight from flash. The span may cover several rows, all above the boot-loader.
+ * @addr Flash address of the first byte.
+ * @length Number of bytes, up to PMG1_FLASH_READ_MAX_SIZE.
+ * @dataP Set to the location of the data.
+ */
+int8_t flash_read (uint32_t addr, uint16_t length, const uint8_t **dataP);
+
 /**
  * @brief Clear the flash roe at rowNum
  * @rowNum Flash row number to be cleared
  */
 pmg1_status_t flash_row_clear (uint16_t rowNum);
 
+/**
+ * @brief Update part of a flash row, keeping the rest of its contents. This is meant
+ * for records maintained by the boot-loader itself: flashing mode and the access limits
+ * set for the HPI flash commands are not checked. Boot-loader rows cannot be updated.
+ * @rowNum Row number to be updated.
+ * @offset Byte offset of the data within the row.
+ * @data New data, NULL to clear the range.
+ * @length Length of the data in bytes.
+ */
+pmg1_status_t flash_row_patch (uint16_t rowNum, uint16_t offset, const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Add a chunk to the row being assembled in the shared row buffer. A chunk at
+ * offset 0 starts a new row; the following ones have to continue where the previous
+ * chunk ended. The row is programmed through flash_row_write() with the chunk that
+ * completes it. Leaving or entering flashing mode drops an incomplete row.
+ * @rowNum Row number to be updated.
+ * @offset Byte offset of the chunk within the row.
+ * @data Chunk data.
+ * @length Length of the chunk in bytes.
+ * @return PMG1_STAT_SUCCESS if the chunk was taken, or the row was programmed with it.
+ * PMG1_STAT_BUSY if the row buffer is in use, PMG1_STAT_NOT_READY outside flashing mode,
+ * PMG1_STAT_BAD_PARAM for a chunk that does not continue the row. Otherwise, the status of
+ * flash_row_write().
+ */
+pmg1_status_t flash_row_chunk_write (uint16_t rowNum, uint16_t offset, const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Write an SFLASH user row. The data is padded with zeros to a whole row and
+ * read back once programmed. Flashing mode is not required.
+ * @userRow SFLASH user row number: 0 to PMG1_SFLASH_USER_ROW_COUNT - 1.
+ * @data Data to be written, NULL to clear the row.
+ * @length Length of the data in bytes, up to PMG1_FLASH_ROW_SIZE.
+ * @return PMG1_STAT_SUCCESS if the row holds the data, PMG1_STAT_BUSY if the row buffer
+ * is in use, PMG1_STAT_BAD_PARAM or PMG1_STAT_FAILURE otherwise.
+ */
+#ifdef PMG1_SFLASH_USER_ROW_BASE
+pmg1_status_t flash_sflash_row_write (uint8_t userRow, const uint8_t *data, uint16_t length);
+#endif /* PMG1_SFLASH_USER_ROW_BASE */
+
+/**
+ * @brief Program a main flash row or an SFLASH user row through a caller supplied SROM
+ * buffer. Apart from that buffer and the stack, no RAM is used, so that the application
+ * can call it through the boot-loader service table. Flashing mode and the access limits
+ * of the HPI flash commands are not checked; boot-loader rows cannot be written. A
+ * metadata row is prepared as flash_row_write() does: the boot sequence number is set,
+ * the trial confirmation and the verification record are cleared.
+ * @rowNum Main flash row number, or SFLASH user row number if isSflash is set.
+ * @data One row of data, NULL to clear the row.
+ * @workBuf Buffer of PMG1_FLASH_PROGRAM_BUF_WORDS words.
+ * @isSflash Whether rowNum is an SFLASH user row.
+ * @return PMG1_STAT_SUCCESS if the row holds the data, PMG1_STAT_BAD_PARAM or
+ * PMG1_STAT_FAILURE otherwise.
+ */
+pmg1_status_t flash_row_program (uint16_t rowNum, const uint8_t *data, uint32_t *workBuf, bool isSflash);
+
+#if PMG1_FLASH_VERIFY_ENABLE
+/**
+ * @brief Get the read back verification results. Each programmed row is compared
+ * against its source data and programmed again, up to PMG1_FLASH_VERIFY_RETRIES
+ * times, while it does not match.
+ * @statsP Structure to be filled in.
+ */
+void flash_get_verify_stats (flash_verify_stats_t *statsP);
+#endif /* PMG1_FLASH_VERIFY_ENABLE */
+
 /**
  * @brief Check whether flashing mode has been entered.
  */
@@ -139,6 +306,13 @@ bool flash_access_enabled (void);
 void flash_set_access_limits (uint16_t startRow, uint16_t lastRow,
                               uint16_t mdRow, uint16_t blLastRow);
 
+/**
+ * @brief Get the last boot-loader row: the row holding the last byte of the boot-loader
+ * image, as placed by the linker. The rows above it are left to the firmware application.
+ * @return Last boot-loader row number.
+ */
+uint16_t flash_get_bl_last_row (void);
+
 #endif /* __FLASH_H__ */
 
 /* [] END OF FILE */
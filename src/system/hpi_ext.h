@@ -0,0 +1,133 @@
+/******************************************************************************
+* File Name: hpi_ext.h
+*
+* Description: This header file defines the bootloader specific HPI registers
+*              of the PMG1 MCU I2C BOOTLOADER Example for ModusToolBox.
+*              It is shared with the host tools and must only contain
+*              plain C definitions.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __HPI_EXT_H__
+#define __HPI_EXT_H__
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+
+/* Start of the bootloader specific registers in the HPI device register space.
+ * Status registers are read only from the host side and are refreshed by the
+ * bootloader whenever the underlying value changes. Command registers are written
+ * by the host and complete with an HPI response.
+ */
+#define HPI_EXT_REG_BASE                    (0x80u)
+
+/* Memory usage summary: mem_stats_t.*/
+#define HPI_EXT_REG_MEM_STATS               (HPI_EXT_REG_BASE + 0x00u)
+#define HPI_EXT_REG_MEM_STATS_SIZE          (8u)
+
+/* Flash read back verification results: flash_verify_stats_t.*/
+#define HPI_EXT_REG_FLASH_VERIFY            (HPI_EXT_REG_BASE + 0x08u)
+#define HPI_EXT_REG_FLASH_VERIFY_SIZE       (8u)
+
+/* Flash read command. Reads up to HPI_EXT_FLASH_READ_MAX bytes from any flash address
+ * above the boot-loader into the HPI flash memory region, and completes with the
+ * FLASH_DATA_AVAILABLE response. Flashing mode has to be enabled.
+ *   Offset 0: HPI_EXT_FLASH_READ_SIG
+ *   Offset 1: Reserved
+ *   Offset 2: Length in bytes, little endian
+ *   Offset 4: Flash address of the first byte, little endian
+ */
+#define HPI_EXT_REG_FLASH_READ              (HPI_EXT_REG_BASE + 0x10u)
+#define HPI_EXT_REG_FLASH_READ_SIZE         (8u)
+#define HPI_EXT_FLASH_READ_SIG              (0x52u)
+
+/* Largest span of one flash read command. The span is copied into the flash memory region
+ * with Cy_Hpi_UpdateRegs(), which takes an 8-bit length, and the region holds one flash
+ * row: 128 bytes on the smallest row size.*/
+#define HPI_EXT_FLASH_READ_MAX              (128u)
+
+/* Low power idle statistics: bl_sleep_stats_t, with SYS_DEEPSLEEP_ENABLE.
+ *   Offset 0: Number of deep sleep entries, little endian
+ *   Offset 2: Number of deep sleeps ended by an HPI address match, little endian
+ *   Offset 4: Last wake-to-ACK time in microseconds, little endian
+ *   Offset 6: Largest wake-to-ACK time in microseconds, little endian
+ * The wake-to-ACK time runs from the CPU resuming to the end of the HPI interrupt
+ * that acknowledged the address. The deep sleep wake-up of the device comes on top.
+ */
+#define HPI_EXT_REG_SLEEP_STATS             (HPI_EXT_REG_BASE + 0x18u)
+#define HPI_EXT_REG_SLEEP_STATS_SIZE        (8u)
+
+/* Flash chunk write command. Adds a chunk to the row being assembled in the boot-loader,
+ * so that hosts limited to short transfers need not hold a whole row. The chunk at
+ * offset 0 starts a row; the following ones continue where the previous chunk ended.
+ * The chunk that completes the row has it programmed, and its response is sent once the
+ * row is written. A refused chunk leaves the host to restart the row at offset 0.
+ * Flashing mode has to be enabled.
+ *   Offset 0: HPI_EXT_FLASH_CHUNK_SIG
+ *   Offset 1: Chunk length in bytes, up to HPI_EXT_FLASH_CHUNK_MAX
+ *   Offset 2: Row number, little endian
+ *   Offset 4: Byte offset of the chunk in the row, little endian
+ *   Offset 6: Chunk data
+ * A maximum chunk fits a 64-byte I2C write along with the register address.
+ */
+#define HPI_EXT_REG_FLASH_CHUNK             (HPI_EXT_REG_BASE + 0x20u)
+#define HPI_EXT_FLASH_CHUNK_HDR_SIZE        (6u)
+#define HPI_EXT_FLASH_CHUNK_MAX             (56u)
+#define HPI_EXT_FLASH_CHUNK_SIG             (0x43u)
+
+/* HPI flash memory region: data of the flash row and flash read commands.*/
+#define HPI_EXT_FLASH_MEM_ADDR              (0x0200u)
+
+/* Boot-loader events, queued with Cy_Hpi_RegEnqueueEvent() like the RESET_COMPLETE event:
+ * the code is read from the response register, the data from the data region behind it.
+ * The codes lie above the ones used by the HPI middleware. The command responses need no
+ * event of their own, as each of them raises the EC interrupt once the command is done.*/
+#define HPI_EXT_EVENT_BASE                  (0xF0u)
+
+/* Image check complete, with PMG1_BOOT_CHECK_EVENT_ENABLE: the background image check has
+ * gone through all slots and the firmware location and version registers are up to date.
+ * Not raised if entering flashing mode completed the check, so that the event cannot be
+ * taken for the response to a flashing command.
+ *   Offset 0: Boot mode reason, as in the BOOT_MODE_REASON register
+ *   Offset 1: Slot states: BOOT_HANDOFF_SLOT_XXX, 2 bits per slot, slot 1 lowest
+ */
+#define HPI_EXT_EVENT_CHECK_DONE            (HPI_EXT_EVENT_BASE + 0x00u)
+#define HPI_EXT_EVENT_CHECK_DONE_SIZE       (2u)
+
+#endif /* __HPI_EXT_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,112 @@
+/******************************************************************************
+* File Name: mem_stats.c
+*
+* Description: Stack painting, high-water mark scan and RAM usage
+*              summary for the PMG1 MCU.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "mem_stats.h"
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+/* Words left unpainted below the stack pointer of the painting function.*/
+#define MEM_STATS_PAINT_GUARD               (8u)
+
+/* Stack and static data boundaries provided by the linker script.*/
+#if defined(__ARMCC_VERSION)
+extern uint32_t Image$$ARM_LIB_STACK$$ZI$$Base[];
+extern uint32_t Image$$ARM_LIB_STACK$$ZI$$Limit[];
+extern uint32_t Image$$RW_IRAM1$$ZI$$Limit[];
+#define MEM_STATS_STACK_LIMIT               ((uint32_t *)Image$$ARM_LIB_STACK$$ZI$$Base)
+#define MEM_STATS_STACK_TOP                 ((uint32_t *)Image$$ARM_LIB_STACK$$ZI$$Limit)
+#define MEM_STATS_STATIC_END                ((uint32_t)Image$$RW_IRAM1$$ZI$$Limit)
+#elif defined(__ICCARM__)
+#pragma section = "CSTACK"
+#pragma section = "HEAP"
+#define MEM_STATS_STACK_LIMIT               ((uint32_t *)__section_begin("CSTACK"))
+#define MEM_STATS_STACK_TOP                 ((uint32_t *)__section_end("CSTACK"))
+#define MEM_STATS_STATIC_END                ((uint32_t)__section_begin("HEAP"))
+#else
+extern uint32_t __StackLimit[];
+extern uint32_t __StackTop[];
+extern uint32_t __bss_end__[];
+#define MEM_STATS_STACK_LIMIT               ((uint32_t *)__StackLimit)
+#define MEM_STATS_STACK_TOP                 ((uint32_t *)__StackTop)
+#define MEM_STATS_STATIC_END                ((uint32_t)__bss_end__)
+#endif /* defined(__ARMCC_VERSION) */
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+void mem_stats_paint_stack (void)
+{
+    uint32_t *wordP = MEM_STATS_STACK_LIMIT;
+    uint32_t *endP  = (uint32_t *)__get_MSP() - MEM_STATS_PAINT_GUARD;
+
+    while (wordP < endP)
+    {
+        *wordP = MEM_STATS_PAINT_PATTERN;
+        wordP++;
+    }
+}
+
+uint16_t mem_stats_stack_used (const uint32_t *limitP, const uint32_t *topP)
+{
+    const uint32_t *wordP = limitP;
+
+    /* The stack grows downwards: the first overwritten word marks the deepest point.*/
+    while ((wordP < topP) && (*wordP == MEM_STATS_PAINT_PATTERN))
+    {
+        wordP++;
+    }
+
+    return ((uint16_t)((uint32_t)(topP - wordP) * sizeof(uint32_t)));
+}
+
+void mem_stats_get (mem_stats_t *statsP)
+{
+    uint32_t ramStart = CY_SRAM_BASE;
+
+    statsP->ramSize    = (uint16_t)((uint32_t)MEM_STATS_STACK_TOP - ramStart);
+    statsP->staticSize = (uint16_t)(MEM_STATS_STATIC_END - ramStart);
+    statsP->stackSize  = (uint16_t)((uint32_t)MEM_STATS_STACK_TOP - (uint32_t)MEM_STATS_STACK_LIMIT);
+    statsP->stackPeak  = mem_stats_stack_used (MEM_STATS_STACK_LIMIT, MEM_STATS_STACK_TOP);
+}
+
+/* [] END OF FILE */
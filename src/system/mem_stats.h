@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name: mem_stats.h
+*
+* Description: This header file defines the stack and RAM usage
+*              instrumentation for the PMG1 MCU.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __MEM_STATS_H__
+#define __MEM_STATS_H__
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+
+/* Pattern written to the unused stack at start-up.*/
+#define MEM_STATS_PAINT_PATTERN             (0xC5C5C5C5u)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/**
+ * @typedef mem_stats_t
+ * @brief RAM usage summary reported through the HPI_EXT_REG_MEM_STATS register.
+ */
+typedef struct __attribute__((__packed__))
+{
+    uint16_t ramSize;               /**< Offset 00: Total RAM size in bytes. */
+    uint16_t staticSize;            /**< Offset 02: RAM used by data, bss and shared sections. */
+    uint16_t stackSize;             /**< Offset 04: Stack size reserved by the linker script. */
+    uint16_t stackPeak;             /**< Offset 06: Deepest stack usage seen since start-up. */
+} mem_stats_t;
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+/**
+ * @brief Fill the unused part of the stack with MEM_STATS_PAINT_PATTERN.
+ * Must be called first thing in main().
+ */
+void mem_stats_paint_stack (void);
+
+/**
+ * @brief Get the number of stack bytes that have been used.
+ * @limitP Lowest address of the stack.
+ * @topP Address just above the stack.
+ * @return Stack high-water mark in bytes.
+ */
+uint16_t mem_stats_stack_used (const uint32_t *limitP, const uint32_t *topP);
+
+/**
+ * @brief Scan the stack and fill the RAM usage summary.
+ * @statsP Summary to be filled.
+ */
+void mem_stats_get (mem_stats_t *statsP);
+
+#endif /* __MEM_STATS_H__ */
+
+/* [] END OF FILE */
@@ -41,6 +41,7 @@
 
 
 #include "cycfg.h"
+#include "config.h"
 #include "pmg1_bsp.h"
 #include "cycfg_system.h"
 #include "system_cat2.h"
@@ -51,7 +52,7 @@
 #define CY_CFG_SYSCLK_CLKSYS_DIVIDER     CY_SYSCLK_NO_DIV
 
 #define CY_CFG_SYSCLK_FREQ_SCALER        (1000000UL)
-#define CY_CFG_IMO_LOC_FREQ              (((uint32_t)CY_CFG_SYSCLK_IMO_FREQ - \
+#define CY_CFG_IMO_LOC_FREQ(freq)        (((uint32_t)(freq) - \
                                          (uint32_t)CY_SYSCLK_IMO_24MHZ) / \
                                           CY_CFG_SYSCLK_FREQ_SCALER)
 
@@ -59,20 +60,92 @@
 #define CY_DELAY_1K_THRESHOLD            (1000u)
 #define CY_DELAY_1M_THRESHOLD            (1000000u)
 
-#define CY_DELAY_FREQ_KHZ                (CY_SYSLIB_DIV_ROUNDUP(CY_CLK_SYSTEM_FREQ_HZ,\
-                                          CY_DELAY_1K_THRESHOLD))
+#if ((CY_CLK_SYSTEM_FREQ_HZ < 24000000UL) || (CY_CLK_SYSTEM_FREQ_HZ > PMG1_CLK_TURBO_FREQ_HZ) || \
+     ((CY_CLK_SYSTEM_FREQ_HZ % 4000000UL) != 0UL))
+#error "CY_CLK_SYSTEM_FREQ_HZ has to be an IMO frequency: 24 to 48 MHz in 4 MHz steps."
+#endif
 
-#define CY_DELAY_FREQ_MHZ                ((uint8_t)CY_SYSLIB_DIV_ROUNDUP(CY_CLK_SYSTEM_FREQ_HZ, \
-                                          CY_DELAY_1M_THRESHOLD))
+/* Current clock profile.*/
+static pmg1_clk_profile_t glClkProfile = PMG1_CLK_PROFILE_NOMINAL;
 
-#define CY_DELAY_FREQ_32KMS              (CY_DELAY_MS_OVERFLOW_THRESHOLD * \
-                                          CY_SYSLIB_DIV_ROUNDUP(CY_CLK_SYSTEM_FREQ_HZ,\
-                                          CY_DELAY_1K_THRESHOLD))
+#if (CY_CLK_SYSTEM_FREQ_HZ < PMG1_CLK_TURBO_FREQ_HZ)
+#if (PMG1_CLK_TURBO_ENABLE && PMG1_UART_TRANSPORT_ENABLE && !defined(CLK_BL_UART_HW))
+#error "PMG1_CLK_TURBO_ENABLE with the UART transport needs the clock divider of BL_UART named CLK_BL_UART."
+#endif
 
-static void Set_ImoFrequency(void)
+/* Clock divider of an SCB that keeps running under the turbo profile.*/
+typedef struct
+{
+    cy_en_divider_types_t type;
+    uint32_t num;
+} pmg1_scb_clk_t;
+
+/* Clock dividers of the HPI and UART SCBs, as named in the device configurator.*/
+static const pmg1_scb_clk_t glScbClk[] =
+{
+    {CLK_I2C_SLAVE_HW, CLK_I2C_SLAVE_NUM},
+#if (PMG1_CLK_TURBO_ENABLE && PMG1_UART_TRANSPORT_ENABLE)
+    {CLK_BL_UART_HW, CLK_BL_UART_NUM},
+#endif /* (PMG1_CLK_TURBO_ENABLE && PMG1_UART_TRANSPORT_ENABLE) */
+};
+
+#define PMG1_SCB_CLK_COUNT               (sizeof (glScbClk) / sizeof (glScbClk[0]))
+
+/* Divider values set up for the nominal clock, kept while the turbo profile is active.*/
+static uint32_t glScbClkNominal[PMG1_SCB_CLK_COUNT];
+
+/* Whether the SCB clocks have been set up, and whether they are scaled for the turbo clock.*/
+static bool glScbClkOn = false;
+static bool glScbClkScaled = false;
+
+/* Work out the SCB divider values that give the nominal SCB clocks at the turbo clock.
+ * Fails if a divider cannot be scaled exactly, in which case the clock has to stay.*/
+static bool pmg1_scb_clk_turbo_div(uint32_t *turboDiv)
+{
+    uint32_t i;
+    uint32_t div;
+
+    for (i = 0; i < PMG1_SCB_CLK_COUNT; i++)
+    {
+        /* The fractional dividers cannot be scaled through their integer part alone.*/
+        if ((glScbClk[i].type != CY_SYSCLK_DIV_8_BIT) && (glScbClk[i].type != CY_SYSCLK_DIV_16_BIT))
+        {
+            return false;
+        }
+
+        glScbClkNominal[i] = Cy_SysClk_PeriphGetDivider(glScbClk[i].type, glScbClk[i].num);
+        div = (glScbClkNominal[i] + 1UL) * (PMG1_CLK_TURBO_FREQ_HZ / 1000000UL);
+        if ((div % CY_CFG_SYSCLK_CLKSYS_FREQ_MHZ) != 0UL)
+        {
+            return false;
+        }
+
+        turboDiv[i] = (div / CY_CFG_SYSCLK_CLKSYS_FREQ_MHZ) - 1UL;
+        if (turboDiv[i] > ((glScbClk[i].type == CY_SYSCLK_DIV_8_BIT) ? 0xFFUL : 0xFFFFUL))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Set the divider values of the SCB clocks.*/
+static void pmg1_scb_clk_set(const uint32_t *div)
+{
+    uint32_t i;
+
+    for (i = 0; i < PMG1_SCB_CLK_COUNT; i++)
+    {
+        (void)Cy_SysClk_PeriphSetDivider(glScbClk[i].type, glScbClk[i].num, div[i]);
+    }
+}
+#endif /* (CY_CLK_SYSTEM_FREQ_HZ < PMG1_CLK_TURBO_FREQ_HZ) */
+
+static void Set_ImoFrequency(uint32_t freqHz)
 {
     /* Convert the frequency value in Hz into the SFLASH.IMO_TRIM register index */
-    uint32_t locFreq = CY_CFG_IMO_LOC_FREQ;
+    uint32_t locFreq = CY_CFG_IMO_LOC_FREQ(freqHz);
     uint32_t intStat = Cy_SysLib_EnterCriticalSection();
 
     /* Set IMO to 24 MHz */
@@ -106,6 +179,15 @@ static void Set_ImoFrequency(void)
     Cy_SysLib_ExitCriticalSection(intStat);
 }
 
+/* Update the system core clock values used by Cy_SysLib_Delay().*/
+static void pmg1_set_core_clock(uint32_t freqHz)
+{
+    SystemCoreClock = freqHz;
+    cy_delayFreqKhz = CY_SYSLIB_DIV_ROUNDUP(freqHz, CY_DELAY_1K_THRESHOLD);
+    cy_delayFreqMhz = (uint8_t)CY_SYSLIB_DIV_ROUNDUP(freqHz, CY_DELAY_1M_THRESHOLD);
+    cy_delay32kMs   = CY_DELAY_MS_OVERFLOW_THRESHOLD * CY_SYSLIB_DIV_ROUNDUP(freqHz, CY_DELAY_1K_THRESHOLD);
+}
+
 static void pmg1_system_init(void)
 {
     cy_en_sysclk_status_t status;
@@ -115,7 +197,7 @@ static void pmg1_system_init(void)
     /* Initialize IMO frequency */
     Cy_SysClk_ImoEnable();
     (void)Cy_SysClk_ClkPumpSetSource(CY_SYSCLK_PUMP_IN_GND);
-    Set_ImoFrequency();
+    Set_ImoFrequency(CY_CLK_SYSTEM_FREQ_HZ);
 
     /* Initialize HFCLK */
     status = Cy_SysClk_ClkHfSetSource(CY_CFG_SYSCLK_HFCLK_SOURCE);
@@ -132,10 +214,8 @@ static void pmg1_system_init(void)
     Cy_SysLib_SetWaitStates(CY_CFG_SYSCLK_CLKSYS_FREQ_MHZ);
 
     /* Update System Core Clock values for correct Cy_SysLib_Delay functioning */
-    SystemCoreClock = CY_CLK_SYSTEM_FREQ_HZ;
-    cy_delayFreqKhz = CY_DELAY_FREQ_KHZ;
-    cy_delayFreqMhz = CY_DELAY_FREQ_MHZ;
-    cy_delay32kMs = CY_DELAY_FREQ_32KMS;
+    pmg1_set_core_clock(CY_CLK_SYSTEM_FREQ_HZ);
+    glClkProfile = PMG1_CLK_PROFILE_NOMINAL;
 }
 
 void pmg1_bsp_init(void)
@@ -145,7 +225,101 @@ void pmg1_bsp_init(void)
      * macros are part of source file. Due to this re-defined the macros here.
      */
     pmg1_system_init();
+}
+
+void pmg1_bsp_init_peripherals(void)
+{
     init_cycfg_clocks();
+#if (CY_CLK_SYSTEM_FREQ_HZ < PMG1_CLK_TURBO_FREQ_HZ)
+    glScbClkOn = true;
+#endif /* (CY_CLK_SYSTEM_FREQ_HZ < PMG1_CLK_TURBO_FREQ_HZ) */
     init_cycfg_peripherals();
     init_cycfg_pins();
 }
+
+/* Return a pin to its reset state: GPIO controlled, analog (high impedance) drive mode.*/
+static void pmg1_bsp_pin_deinit(GPIO_PRT_Type *port, uint32_t pin)
+{
+    Cy_GPIO_SetDrivemode(port, pin, CY_GPIO_DM_ANALOG);
+    Cy_GPIO_SetHSIOM(port, pin, HSIOM_SEL_GPIO);
+}
+
+void pmg1_bsp_deinit(void)
+{
+    /* Release the HPI pins first so that the EC sees the bus and interrupt lines go idle.*/
+    pmg1_bsp_pin_deinit(HPI_I2C_SCL_PORT, HPI_I2C_SCL_PIN);
+    pmg1_bsp_pin_deinit(HPI_I2C_SDA_PORT, HPI_I2C_SDA_PIN);
+    pmg1_bsp_pin_deinit(HPI_EC_INT_PORT, HPI_EC_INT_PIN);
+    pmg1_bsp_pin_deinit(HPI_ADDR_CFG_PORT, HPI_ADDR_CFG_PIN);
+
+#if (CY_CLK_SYSTEM_FREQ_HZ < PMG1_CLK_TURBO_FREQ_HZ)
+    /* Leave the SCB dividers as they were set up for the nominal clock.*/
+    if (glScbClkScaled)
+    {
+        pmg1_scb_clk_set(glScbClkNominal);
+        glScbClkScaled = false;
+    }
+#endif /* (CY_CLK_SYSTEM_FREQ_HZ < PMG1_CLK_TURBO_FREQ_HZ) */
+
+    /* IMO back to its 24 MHz reset frequency. The wait states are lowered only
+     * once the clock is slow enough for them.
+     */
+    Set_ImoFrequency(CY_SYSCLK_IMO_24MHZ);
+    Cy_SysLib_SetWaitStates(CY_SYSCLK_IMO_24MHZ / CY_CFG_SYSCLK_FREQ_SCALER);
+
+    SystemCoreClock = CY_SYSCLK_IMO_24MHZ;
+    glClkProfile = PMG1_CLK_PROFILE_NOMINAL;
+}
+
+pmg1_clk_profile_t pmg1_bsp_clk_profile_set(pmg1_clk_profile_t profile)
+{
+    pmg1_clk_profile_t prev = glClkProfile;
+
+#if (CY_CLK_SYSTEM_FREQ_HZ < PMG1_CLK_TURBO_FREQ_HZ)
+    uint32_t turboDiv[PMG1_SCB_CLK_COUNT];
+    uint32_t intStat;
+
+    if (profile != prev)
+    {
+        /* The SCB dividers are scaled with the clock, so that the bus rates do not change.
+         * The wait states have to be raised before the clock, and lowered after it.*/
+        if (profile == PMG1_CLK_PROFILE_TURBO)
+        {
+            /* The SCB clocks only matter once they have been set up.*/
+            if ((glScbClkOn) && (!pmg1_scb_clk_turbo_div(turboDiv)))
+            {
+                return prev;
+            }
+
+            intStat = Cy_SysLib_EnterCriticalSection();
+            Cy_SysLib_SetWaitStates(PMG1_CLK_TURBO_FREQ_HZ / CY_CFG_SYSCLK_FREQ_SCALER);
+            if (glScbClkOn)
+            {
+                pmg1_scb_clk_set(turboDiv);
+                glScbClkScaled = true;
+            }
+            Set_ImoFrequency(PMG1_CLK_TURBO_FREQ_HZ);
+            Cy_SysLib_ExitCriticalSection(intStat);
+            pmg1_set_core_clock(PMG1_CLK_TURBO_FREQ_HZ);
+        }
+        else
+        {
+            intStat = Cy_SysLib_EnterCriticalSection();
+            Set_ImoFrequency(CY_CLK_SYSTEM_FREQ_HZ);
+            if (glScbClkScaled)
+            {
+                pmg1_scb_clk_set(glScbClkNominal);
+                glScbClkScaled = false;
+            }
+            Cy_SysLib_SetWaitStates(CY_CFG_SYSCLK_CLKSYS_FREQ_MHZ);
+            Cy_SysLib_ExitCriticalSection(intStat);
+            pmg1_set_core_clock(CY_CLK_SYSTEM_FREQ_HZ);
+        }
+        glClkProfile = profile;
+    }
+#else
+    (void)profile;
+#endif /* (CY_CLK_SYSTEM_FREQ_HZ < PMG1_CLK_TURBO_FREQ_HZ) */
+
+    return prev;
+}
@@ -42,9 +42,38 @@
 #ifndef PMG1_BSP_H_
 #define PMG1_BSP_H_
 
+/* System clock of the boot-loader, taken straight from the IMO: 24 to 48 MHz in 4 MHz
+ * steps. Set through the DEFINES of the Makefile for parts run at a lower clock.
+ */
+#ifndef CY_CLK_SYSTEM_FREQ_HZ
 #define CY_CLK_SYSTEM_FREQ_HZ            (48000000UL)
+#endif /* CY_CLK_SYSTEM_FREQ_HZ */
 
+/* Highest IMO frequency, used by the turbo clock profile.*/
+#define PMG1_CLK_TURBO_FREQ_HZ           (48000000UL)
 
+/* Clock profiles of the boot-loader.*/
+typedef enum
+{
+    PMG1_CLK_PROFILE_NOMINAL = 0,       /* CY_CLK_SYSTEM_FREQ_HZ, which the peripheral clocks are set up for. */
+    PMG1_CLK_PROFILE_TURBO              /* PMG1_CLK_TURBO_FREQ_HZ, for the image check and the flashing session. */
+} pmg1_clk_profile_t;
+
+/* Configure the system clock. This is all that validating and starting the firmware needs.*/
 void pmg1_bsp_init(void);
 
+/* Configure the peripheral clocks, the peripherals and the pins used by the HPI interface.*/
+void pmg1_bsp_init_peripherals(void);
+
+/* Return the clocks and the pins configured by the boot-loader to their reset state.*/
+void pmg1_bsp_deinit(void);
+
+/* Switch the system clock to a profile, with the flash wait states it needs. Once the
+ * peripherals are up, the clock dividers of the HPI and UART SCBs are scaled with the
+ * clock; the profile stays if they cannot be scaled exactly. Call it between transfers.
+ * Does nothing if the system clock is already at PMG1_CLK_TURBO_FREQ_HZ. Returns the
+ * previous profile.
+ */
+pmg1_clk_profile_t pmg1_bsp_clk_profile_set(pmg1_clk_profile_t profile);
+
 #endif /* PMG1_BSP_H_ */
@@ -0,0 +1,217 @@
+/******************************************************************************
+* File Name: sha256.c
+*
+* Description: This source file implements a size optimized SHA-256 hash for
+*              the Cortex-M0 based PMG1 boot-loader.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "sha256.h"
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+/* Rotate right. Compiles to a single RORS instruction on the Cortex-M0.*/
+#define SHA256_ROTR(x, n)                   (((x) >> (n)) | ((x) << (32u - (n))))
+
+/* Round functions (FIPS 180-4, section 4.1.2).*/
+#define SHA256_CH(x, y, z)                  ((z) ^ ((x) & ((y) ^ (z))))
+#define SHA256_MAJ(x, y, z)                 (((x) & (y)) | ((z) & ((x) | (y))))
+#define SHA256_SIGMA0(x)                    (SHA256_ROTR((x), 2u) ^ SHA256_ROTR((x), 13u) ^ SHA256_ROTR((x), 22u))
+#define SHA256_SIGMA1(x)                    (SHA256_ROTR((x), 6u) ^ SHA256_ROTR((x), 11u) ^ SHA256_ROTR((x), 25u))
+#define SHA256_GAMMA0(x)                    (SHA256_ROTR((x), 7u) ^ SHA256_ROTR((x), 18u) ^ ((x) >> 3u))
+#define SHA256_GAMMA1(x)                    (SHA256_ROTR((x), 17u) ^ SHA256_ROTR((x), 19u) ^ ((x) >> 10u))
+
+/* Offset of the message length field in the last block.*/
+#define SHA256_LENGTH_OFFSET                (SHA256_BLOCK_SIZE - 8u)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Round constants, kept in flash.*/
+static const uint32_t glSha256K[64] =
+{
+    0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu, 0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u,
+    0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u, 0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u,
+    0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu, 0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+    0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u, 0x06ca6351u, 0x14292967u,
+    0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u, 0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
+    0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u, 0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+    0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu, 0x682e6ff3u,
+    0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u, 0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u,
+};
+
+/* Initial hash value.*/
+static const uint32_t glSha256Init[8] =
+{
+    0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au, 0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u,
+};
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+/*
+ * Hash one 64 byte block. The rounds are kept rolled and the message schedule
+ * is computed in a 16 word ring, which keeps the code at a few hundred bytes
+ * and the stack use at 64 bytes for the schedule.
+ */
+static void sha256_transform (uint32_t *state, const uint8_t *blockP)
+{
+    uint32_t w[16];
+    uint32_t s[8];
+    uint32_t t1, t2;
+    uint32_t idx;
+
+    for (idx = 0; idx < 16u; idx++)
+    {
+        w[idx] = ((uint32_t)blockP[0] << 24) | ((uint32_t)blockP[1] << 16) |
+                 ((uint32_t)blockP[2] << 8) | (uint32_t)blockP[3];
+        blockP += 4;
+    }
+
+    memcpy (s, state, sizeof (s));
+
+    for (idx = 0; idx < 64u; idx++)
+    {
+        /* Extend the schedule in place once the first 16 words have been used.*/
+        if (idx >= 16u)
+        {
+            w[idx & 15u] += SHA256_GAMMA1 (w[(idx - 2u) & 15u]) + w[(idx - 7u) & 15u] +
+                            SHA256_GAMMA0 (w[(idx - 15u) & 15u]);
+        }
+
+        t1 = s[7] + SHA256_SIGMA1 (s[4]) + SHA256_CH (s[4], s[5], s[6]) + glSha256K[idx] + w[idx & 15u];
+        t2 = SHA256_SIGMA0 (s[0]) + SHA256_MAJ (s[0], s[1], s[2]);
+
+        /* Shift the working variables down by one.*/
+        s[7] = s[6];
+        s[6] = s[5];
+        s[5] = s[4];
+        s[4] = s[3] + t1;
+        s[3] = s[2];
+        s[2] = s[1];
+        s[1] = s[0];
+        s[0] = t1 + t2;
+    }
+
+    for (idx = 0; idx < 8u; idx++)
+    {
+        state[idx] += s[idx];
+    }
+}
+
+void sha256_init (sha256_ctx_t *ctxP)
+{
+    memcpy (ctxP->state, glSha256Init, sizeof (ctxP->state));
+    ctxP->length = 0;
+}
+
+void sha256_update (sha256_ctx_t *ctxP, const uint8_t *dataP, uint32_t length)
+{
+    uint32_t used = ctxP->length & (SHA256_BLOCK_SIZE - 1u);
+    uint32_t count;
+
+    ctxP->length += length;
+
+    /* Complete a partially filled block first.*/
+    if (used != 0u)
+    {
+        count = SHA256_BLOCK_SIZE - used;
+        if (count > length)
+        {
+            count = length;
+        }
+
+        memcpy (&ctxP->block[used], dataP, count);
+        dataP  += count;
+        length -= count;
+
+        if ((used + count) < SHA256_BLOCK_SIZE)
+        {
+            return;
+        }
+
+        sha256_transform (ctxP->state, ctxP->block);
+    }
+
+    /* Hash whole blocks straight from the source.*/
+    while (length >= SHA256_BLOCK_SIZE)
+    {
+        sha256_transform (ctxP->state, dataP);
+        dataP  += SHA256_BLOCK_SIZE;
+        length -= SHA256_BLOCK_SIZE;
+    }
+
+    /* Keep the tail for later.*/
+    memcpy (ctxP->block, dataP, length);
+}
+
+void sha256_final (sha256_ctx_t *ctxP, uint8_t *digestP)
+{
+    uint32_t used = ctxP->length & (SHA256_BLOCK_SIZE - 1u);
+    uint32_t bits = ctxP->length << 3;
+    uint32_t idx;
+
+    /* Append the terminating bit, and an extra block if the length does not fit.*/
+    ctxP->block[used++] = 0x80u;
+    if (used > SHA256_LENGTH_OFFSET)
+    {
+        memset (&ctxP->block[used], 0, SHA256_BLOCK_SIZE - used);
+        sha256_transform (ctxP->state, ctxP->block);
+        used = 0;
+    }
+
+    /* The length is stored in bits, big endian. The byte count is 32 bits wide, so only
+       the lower five bytes of the 64 bit field can be non-zero.*/
+    memset (&ctxP->block[used], 0, SHA256_BLOCK_SIZE - used);
+    ctxP->block[SHA256_BLOCK_SIZE - 5u] = (uint8_t)(ctxP->length >> 29);
+    ctxP->block[SHA256_BLOCK_SIZE - 4u] = (uint8_t)(bits >> 24);
+    ctxP->block[SHA256_BLOCK_SIZE - 3u] = (uint8_t)(bits >> 16);
+    ctxP->block[SHA256_BLOCK_SIZE - 2u] = (uint8_t)(bits >> 8);
+    ctxP->block[SHA256_BLOCK_SIZE - 1u] = (uint8_t)bits;
+    sha256_transform (ctxP->state, ctxP->block);
+
+    for (idx = 0; idx < 8u; idx++)
+    {
+        digestP[4u * idx]      = (uint8_t)(ctxP->state[idx] >> 24);
+        digestP[4u * idx + 1u] = (uint8_t)(ctxP->state[idx] >> 16);
+        digestP[4u * idx + 2u] = (uint8_t)(ctxP->state[idx] >> 8);
+        digestP[4u * idx + 3u] = (uint8_t)ctxP->state[idx];
+    }
+}
+
+/* [] END OF FILE */
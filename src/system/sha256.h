@@ -0,0 +1,100 @@
+/******************************************************************************
+* File Name: sha256.h
+*
+* Description: This header file defines the SHA-256 hash interface used for
+*              firmware image authentication.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __SHA256_H__
+#define __SHA256_H__
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macro definitions
+*******************************************************************************/
+
+/* Size of a SHA-256 digest in bytes.*/
+#define SHA256_DIGEST_SIZE                  (32u)
+
+/* Size of a SHA-256 message block in bytes.*/
+#define SHA256_BLOCK_SIZE                   (64u)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+
+/**
+ * @typedef sha256_ctx_t
+ * @brief SHA-256 hash state.
+ */
+typedef struct
+{
+    uint32_t state[8];                      /**< Intermediate hash value. */
+    uint32_t length;                        /**< Number of bytes hashed so far. */
+    uint8_t  block[SHA256_BLOCK_SIZE];      /**< Partial message block. */
+} sha256_ctx_t;
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+
+/**
+ * @brief Start a new hash computation.
+ * @ctxP Hash state to be initialized.
+ */
+void sha256_init (sha256_ctx_t *ctxP);
+
+/**
+ * @brief Add data to the hash. Whole blocks are hashed straight from the source,
+ * so that flash resident images are not copied to RAM.
+ * @ctxP Hash state.
+ * @dataP Data to be hashed.
+ * @length Length of the data in bytes.
+ */
+void sha256_update (sha256_ctx_t *ctxP, const uint8_t *dataP, uint32_t length);
+
+/**
+ * @brief Complete the hash computation.
+ * @ctxP Hash state. Must be initialized again before reuse.
+ * @digestP Buffer receiving the SHA256_DIGEST_SIZE byte digest.
+ */
+void sha256_final (sha256_ctx_t *ctxP, uint8_t *digestP);
+
+#endif /* __SHA256_H__ */
+
+/* [] END OF FILE */
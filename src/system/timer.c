@@ -45,8 +45,9 @@
 /*******************************************************************************
 * Macro Definition
 *******************************************************************************/
-/* SysTick reload value for 1ms time period. */
-#define SYSTICK_RELOAD_VALUE  ((CY_CLK_SYSTEM_FREQ_HZ / 1000u) - 1u)
+/* SysTick reload value for 1ms time period. The SysTick runs from the CPU clock,
+ * which changes with the clock profile. */
+#define SYSTICK_RELOAD_VALUE  ((SystemCoreClock / 1000u) - 1u)
 
 /*******************************************************************************
 * Global Variables
@@ -57,28 +58,31 @@ static uint16_t glTimeoutPeriod;
 /* Timer expired callback function pointer. */
 static timer_cb_t glTimerCb;
 
+/* Milliseconds since timer_init(). */
+static volatile uint32_t glTimerMs;
+
 /*******************************************************************************
 * Function Definition
 *******************************************************************************/
 static void timer_interrupt_handler() {
+    timer_cb_t cb = glTimerCb;
+
+    glTimerMs++;
+
     /* Decrement the timeout value of the active timer and check if the timeout
      * has occurred. If timeout has occurred, stop the timer and perform the
-     * necessary actions. */
-    if(glTimeoutPeriod > 0)
-    {
-        glTimeoutPeriod--;
-    }
-    else
+     * necessary actions. The SysTick keeps running as the time base. */
+    if(NULL != cb)
     {
-        glTimeoutPeriod = 0;
-
-        if(NULL != glTimerCb)
+        if(glTimeoutPeriod > 0)
         {
-            glTimerCb();
+            glTimeoutPeriod--;
+        }
+        else
+        {
+            glTimerCb = NULL;
+            cb();
         }
-
-        /* Disable the SYSTICK interrupt. */
-        Cy_SysTick_Disable() ;
     }
 }
 
@@ -86,10 +90,14 @@ void timer_init(void)
 {
     glTimeoutPeriod = 0;
     glTimerCb = NULL;
+    glTimerMs = 0;
 
-    /* Disable the timer and configure the SysTick interrupt interval to 1ms*/
+    /* Configure the SysTick interrupt interval to 1ms and start the time base. */
     Cy_SysTick_Disable() ;
     Cy_SysTick_SetReload(SYSTICK_RELOAD_VALUE);
+    Cy_SysTick_Clear() ;
+    Cy_SysTick_SetClockSource(CY_SYSTICK_CLOCK_SOURCE_CLK_CPU);
+    Cy_SysTick_Enable();
 }
 
 void timer_start(uint16_t timeout, timer_cb_t cb)
@@ -102,13 +110,6 @@ void timer_start(uint16_t timeout, timer_cb_t cb)
     glTimeoutPeriod = timeout;
     glTimerCb = cb;
 
-    /* Clear the counter */
-    Cy_SysTick_Clear() ;
-
-    /* Start the timer and enable the interrupt. */
-    Cy_SysTick_SetClockSource(CY_SYSTICK_CLOCK_SOURCE_CLK_CPU);
-    Cy_SysTick_Enable();
-
     /* Exit critical section. */
     Cy_SysLib_ExitCriticalSection(state);
 }
@@ -123,14 +124,46 @@ void timer_stop(void)
     glTimeoutPeriod = 0;
     glTimerCb = NULL;
 
-    /* Stop the timer interrupt */
-    Cy_SysTick_Disable() ;
-
     /* Exit critical section. */
     Cy_SysLib_ExitCriticalSection(state);
 
 }
 
+bool timer_is_running(void)
+{
+    return (NULL != glTimerCb);
+}
+
+uint32_t timer_get_time_us(void)
+{
+    uint32_t state;
+    uint32_t ms;
+    uint32_t count;
+
+    state = Cy_SysLib_EnterCriticalSection();
+
+    ms    = glTimerMs;
+    count = Cy_SysTick_GetValue();
+
+    /* Account for a wrap whose interrupt is still pending. */
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0u)
+    {
+        ms++;
+        count = Cy_SysTick_GetValue();
+    }
+
+    Cy_SysLib_ExitCriticalSection(state);
+
+    /* The SysTick counts down from the reload value once per CPU cycle. */
+    return ((ms * 1000u) + ((SYSTICK_RELOAD_VALUE - count) / (SystemCoreClock / 1000000u)));
+}
+
+void timer_clock_changed(void)
+{
+    /* The new period starts with the next millisecond. */
+    Cy_SysTick_SetReload(SYSTICK_RELOAD_VALUE);
+}
+
 
 /* Timer ISR is called every 1ms. If there is any soft timer ON
    In the ISR all active timer instances are decremented and then checked
@@ -61,7 +61,7 @@ typedef void (*timer_cb_t)(void);
 
 /**
  * Initialize Software timer module. This function must be called once before
- * using other timer APIs
+ * using other timer APIs. Starts the 1ms SysTick time base.
  */
 void timer_init(void);
 
@@ -77,6 +77,23 @@ void timer_start(uint16_t timeout, timer_cb_t cb);
  */
 void timer_stop(void);
 
+/**
+ * Check whether a soft timer is running.
+ * @return true if a timer has been started and has not expired or been stopped.
+ */
+bool timer_is_running(void);
+
+/**
+ * Get the time since timer_init() in microseconds. Wraps after about 71 minutes.
+ */
+uint32_t timer_get_time_us(void);
+
+/**
+ * Keep the 1 ms period after the CPU clock has changed: SystemCoreClock has to
+ * hold the new frequency.
+ */
+void timer_clock_changed(void);
+
 #endif /* TIMER_H_ */
 
 /* EOF */
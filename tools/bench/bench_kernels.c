@@ -0,0 +1,70 @@
+/******************************************************************************
+* File Name: bench_kernels.c
+*
+* Description: Boot-loader kernels linked into a stand-alone image for
+*              pmg1-bench. The kernels are the boot-loader's own sources.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdint.h>
+#include "crc32.h"
+#include "sha256.h"
+#if BENCH_PDUTILS
+#include "cy_pdutils.h"
+#endif /* BENCH_PDUTILS */
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+
+typedef void (*bench_kernel_t)(void);
+
+/* Kernels run by pmg1-bench, which finds them by symbol name. Taking their addresses
+ * keeps an out-of-line copy of each one under LTO.*/
+__attribute__((used, section(".bench_kernels")))
+const bench_kernel_t bench_kernels[] =
+{
+    (bench_kernel_t)calculate_crc32,
+    (bench_kernel_t)crc32_update,
+    (bench_kernel_t)sha256_init,
+    (bench_kernel_t)sha256_update,
+    (bench_kernel_t)sha256_final,
+#if BENCH_PDUTILS
+    (bench_kernel_t)Cy_PdUtils_MemCopy,
+#endif /* BENCH_PDUTILS */
+};
+
+/* [] END OF FILE */
@@ -0,0 +1,508 @@
+/******************************************************************************
+* File Name: bench_main.cpp
+*
+* Description: pmg1-bench: runs boot-loader kernels from an ARM ELF file on
+*              the Cortex-M0/M0+ cycle model and reports cycles per byte and
+*              code size.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "crc32c.h"
+#include "image.h"
+#include "m0_core.h"
+#include "segments.h"
+
+using namespace pmg1;
+
+namespace {
+
+/* Stack reserved at the top of RAM; scratch buffers go below it. */
+constexpr uint32_t kStackReserve = 0x800;
+
+/* Slots planted for boot_start(), as in the default configuration. */
+constexpr uint8_t kBenchSlots = 2;
+
+constexpr uint64_t kSetupInsns = 10000000;
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: pmg1-bench [--target NAME] [--core m0|m0plus|all] [--flash-ws N] [--mul-cycles N]\n"
+        "                  [--sizes N,N,...] [--max-insns N] [--call SYMBOL [ARG...] --] ELF...\n"
+        "Kernels are found by symbol: calculate_crc32, sha256_update, Cy_PdUtils_MemCopy,\n"
+        "flash_row_write and boot_start. Kernels missing from an ELF are skipped.\n"
+        "targets: %s\n", target_names().c_str());
+}
+
+struct Options {
+    const TargetInfo *target = nullptr;
+    std::vector<const M0Timing *> cores;
+    M0Config config;
+    std::vector<uint32_t> sizes = {64, 256, 1024, 4096};
+    uint64_t maxInsns = 500000000;
+    std::string callSymbol;
+    std::vector<uint32_t> callArgs;
+};
+
+/* Where a kernel finds its inputs, derived from the ELF and the target. */
+struct Layout {
+    const SegmentFile *elf;
+    const TargetInfo *target;
+    uint32_t dataAddr;                  /* First free flash row above the loaded code. */
+    uint32_t scratchTop;                /* Top of the RAM scratch area, below the stack. */
+    uint32_t stackTop;
+};
+
+/* One timed call. setup runs on the fresh core before it, check after it. */
+struct Run {
+    std::vector<uint32_t> args;
+    uint32_t bytes = 0;
+    uint32_t stopWriteAddr = 0;
+    std::function<bool(M0Core &)> setup;
+    std::function<bool(M0Core &, const M0Result &)> check;
+};
+
+/* Fill in a run for an input size. Returns false if the size does not fit. */
+using Prepare = bool (*)(const Layout &layout, uint32_t size, Run *run);
+
+struct Kernel {
+    const char *name;
+    const char *entry;
+    std::vector<const char *> code;     /* Functions counted in the code size. */
+    std::vector<const char *> data;     /* Constant tables counted in the data size. */
+    bool sized;                         /* Runs for each --sizes value, otherwise once. */
+    Prepare prepare;
+};
+
+std::vector<uint8_t> pattern(size_t size, uint32_t seed)
+{
+    std::vector<uint8_t> data(size);
+    uint32_t lfsr = seed;
+    for (uint8_t &b : data) {
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xD0000001u);
+        b = static_cast<uint8_t>(lfsr);
+    }
+    return data;
+}
+
+uint32_t symbol_addr(const Layout &layout, const char *name)
+{
+    const Symbol *sym = layout.elf->find_symbol(name);
+    return (sym != nullptr) ? sym->addr : 0;
+}
+
+bool call_untimed(M0Core &core, const Layout &layout, const char *name, const std::vector<uint32_t> &args)
+{
+    const uint32_t entry = symbol_addr(layout, name);
+    return (entry != 0) && (core.call(entry, args, layout.stackTop, kSetupInsns).stop == M0Stop::Return);
+}
+
+/* Store to a variable of up to four bytes by name. */
+bool poke(M0Core &core, const Layout &layout, const char *name, uint32_t value)
+{
+    const Symbol *sym = layout.elf->find_symbol(name);
+    uint8_t raw[4];
+
+    if ((sym == nullptr) || sym->function || (sym->size == 0) || (sym->size > sizeof(raw))) {
+        return false;
+    }
+    put_le32(raw, value);
+    return core.write(sym->addr, raw, sym->size);
+}
+
+bool prepare_crc(const Layout &layout, uint32_t size, Run *run)
+{
+    if (layout.dataAddr + size > layout.target->flashSize) {
+        return false;
+    }
+    const uint32_t src = layout.dataAddr;
+    const std::vector<uint8_t> input = pattern(size, 0x1234567u);
+    const uint32_t expected = crc32c(input.data(), input.size());
+
+    run->args = {src, size};
+    run->setup = [=](M0Core &core) { return core.write(src, input.data(), input.size()); };
+    run->check = [=](M0Core &, const M0Result &result) { return result.r0 == expected; };
+    return true;
+}
+
+bool prepare_sha256(const Layout &layout, uint32_t size, Run *run)
+{
+    if (layout.dataAddr + size > layout.target->flashSize) {
+        return false;
+    }
+    const uint32_t src = layout.dataAddr;
+    const uint32_t ctx = layout.scratchTop - 128;
+    const uint32_t digestAddr = ctx - kFwDigestSize;
+    const std::vector<uint8_t> input = pattern(size, 0x7654321u);
+    std::vector<uint8_t> expected(kFwDigestSize);
+    image_digest(input.data(), input.size(), expected.data());
+
+    /* Only the update is timed: init and final are fixed costs. */
+    run->args = {ctx, src, size};
+    run->setup = [=](M0Core &core) {
+        return core.write(src, input.data(), input.size()) && call_untimed(core, layout, "sha256_init", {ctx});
+    };
+    run->check = [=](M0Core &core, const M0Result &) {
+        std::vector<uint8_t> digest(kFwDigestSize);
+        return call_untimed(core, layout, "sha256_final", {ctx, digestAddr}) &&
+               core.read(digestAddr, digest.data(), digest.size()) && (digest == expected);
+    };
+    return true;
+}
+
+bool prepare_memcopy(const Layout &layout, uint32_t size, Run *run)
+{
+    /* RAM to RAM, as flash_row_write() copies a row into the SROM parameter block. */
+    if (2 * size + kStackReserve > layout.target->ramSize / 2) {
+        return false;
+    }
+    const uint32_t src = layout.scratchTop - size;
+    const uint32_t dst = src - size;
+    const std::vector<uint8_t> input = pattern(size, 0x2468ACEu);
+
+    run->args = {dst, src, size};
+    run->setup = [=](M0Core &core) { return core.write(src, input.data(), input.size()); };
+    run->check = [=](M0Core &core, const M0Result &) {
+        std::vector<uint8_t> copy(size);
+        return core.read(dst, copy.data(), copy.size()) && (copy == input);
+    };
+    return true;
+}
+
+/* flash_row_write() up to the SROM request, for an application row or a metadata row. */
+bool prepare_row_write(const Layout &layout, bool metadataRow, Run *run)
+{
+    const TargetInfo &target = *layout.target;
+    const uint16_t mdRow = slot_metadata_row(target, 1);
+    const uint16_t row = metadataRow ? mdRow : static_cast<uint16_t>(target.blLastRow + 1);
+    const uint32_t buf = layout.scratchTop - target.rowSize;
+    const std::vector<uint8_t> input = pattern(target.rowSize, 0x1357911u);
+
+    run->args = {buf, row};
+    run->bytes = target.rowSize;
+    run->stopWriteAddr = kM0CpussSysreq;
+    run->setup = [=](M0Core &core) {
+        /* State normally set up by flash_enter_mode() and flash_set_access_limits(). */
+        return core.write(buf, input.data(), input.size()) &&
+               poke(core, layout, "glFlashModeEn", 1) &&
+               poke(core, layout, "glFlashAccessFirst", target.blLastRow + 1u) &&
+               poke(core, layout, "glFlashAccessLast", slot_metadata_row(target, kBenchSlots) - 1u) &&
+               poke(core, layout, "glFlashMetadataRow", mdRow) &&
+               poke(core, layout, "glFlashBlLastRow", target.blLastRow);
+    };
+    return true;
+}
+
+bool prepare_row_write_app(const Layout &layout, uint32_t, Run *run)
+{
+    return prepare_row_write(layout, false, run);
+}
+
+bool prepare_row_write_md(const Layout &layout, uint32_t, Run *run)
+{
+    return prepare_row_write(layout, true, run);
+}
+
+/* boot_start() with valid images of the given size in both slots. */
+bool prepare_boot_start(const Layout &layout, uint32_t size, Run *run)
+{
+    const TargetInfo &target = *layout.target;
+    const uint16_t appRows = static_cast<uint16_t>(target.last_row() - kBenchSlots - target.blLastRow);
+    const uint16_t slotRows = static_cast<uint16_t>(appRows / kBenchSlots);
+    std::vector<UpdateImage> images(kBenchSlots);
+
+    if (size > static_cast<uint32_t>(slotRows) * target.rowSize) {
+        return false;
+    }
+    for (uint8_t slot = 1; slot <= kBenchSlots; slot++) {
+        const uint16_t firstRow = static_cast<uint16_t>(target.blLastRow + 1 + (slot - 1) * slotRows);
+        std::string error;
+        if (!make_image_from_binary(target, slot, firstRow, pattern(size, 0x1234567u + slot), kWaitTimeDefault,
+                                    &images[slot - 1], &error)) {
+            return false;
+        }
+    }
+
+    run->bytes = size * kBenchSlots;
+    run->setup = [=](M0Core &core) {
+        for (const UpdateImage &image : images) {
+            for (const ImageRow &row : image.rows) {
+                if (!core.write(static_cast<uint32_t>(row.row) * target.rowSize, row.data.data(), row.data.size())) {
+                    return false;
+                }
+            }
+            const ImageRow &md = image.metadataRow;
+            if (!core.write(static_cast<uint32_t>(md.row) * target.rowSize, md.data.data(), md.data.size())) {
+                return false;
+            }
+        }
+        return true;
+    };
+    run->check = [](M0Core &, const M0Result &result) { return (result.r0 & 0xFFu) != 0; };
+    return true;
+}
+
+const Kernel kKernels[] = {
+    {"calculate_crc32", "calculate_crc32", {"calculate_crc32", "crc32_update"}, {"crcTable"}, true, prepare_crc},
+    {"sha256_update", "sha256_update", {"sha256_update", "sha256_transform"}, {"glSha256K"}, true, prepare_sha256},
+    {"Cy_PdUtils_MemCopy", "Cy_PdUtils_MemCopy", {"Cy_PdUtils_MemCopy"}, {}, true, prepare_memcopy},
+    {"flash_row_write", "flash_row_write", {"flash_row_write", "flash_trig_row_write"}, {}, false,
+     prepare_row_write_app},
+    {"flash_row_write/md", "flash_row_write", {"flash_row_write", "flash_trig_row_write", "boot_get_next_boot_seq"},
+     {}, false, prepare_row_write_md},
+    {"boot_start", "boot_start", {"boot_start", "boot_check_begin", "boot_check_task", "boot_check_next",
+                                  "boot_validate_firmware"}, {}, true, prepare_boot_start},
+};
+
+/* Fresh core with the ELF loaded at both its load and its run addresses, so that
+ * initialized data is in place without running the startup code. */
+bool load_core(const Layout &layout, M0Core *core, std::string *error)
+{
+    for (const Segment &seg : layout.elf->segments()) {
+        if (!core->write(seg.addr, seg.data, seg.size) ||
+            ((seg.vaddr != seg.addr) && !core->write(seg.vaddr, seg.data, seg.size))) {
+            char text[96];
+            std::snprintf(text, sizeof(text), "segment at 0x%08X does not fit the %s memory map",
+                          seg.addr, layout.target->series);
+            *error = text;
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t symbol_bytes(const Layout &layout, const std::vector<const char *> &names)
+{
+    uint32_t total = 0;
+    for (const char *name : names) {
+        const Symbol *sym = layout.elf->find_symbol(name);
+        total += (sym != nullptr) ? sym->size : 0;
+    }
+    return total;
+}
+
+const char *stop_name(M0Stop stop)
+{
+    switch (stop) {
+    case M0Stop::Return: return "wrong result";
+    case M0Stop::Write: return "reached SROM request";
+    case M0Stop::Limit: return "instruction limit";
+    case M0Stop::Breakpoint: return "breakpoint";
+    default: return "fault";
+    }
+}
+
+void bench_kernel(const Layout &layout, const M0Config &config, const Options &opt, const Kernel &kernel)
+{
+    const Symbol *entry = layout.elf->find_symbol(kernel.entry);
+    if ((entry == nullptr) || !entry->function) {
+        return;
+    }
+
+    const uint32_t code = symbol_bytes(layout, kernel.code);
+    const uint32_t data = symbol_bytes(layout, kernel.data);
+    const std::vector<uint32_t> once(1, 0);
+
+    for (uint32_t size : (kernel.sized ? opt.sizes : once)) {
+        Run run;
+        run.bytes = size;
+        if (!kernel.prepare(layout, size, &run)) {
+            continue;
+        }
+
+        M0Config runConfig = config;
+        runConfig.stopWriteAddr = run.stopWriteAddr;
+        M0Core core(layout.target->flashSize, layout.target->ramSize, runConfig);
+        std::string error;
+        if (!load_core(layout, &core, &error) || (run.setup && !run.setup(core))) {
+            std::printf("%-20s %-14s %7u  setup failed%s%s\n", kernel.name, config.timing->name, run.bytes,
+                        error.empty() ? "" : ": ", error.c_str());
+            continue;
+        }
+
+        const M0Result result = core.call(entry->addr, run.args, layout.stackTop, opt.maxInsns);
+        const M0Stop expected = (run.stopWriteAddr != 0) ? M0Stop::Write : M0Stop::Return;
+        const bool ok = (result.stop == expected) && ((!run.check) || run.check(core, result));
+
+        std::printf("%-20s %-14s %7u %10llu %9.2f %6u %5u  %s\n", kernel.name, config.timing->name, run.bytes,
+                    static_cast<unsigned long long>(result.cycles),
+                    (run.bytes != 0) ? static_cast<double>(result.cycles) / run.bytes : 0.0, code, data,
+                    ok ? "ok" : ((result.stop == expected) ? "wrong result" : stop_name(result.stop)));
+        if (!result.fault.empty()) {
+            std::printf("    %s\n", result.fault.c_str());
+        }
+    }
+}
+
+/* Call one function with the given arguments and print what it returned. */
+int call_symbol(const Layout &layout, const M0Config &config, const Options &opt)
+{
+    const Symbol *sym = layout.elf->find_symbol(opt.callSymbol);
+    if (sym == nullptr) {
+        std::fprintf(stderr, "pmg1-bench: %s: no such symbol\n", opt.callSymbol.c_str());
+        return 1;
+    }
+
+    M0Core core(layout.target->flashSize, layout.target->ramSize, config);
+    std::string error;
+    if (!load_core(layout, &core, &error)) {
+        std::fprintf(stderr, "pmg1-bench: %s\n", error.c_str());
+        return 1;
+    }
+    const M0Result result = core.call(sym->addr, opt.callArgs, layout.stackTop, opt.maxInsns);
+    std::printf("%s %s: r0 0x%08X, %llu cycles, %llu instructions, %s\n", opt.callSymbol.c_str(),
+                config.timing->name, result.r0, static_cast<unsigned long long>(result.cycles),
+                static_cast<unsigned long long>(result.insns),
+                (result.stop == M0Stop::Return) ? "returned" : stop_name(result.stop));
+    if (!result.fault.empty()) {
+        std::printf("    %s\n", result.fault.c_str());
+    }
+    return (result.stop == M0Stop::Return) ? 0 : 1;
+}
+
+bool parse_sizes(const char *text, std::vector<uint32_t> *sizes)
+{
+    sizes->clear();
+    while (*text != '\0') {
+        char *end;
+        const unsigned long value = std::strtoul(text, &end, 0);
+        if ((end == text) || (value == 0) || ((*end != ',') && (*end != '\0'))) {
+            return false;
+        }
+        sizes->push_back(static_cast<uint32_t>(value));
+        text = (*end == ',') ? end + 1 : end;
+    }
+    return !sizes->empty();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    std::vector<std::string> files;
+    std::string targetName = "S3";
+    std::string coreName = "all";
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasArg = (i + 1) < argc;
+        if ((std::strcmp(argv[i], "--target") == 0) && hasArg) {
+            targetName = argv[++i];
+        } else if ((std::strcmp(argv[i], "--core") == 0) && hasArg) {
+            coreName = argv[++i];
+        } else if ((std::strcmp(argv[i], "--flash-ws") == 0) && hasArg) {
+            opt.config.flashWaitStates = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--mul-cycles") == 0) && hasArg) {
+            opt.config.mulCycles = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--sizes") == 0) && hasArg) {
+            if (!parse_sizes(argv[++i], &opt.sizes)) {
+                usage();
+                return 2;
+            }
+        } else if ((std::strcmp(argv[i], "--max-insns") == 0) && hasArg) {
+            opt.maxInsns = std::strtoull(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--call") == 0) && hasArg) {
+            opt.callSymbol = argv[++i];
+            while ((i + 1 < argc) && (std::strcmp(argv[i + 1], "--") != 0)) {
+                opt.callArgs.push_back(static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)));
+            }
+            i++;
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    opt.target = find_target(targetName);
+    if (coreName == "m0") {
+        opt.cores = {&kCortexM0};
+    } else if (coreName == "m0plus") {
+        opt.cores = {&kCortexM0Plus};
+    } else if (coreName == "all") {
+        opt.cores = {&kCortexM0, &kCortexM0Plus};
+    }
+    if ((opt.target == nullptr) || opt.cores.empty() || files.empty() || (opt.callArgs.size() > 4)) {
+        usage();
+        return 2;
+    }
+
+    int status = 0;
+    for (const std::string &file : files) {
+        SegmentFile elf;
+        std::string error;
+        if (!elf.load(file, &error) || elf.symbols().empty()) {
+            std::fprintf(stderr, "pmg1-bench: %s\n", error.empty() ? (file + ": no symbols").c_str() : error.c_str());
+            status = 1;
+            continue;
+        }
+
+        Layout layout = {&elf, opt.target, 0, 0, kM0RamBase + opt.target->ramSize};
+        for (const Segment &seg : elf.segments()) {
+            if (seg.addr < opt.target->flashSize) {
+                layout.dataAddr = std::max(layout.dataAddr, static_cast<uint32_t>(seg.addr + seg.size));
+            }
+        }
+        layout.dataAddr = (layout.dataAddr + opt.target->rowSize - 1) & ~(opt.target->rowSize - 1u);
+        layout.scratchTop = layout.stackTop - kStackReserve;
+
+        for (const M0Timing *timing : opt.cores) {
+            M0Config config = opt.config;
+            config.timing = timing;
+            if (!opt.callSymbol.empty()) {
+                status |= call_symbol(layout, config, opt);
+                continue;
+            }
+
+            std::printf("%s: %s, %u flash wait states, %u cycle multiply\n", file.c_str(), opt.target->name,
+                        config.flashWaitStates, config.mulCycles);
+            std::printf("%-20s %-14s %7s %10s %9s %6s %5s  %s\n", "kernel", "core", "bytes", "cycles",
+                        "cyc/byte", "code", "data", "result");
+            for (const Kernel &kernel : kKernels) {
+                bench_kernel(layout, config, opt, kernel);
+            }
+        }
+    }
+    return status;
+}
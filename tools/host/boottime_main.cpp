@@ -0,0 +1,317 @@
+/******************************************************************************
+* File Name: boottime_main.cpp
+*
+* Description: Boot latency scenarios on the device model: reset-to-jump and
+*              reset-to-RESET_COMPLETE times across image and row sizes.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "crc32c.h"
+#include "metadata.h"
+#include "sim_device.h"
+
+using namespace pmg1;
+
+namespace {
+
+constexpr uint64_t kMsToNs = 1000000;
+
+/* Longest boot-wait window of the boot-loader, plus margin. */
+constexpr uint64_t kSettleNs = 1200 * kMsToNs;
+
+const uint16_t kRowSizes[] = {64, 128, 256};
+
+enum class Reset {
+    PowerOn,
+    StartApp,                   /* Soft reset with PMG1_BOOT_TYPE_START_APP. */
+    BootModeRqt,                /* Soft reset with PMG1_BOOT_MODE_RQT_SIG. */
+    JumpToAlt,                  /* Soft reset with PMG1_FW_BOOT_RQT_SIG of the other slot. */
+};
+
+enum class Slot2 {
+    Empty,
+    Valid,
+    BadCrc,                     /* Sane metadata, image does not match its CRC. */
+    Erased,                     /* Image in place, metadata row erased. */
+};
+
+struct Scenario {
+    const char *name;
+    bool slot1;                 /* FW1 holds a valid image. */
+    Slot2 slot2;                /* FW2 state; FW2 carries the higher boot sequence. */
+    Reset reset;
+    uint8_t expectFw;           /* 0: stays in the boot-loader. */
+};
+
+const Scenario kScenarios[] = {
+    {"cold-2",        true,  Slot2::Valid,  Reset::PowerOn,     2},
+    {"cold-1",        true,  Slot2::Empty,  Reset::PowerOn,     1},
+    {"cold-0",        false, Slot2::Empty,  Reset::PowerOn,     0},
+    {"start-app",     true,  Slot2::Valid,  Reset::StartApp,    2},
+    {"boot-mode-rqt", true,  Slot2::Valid,  Reset::BootModeRqt, 0},
+    {"jump-to-alt",   true,  Slot2::Valid,  Reset::JumpToAlt,   1},
+    {"md-corrupt",    true,  Slot2::BadCrc, Reset::PowerOn,     1},
+    {"md-erased",     true,  Slot2::Erased, Reset::PowerOn,     1},
+};
+
+struct Options {
+    uint16_t bootWait = kWaitTimeZero;
+    bool bgCheck = false;
+    bool directHandoff = false;
+    bool bootRecord = false;
+    SimTiming timing;
+    double maxJumpMs = 0;
+    std::string scenario;
+};
+
+struct Sample {
+    bool ok;
+    uint8_t booted;
+    uint64_t jumpNs;            /* 0 if no firmware was started. */
+    uint64_t resetCompleteNs;
+};
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: pmg1-boottime [--target NAME] [--scenario NAME] [--boot-wait zero|default|MS]\n"
+        "                     [--bg-check] [--direct-handoff] [--boot-record]\n"
+        "                     [--crc-ns-per-byte N] [--max-jump-ms MS]\n"
+        "targets: %s\n"
+        "scenarios:", target_names().c_str());
+    for (const Scenario &scenario : kScenarios) {
+        std::fprintf(stderr, " %s", scenario.name);
+    }
+    std::fprintf(stderr, "\n");
+}
+
+/* Write an image of the given size at the start of the slot, with metadata in the row
+   that boot_slot_get_metadata() reads. */
+void plant_image(SimDevice &dev, uint8_t slot, uint32_t firstRow, uint32_t size, uint32_t bootSeq,
+                 uint16_t bootWait, bool badCrc)
+{
+    const TargetInfo &target = dev.target();
+    std::vector<uint8_t> &flash = dev.flash();
+    const uint32_t start = firstRow * target.rowSize;
+
+    uint32_t lfsr = 0x1234567u + slot;
+    for (uint32_t i = 0; i < size; i++) {
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xD0000001u);
+        flash[start + i] = static_cast<uint8_t>(lfsr);
+    }
+
+    Metadata md;
+    md.appFwStart = start;
+    md.appFwSize = size;
+    md.bootWaitTime = bootWait;
+    md.bootLastRow = static_cast<uint16_t>(target.blLastRow);
+    md.bootSeq = bootSeq;
+    md.metadataValid = kMetadataValidSig;
+    md.fwCrc32 = crc32c(&flash[start], size) ^ (badCrc ? 1u : 0u);
+
+    const size_t mdAddr = (static_cast<size_t>(dev.metadata_row(slot)) + 1) * target.rowSize - kMetadataSize;
+    md.serialize(&flash[mdAddr]);
+}
+
+Sample run(const TargetInfo &target, const Scenario &scenario, uint32_t size, const Options &options)
+{
+    SimDevice dev(target, 2, options.timing);
+    dev.set_background_check(options.bgCheck);
+    dev.set_direct_handoff(options.directHandoff);
+    dev.set_boot_record(options.bootRecord);
+
+    const uint32_t appRows = target.last_row() - 2u - target.blLastRow;
+    const uint32_t slotRows = appRows / 2u;
+    if (scenario.slot1) {
+        plant_image(dev, 1, target.blLastRow + 1u, size, 1, options.bootWait, false);
+    }
+    if (scenario.slot2 != Slot2::Empty) {
+        plant_image(dev, 2, target.blLastRow + 1u + slotRows, size, 2, options.bootWait,
+                    scenario.slot2 == Slot2::BadCrc);
+    }
+    if (scenario.slot2 == Slot2::Erased) {
+        const size_t mdRow = static_cast<size_t>(dev.metadata_row(2)) * target.rowSize;
+        std::fill(dev.flash().begin() + mdRow, dev.flash().begin() + mdRow + target.rowSize, 0);
+    }
+
+    /* The update tool validates each image it writes, FW2 last. */
+    if (options.bootRecord) {
+        uint64_t cost = 0;
+        for (uint8_t slot = 1; slot <= 2; slot++) {
+            (void)dev.validate_slot(slot, &cost);
+        }
+    }
+
+    /* Soft resets are issued by the application started from the cold boot. */
+    dev.power_on();
+    if (scenario.reset != Reset::PowerOn) {
+        dev.advance_to(dev.now_ns() + kSettleNs);
+        switch (scenario.reset) {
+        case Reset::StartApp:
+            dev.soft_reset(kBootTypeStartApp);
+            break;
+        case Reset::BootModeRqt:
+            dev.soft_reset(kBootModeRqtSig);
+            break;
+        default:
+            dev.soft_reset(static_cast<uint16_t>(kBootRqtSigBase + ((dev.active_fw() == 1) ? 2 : 1)));
+            break;
+        }
+    }
+    dev.advance_to(dev.now_ns() + kSettleNs);
+
+    Sample sample = {};
+    sample.booted = dev.active_fw();
+    sample.ok = (sample.booted == scenario.expectFw);
+    if (sample.booted != 0) {
+        sample.jumpNs = dev.last_boot_ns() - dev.last_reset_ns();
+    }
+    if (dev.reset_complete_ns() != 0) {
+        sample.resetCompleteNs = dev.reset_complete_ns() - dev.last_reset_ns();
+    }
+    return sample;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string targetName = "PMG1-CY7110";
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasArg = (i + 1) < argc;
+        if ((std::strcmp(argv[i], "--target") == 0) && hasArg) {
+            targetName = argv[++i];
+        } else if ((std::strcmp(argv[i], "--scenario") == 0) && hasArg) {
+            options.scenario = argv[++i];
+        } else if ((std::strcmp(argv[i], "--boot-wait") == 0) && hasArg) {
+            const char *wait = argv[++i];
+            if (std::strcmp(wait, "zero") == 0) {
+                options.bootWait = kWaitTimeZero;
+            } else if (std::strcmp(wait, "default") == 0) {
+                options.bootWait = kWaitTimeDefault;
+            } else {
+                options.bootWait = static_cast<uint16_t>(std::strtoul(wait, nullptr, 0));
+            }
+        } else if (std::strcmp(argv[i], "--bg-check") == 0) {
+            options.bgCheck = true;
+        } else if (std::strcmp(argv[i], "--direct-handoff") == 0) {
+            options.directHandoff = true;
+        } else if (std::strcmp(argv[i], "--boot-record") == 0) {
+            options.bootRecord = true;
+        } else if ((std::strcmp(argv[i], "--crc-ns-per-byte") == 0) && hasArg) {
+            options.timing.crcNsPerByte = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--max-jump-ms") == 0) && hasArg) {
+            options.maxJumpMs = std::strtod(argv[++i], nullptr);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    const TargetInfo *base = find_target(targetName);
+    bool known = options.scenario.empty();
+    for (const Scenario &scenario : kScenarios) {
+        known = known || (options.scenario == scenario.name);
+    }
+    if ((base == nullptr) || !known) {
+        usage();
+        return 2;
+    }
+
+    std::string wait = std::to_string(options.bootWait) + " ms";
+    if (options.bootWait == kWaitTimeZero) {
+        wait = "zero";
+    } else if (options.bootWait == kWaitTimeDefault) {
+        wait = "default";
+    }
+    std::printf("target %s, boot-wait %s, %s image check%s, %s\n", base->name, wait.c_str(),
+                options.bgCheck ? "background" : "blocking", options.bootRecord ? " with boot record" : "",
+                options.directHandoff ? "direct handoff" : "handoff through reset");
+    std::printf("%-14s %5s %8s %10s %12s  %s\n", "scenario", "row", "image", "jump ms", "complete ms", "booted");
+
+    bool ok = true;
+    for (const uint16_t rowSize : kRowSizes) {
+        /* PMG1_FW_METADATA_ROW() holds the whole metadata in one row. */
+        if (rowSize < kMetadataSize) {
+            std::printf("%-14s %5u  skipped: the %zu byte metadata does not fit a row\n", "-", rowSize,
+                        kMetadataSize);
+            continue;
+        }
+
+        /* Same flash and boot-loader size with the row size of another device. */
+        TargetInfo target = *base;
+        target.rowSize = rowSize;
+        target.blLastRow = static_cast<uint16_t>(((base->blLastRow + 1u) * base->rowSize) / rowSize - 1u);
+
+        const uint32_t slotBytes = ((target.last_row() - 2u - target.blLastRow) / 2u) * rowSize;
+        std::vector<uint32_t> sizes;
+        for (uint32_t size = 8 * 1024; size < slotBytes; size *= 2) {
+            sizes.push_back(size);
+        }
+        sizes.push_back(slotBytes);
+
+        for (const Scenario &scenario : kScenarios) {
+            if (!options.scenario.empty() && (options.scenario != scenario.name)) {
+                continue;
+            }
+            for (const uint32_t size : sizes) {
+                const Sample sample = run(target, scenario, size, options);
+                const bool overBudget = (options.maxJumpMs != 0) && (sample.jumpNs / 1e6 > options.maxJumpMs);
+
+                char jump[16] = "-";
+                char booted[16] = "boot-loader";
+                if (sample.booted != 0) {
+                    std::snprintf(jump, sizeof(jump), "%.3f", sample.jumpNs / 1e6);
+                    std::snprintf(booted, sizeof(booted), "FW%u", sample.booted);
+                }
+                std::printf("%-14s %5u %8u %10s %12.3f  %s%s\n", scenario.name, rowSize, size, jump,
+                            sample.resetCompleteNs / 1e6, booted,
+                            !sample.ok ? "  (wrong outcome)" : (overBudget ? "  (over budget)" : ""));
+                ok = ok && sample.ok && !overBudget;
+            }
+        }
+    }
+
+    return ok ? 0 : 1;
+}
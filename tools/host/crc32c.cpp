@@ -0,0 +1,152 @@
+/******************************************************************************
+* File Name: crc32c.cpp
+*
+* Description: CRC-32C helper for the PMG1 bootloader host tools.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "crc32c.h"
+
+#include <array>
+#include <cstring>
+
+namespace pmg1 {
+
+namespace {
+
+constexpr uint32_t kPolyReflected = 0x82F63B78u;
+
+std::array<uint32_t, 256> make_table()
+{
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ ((crc & 1u) ? kPolyReflected : 0u);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+const std::array<uint32_t, 256> kTable = make_table();
+
+} // namespace
+
+uint32_t crc32c_update_portable(uint32_t crc, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        crc = (crc >> 8) ^ kTable[(crc ^ data[i]) & 0xFFu];
+    }
+    return crc;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace {
+
+/* SSE4.2 crc32 computes CRC-32C in the same reflected form as the table. */
+__attribute__((target("sse4.2")))
+uint32_t crc32c_update_sse42(uint32_t crc, const uint8_t *data, size_t length)
+{
+    while ((length != 0) && ((reinterpret_cast<uintptr_t>(data) & 7u) != 0)) {
+        crc = __builtin_ia32_crc32qi(crc, *data++);
+        length--;
+    }
+#if defined(__x86_64__)
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = static_cast<uint32_t>(__builtin_ia32_crc32di(crc, word));
+        data += 8;
+        length -= 8;
+    }
+#endif
+    while (length >= 4) {
+        uint32_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __builtin_ia32_crc32si(crc, word);
+        data += 4;
+        length -= 4;
+    }
+    while (length != 0) {
+        crc = __builtin_ia32_crc32qi(crc, *data++);
+        length--;
+    }
+    return crc;
+}
+
+using crc32c_fn = uint32_t (*)(uint32_t, const uint8_t *, size_t);
+
+crc32c_fn select_crc32c()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") ? crc32c_update_sse42 : crc32c_update_portable;
+}
+
+const crc32c_fn kCrc32cUpdate = select_crc32c();
+
+} // namespace
+
+uint32_t crc32c_update(uint32_t crc, const uint8_t *data, size_t length)
+{
+    return kCrc32cUpdate(crc, data, length);
+}
+
+bool crc32c_hw_accelerated()
+{
+    return kCrc32cUpdate != crc32c_update_portable;
+}
+
+#else
+
+uint32_t crc32c_update(uint32_t crc, const uint8_t *data, size_t length)
+{
+    return crc32c_update_portable(crc, data, length);
+}
+
+bool crc32c_hw_accelerated()
+{
+    return false;
+}
+
+#endif /* x86 */
+
+uint32_t crc32c(const uint8_t *data, size_t length)
+{
+    return ~crc32c_update(0xFFFFFFFFu, data, length);
+}
+
+} // namespace pmg1
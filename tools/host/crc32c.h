@@ -0,0 +1,63 @@
+/******************************************************************************
+* File Name: crc32c.h
+*
+* Description: CRC-32C helper for the PMG1 bootloader host tools. Matches
+*              calculate_crc32() in src/system/boot.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_CRC32C_H
+#define PMG1_HOST_CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pmg1 {
+
+/* CRC-32C (Castagnoli), reflected, initial value and final XOR of 0xFFFFFFFF. */
+uint32_t crc32c(const uint8_t *data, size_t length);
+
+/* Incremental form: start with crc = 0xFFFFFFFF and invert the final value. */
+uint32_t crc32c_update(uint32_t crc, const uint8_t *data, size_t length);
+
+/* Table driven form, used where SSE4.2 is not available. */
+uint32_t crc32c_update_portable(uint32_t crc, const uint8_t *data, size_t length);
+
+/* True if crc32c_update() uses the SSE4.2 crc32 instruction. */
+bool crc32c_hw_accelerated();
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_CRC32C_H */
@@ -0,0 +1,294 @@
+/******************************************************************************
+* File Name: frame_updater.cpp
+*
+* Description: Firmware update over the framed command layer of the
+*              bootloader (bl_cmd.h).
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "frame_updater.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "crc32c.h"
+#include "hpi_proto.h"
+
+extern "C" {
+#include "bl_cmd.h"
+}
+
+namespace pmg1 {
+
+namespace {
+
+/* GET_INFO retry interval while the bootloader brings up its transports. */
+constexpr uint32_t kConnectRetryMs = 5;
+
+std::string hex(unsigned value)
+{
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "0x%x", value);
+    return buf;
+}
+
+uint32_t frame_crc(const uint8_t *data, size_t length)
+{
+    return ~crc32c_update(0xFFFFFFFFu, data, length);
+}
+
+} // namespace
+
+FrameUpdater::FrameUpdater(ByteLink &link, const UpdateOptions &options)
+    : link_(link), options_(options)
+{
+}
+
+void FrameUpdater::begin_phase(const char *name)
+{
+    phases_.emplace_back();
+    phases_.back().name = name;
+    phases_.back().ns = link_.now_ns();
+}
+
+void FrameUpdater::end_phase(uint64_t bytes, uint32_t commands)
+{
+    phases_.back().ns = link_.now_ns() - phases_.back().ns;
+    phases_.back().bytes = bytes;
+    phases_.back().commands = commands;
+}
+
+/* Send one command frame and collect its response. The response status has to be
+   the expected one; any data after the status goes to data. */
+bool FrameUpdater::command(uint8_t cmd, const uint8_t *payload, size_t len, uint8_t expected,
+                           uint32_t timeoutMs, const char *what, std::vector<uint8_t> *data)
+{
+    frame_.resize(BL_FRAME_HDR_SIZE + len + BL_FRAME_CRC_SIZE);
+    frame_[0] = BL_FRAME_SOF;
+    frame_[1] = cmd;
+    put_le16(&frame_[2], static_cast<uint16_t>(len));
+    if (len != 0) {
+        std::memcpy(&frame_[BL_FRAME_HDR_SIZE], payload, len);
+    }
+    put_le32(&frame_[BL_FRAME_HDR_SIZE + len], frame_crc(&frame_[1], BL_FRAME_HDR_SIZE - 1 + len));
+
+    uint8_t hdr[BL_FRAME_HDR_SIZE];
+    if (!link_.send(frame_.data(), frame_.size()) || !link_.receive(hdr, sizeof(hdr), timeoutMs)) {
+        link_.discard();
+        error_ = std::string(what) + ": " + link_.last_error();
+        return false;
+    }
+
+    const uint16_t respLen = get_le16(&hdr[2]);
+    if ((hdr[0] != BL_FRAME_SOF) || (hdr[1] != (cmd | BL_FRAME_RESP)) || (respLen == 0)) {
+        link_.discard();
+        error_ = std::string(what) + ": bad response header";
+        return false;
+    }
+
+    frame_.assign(hdr, hdr + sizeof(hdr));
+    frame_.resize(BL_FRAME_HDR_SIZE + respLen + BL_FRAME_CRC_SIZE);
+    if (!link_.receive(&frame_[BL_FRAME_HDR_SIZE], respLen + BL_FRAME_CRC_SIZE, timeoutMs)) {
+        link_.discard();
+        error_ = std::string(what) + ": " + link_.last_error();
+        return false;
+    }
+    if (frame_crc(&frame_[1], BL_FRAME_HDR_SIZE - 1 + respLen) != get_le32(&frame_[BL_FRAME_HDR_SIZE + respLen])) {
+        error_ = std::string(what) + ": response CRC mismatch";
+        return false;
+    }
+
+    const uint8_t status = frame_[BL_FRAME_HDR_SIZE];
+    if (status != expected) {
+        error_ = std::string(what) + ": " + hpi::response_name(status) + " (" + hex(status) + ")";
+        return false;
+    }
+    if (data != nullptr) {
+        data->assign(frame_.begin() + BL_FRAME_HDR_SIZE + 1, frame_.begin() + BL_FRAME_HDR_SIZE + respLen);
+    }
+    return true;
+}
+
+/* The receiver comes up with the bootloader's HPI: retry until it answers. */
+bool FrameUpdater::connect()
+{
+    std::vector<uint8_t> info;
+    const uint64_t deadline = link_.now_ns() + static_cast<uint64_t>(options_.resetTimeoutMs) * 1000000u;
+
+    while (!command(BL_CMD_GET_INFO, nullptr, 0, hpi::RESP_SUCCESS, kConnectRetryMs, "connect", &info)) {
+        if (link_.now_ns() >= deadline) {
+            error_ += ", is the bootloader running?";
+            return false;
+        }
+    }
+    if (info.size() < sizeof(bl_cmd_info_t)) {
+        error_ = "connect: short device info";
+        return false;
+    }
+
+    deviceMode_ = info[0];
+    bootReason_ = info[1];
+    rowSize_ = get_le16(&info[4]);
+    readMax_ = get_le16(&info[6]);
+    error_.clear();
+    return true;
+}
+
+bool FrameUpdater::write_row(const ImageRow &row, const char *what)
+{
+    std::vector<uint8_t> payload(BL_CMD_WRITE_HDR_SIZE + rowSize_, 0);
+
+    put_le16(&payload[0], row.row);
+    std::memcpy(&payload[BL_CMD_WRITE_HDR_SIZE], row.data.data(), rowSize_);
+    if (!command(BL_CMD_FLASH_WRITE, payload.data(), payload.size(), hpi::RESP_SUCCESS, options_.cmdTimeoutMs, what)) {
+        error_ += " at row " + hex(row.row);
+        return false;
+    }
+    return true;
+}
+
+bool FrameUpdater::run(const UpdateImage &image)
+{
+    const uint8_t enter = 'P';
+
+    phases_.clear();
+    begin_phase("connect");
+    if (!connect()) {
+        return false;
+    }
+    if (rowSize_ != image.rowSize) {
+        error_ = "connect: device row size " + std::to_string(rowSize_) + ", image row size " +
+                 std::to_string(image.rowSize);
+        return false;
+    }
+    if (!command(BL_CMD_ENTER_FLASH_MODE, &enter, 1, hpi::RESP_SUCCESS, options_.cmdTimeoutMs, "enter flashing mode")) {
+        return false;
+    }
+    end_phase(0, 2);
+
+    begin_phase("program");
+    for (const ImageRow &row : image.rows) {
+        if (!write_row(row, "flash write")) {
+            return false;
+        }
+    }
+    end_phase(image.app_bytes(), static_cast<uint32_t>(image.rows.size()));
+
+    begin_phase("metadata");
+    if (!write_row(image.metadataRow, "metadata write")) {
+        return false;
+    }
+    end_phase(rowSize_, 1);
+
+    if (options_.verify) {
+        begin_phase("verify");
+        std::vector<uint8_t> readBack;
+        for (size_t i = 0; i <= image.rows.size(); i++) {
+            const bool isMd = (i == image.rows.size());
+            const ImageRow &row = isMd ? image.metadataRow : image.rows[i];
+
+            if (!read_flash(static_cast<uint32_t>(row.row) * rowSize_, rowSize_, &readBack)) {
+                return false;
+            }
+
+            /* The bootloader assigns the boot sequence number: leave it out of the compare. */
+            if (isMd) {
+                const size_t seqOffset = rowSize_ - kMetadataSize + kMdBootSeq;
+                std::memcpy(&readBack[seqOffset], &row.data[seqOffset], 4);
+            }
+            if (readBack != row.data) {
+                error_ = std::string("verify: ") + (isMd ? "metadata " : "") + "mismatch at row " + hex(row.row);
+                return false;
+            }
+        }
+        end_phase((image.rows.size() + 1) * rowSize_, static_cast<uint32_t>(image.rows.size() + 1));
+    }
+
+    begin_phase("validate");
+    if (!command(BL_CMD_VALIDATE_FW, &image.slot, 1, hpi::RESP_SUCCESS, options_.cmdTimeoutMs, "validate")) {
+        return false;
+    }
+    end_phase(0, 1);
+
+    return !options_.jump || jump();
+}
+
+bool FrameUpdater::jump()
+{
+    const uint8_t leave = 0;
+
+    begin_phase("jump");
+    if (!command(BL_CMD_ENTER_FLASH_MODE, &leave, 1, hpi::RESP_SUCCESS, options_.cmdTimeoutMs, "exit flashing mode") ||
+        !command(BL_CMD_RESET, nullptr, 0, hpi::RESP_SUCCESS, options_.cmdTimeoutMs, "reset")) {
+        return false;
+    }
+    end_phase(0, 2);
+    return true;
+}
+
+bool FrameUpdater::read_flash(uint32_t addr, uint32_t length, std::vector<uint8_t> *data)
+{
+    std::vector<uint8_t> chunkData;
+
+    data->clear();
+    readCommands_ = 0;
+    if (readMax_ == 0) {
+        error_ = "flash read: not connected";
+        return false;
+    }
+    while (data->size() < length) {
+        const uint16_t chunk = static_cast<uint16_t>(std::min<size_t>(readMax_, length - data->size()));
+        uint8_t payload[6];
+        put_le32(&payload[0], addr);
+        put_le16(&payload[4], chunk);
+
+        if (!command(BL_CMD_FLASH_READ, payload, sizeof(payload), hpi::RESP_FLASH_DATA_AVAIL, options_.cmdTimeoutMs,
+                     "flash read", &chunkData)) {
+            error_ += " at " + hex(addr);
+            return false;
+        }
+        if (chunkData.size() != chunk) {
+            error_ = "flash read: short response at " + hex(addr);
+            return false;
+        }
+        readCommands_++;
+        data->insert(data->end(), chunkData.begin(), chunkData.end());
+        addr += chunk;
+    }
+    return true;
+}
+
+} // namespace pmg1
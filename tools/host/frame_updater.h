@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name: frame_updater.h
+*
+* Description: Firmware update over the framed command layer of the
+*              bootloader (bl_cmd.h), as used by the UART transport.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_FRAME_UPDATER_H
+#define PMG1_HOST_FRAME_UPDATER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "image.h"
+#include "uart_link.h"
+#include "updater.h"
+
+namespace pmg1 {
+
+/* Same sequence as Updater: enter flashing mode, program the rows and the metadata
+ * row, read back, validate and optionally reset into the new image. The framed
+ * transports are only served by the bootloader, so an application cannot be asked
+ * to return to it from here.
+ */
+class FrameUpdater {
+public:
+    FrameUpdater(ByteLink &link, const UpdateOptions &options = UpdateOptions());
+
+    /* Run the whole sequence. On failure, error() describes the failing step. */
+    bool run(const UpdateImage &image);
+
+    /* Leave flashing mode and reset the device. */
+    bool jump();
+
+    /* Read any span of flash above the bootloader, in commands of up to the device
+       reported read size. The device has to be in flashing mode. */
+    bool read_flash(uint32_t addr, uint32_t length, std::vector<uint8_t> *data);
+
+    /* Flash read commands issued by the last read_flash() call. */
+    uint32_t read_commands() const { return readCommands_; }
+
+    const std::vector<PhaseStats> &phases() const { return phases_; }
+    const std::string &error() const { return error_; }
+    uint8_t device_mode() const { return deviceMode_; }
+    uint8_t boot_reason() const { return bootReason_; }
+
+private:
+    bool connect();
+    bool command(uint8_t cmd, const uint8_t *payload, size_t len, uint8_t expected, uint32_t timeoutMs,
+                 const char *what, std::vector<uint8_t> *data = nullptr);
+    bool write_row(const ImageRow &row, const char *what);
+    void begin_phase(const char *name);
+    void end_phase(uint64_t bytes, uint32_t commands);
+
+    ByteLink &link_;
+    UpdateOptions options_;
+    std::vector<PhaseStats> phases_;
+    std::string error_;
+    uint8_t deviceMode_ = 0;
+    uint8_t bootReason_ = 0;
+    uint16_t rowSize_ = 0;
+    uint16_t readMax_ = 0;
+    uint32_t readCommands_ = 0;
+    std::vector<uint8_t> frame_;
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_FRAME_UPDATER_H */
@@ -0,0 +1,65 @@
+/******************************************************************************
+* File Name: hpi_proto.cpp
+*
+* Description: HPI helpers used by the PMG1 bootloader host tools.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "hpi_proto.h"
+
+namespace pmg1 {
+namespace hpi {
+
+const char *response_name(uint8_t code)
+{
+    switch (code) {
+    case RESP_NONE:                return "NONE";
+    case RESP_SUCCESS:             return "SUCCESS";
+    case RESP_FLASH_DATA_AVAIL:    return "FLASH_DATA_AVAILABLE";
+    case RESP_INVALID_COMMAND:     return "INVALID_COMMAND";
+    case RESP_FLASH_UPDATE_FAILED: return "FLASH_UPDATE_FAILED";
+    case RESP_INVALID_FW:          return "INVALID_FW";
+    case RESP_INVALID_ARGUMENT:    return "INVALID_ARGUMENT";
+    case RESP_NOT_SUPPORTED:       return "NOT_SUPPORTED";
+    case RESP_TRANSACTION_FAILED:  return "TRANSACTION_FAILED";
+    case RESP_BUSY:                return "BUSY";
+    case RESP_RESET_COMPLETE:      return "RESET_COMPLETE";
+    case HPI_EXT_EVENT_CHECK_DONE: return "CHECK_DONE";
+    default:                       return "UNKNOWN";
+    }
+}
+
+} // namespace hpi
+} // namespace pmg1
@@ -0,0 +1,117 @@
+/******************************************************************************
+* File Name: hpi_proto.h
+*
+* Description: HPI register map and codes used by the PMG1 bootloader host
+*              tools. The bootloader specific registers come from
+*              src/system/hpi_ext.h.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_HPI_PROTO_H
+#define PMG1_HOST_HPI_PROTO_H
+
+#include <cstdint>
+
+extern "C" {
+#include "hpi_ext.h"
+}
+
+namespace pmg1 {
+namespace hpi {
+
+/* Device register space (16-bit register addresses). */
+constexpr uint16_t REG_DEVICE_MODE       = 0x0000;
+constexpr uint16_t REG_BOOT_MODE_REASON  = 0x0001;
+constexpr uint16_t REG_SILICON_ID        = 0x0002;
+constexpr uint16_t REG_BL_LAST_ROW       = 0x0004;
+constexpr uint16_t REG_INTR              = 0x0006;
+constexpr uint16_t REG_JUMP_TO_BOOT      = 0x0007;
+constexpr uint16_t REG_RESET             = 0x0008;
+constexpr uint16_t REG_ENTER_FLASH_MODE  = 0x000A;
+constexpr uint16_t REG_VALIDATE_FW       = 0x000B;
+constexpr uint16_t REG_FLASH_RW          = 0x000C;
+constexpr uint16_t REG_ALL_VERSION       = 0x0010;
+constexpr uint16_t REG_FW2_LOCATION      = 0x0028;
+constexpr uint16_t REG_FW1_LOCATION      = 0x002A;
+constexpr uint16_t REG_RESPONSE          = 0x007E;
+constexpr uint16_t REG_FLASH_MEM         = 0x0200;
+
+/* Command signatures. */
+constexpr uint8_t SIG_JUMP_TO_BOOT       = 'J';
+constexpr uint8_t SIG_JUMP_TO_ALT_FW     = 'A';
+constexpr uint8_t SIG_RESET              = 'R';
+constexpr uint8_t SIG_FLASH_MODE         = 'P';
+constexpr uint8_t SIG_FLASH_RW           = 'F';
+
+constexpr uint8_t FLASH_CMD_READ         = 0x00;
+constexpr uint8_t FLASH_CMD_WRITE        = 0x01;
+
+/* Largest span of one HPI_EXT_REG_FLASH_READ command. */
+constexpr uint16_t FLASH_READ_MAX        = HPI_EXT_FLASH_READ_MAX;
+
+/* Largest span of flash_read(): PMG1_FLASH_READ_MAX_SIZE, the UART read limit. */
+constexpr uint16_t FLASH_SPAN_MAX        = 256;
+
+constexpr uint8_t RESET_TYPE_I2C         = 0x00;
+constexpr uint8_t RESET_TYPE_DEVICE      = 0x01;
+
+/* INTR register: device interrupt pending, cleared by writing 1. */
+constexpr uint8_t INTR_DEV               = 0x01;
+
+/* DEVICE_MODE register. */
+constexpr uint8_t MODE_FW_MASK           = 0x03;
+constexpr uint8_t MODE_BOOTLOADER        = 0x00;
+
+/* Response codes. */
+enum Response : uint8_t {
+    RESP_NONE                = 0x00,
+    RESP_SUCCESS             = 0x02,
+    RESP_FLASH_DATA_AVAIL    = 0x03,
+    RESP_INVALID_COMMAND     = 0x05,
+    RESP_FLASH_UPDATE_FAILED = 0x07,
+    RESP_INVALID_FW          = 0x08,
+    RESP_INVALID_ARGUMENT    = 0x09,
+    RESP_NOT_SUPPORTED       = 0x0A,
+    RESP_TRANSACTION_FAILED  = 0x0C,
+    RESP_BUSY                = 0x0E,
+    RESP_RESET_COMPLETE      = 0x80,
+};
+
+const char *response_name(uint8_t code);
+
+} // namespace hpi
+} // namespace pmg1
+
+#endif /* PMG1_HOST_HPI_PROTO_H */
@@ -0,0 +1,259 @@
+/******************************************************************************
+* File Name: i2c_transport.cpp
+*
+* Description: Transport over Linux i2c-dev.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "i2c_transport.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "hpi_proto.h"
+
+namespace pmg1 {
+
+namespace {
+
+/* Poll interval of the INTR register when EC_INT is not wired. */
+constexpr uint32_t kPollIntervalUs = 500;
+
+} // namespace
+
+I2cTransport::I2cTransport(const std::string &bus, uint8_t slaveAddr,
+                           const std::string &gpioChip, int gpioLine)
+    : bus_(bus), slaveAddr_(slaveAddr), gpioChip_(gpioChip), gpioLine_(gpioLine)
+{
+}
+
+I2cTransport::~I2cTransport()
+{
+    if (eventFd_ >= 0) {
+        ::close(eventFd_);
+    }
+    if (busFd_ >= 0) {
+        ::close(busFd_);
+    }
+}
+
+bool I2cTransport::open()
+{
+    busFd_ = ::open(bus_.c_str(), O_RDWR | O_CLOEXEC);
+    if (busFd_ < 0) {
+        error_ = bus_ + ": " + std::strerror(errno);
+        return false;
+    }
+
+    if (gpioChip_.empty() || (gpioLine_ < 0)) {
+        return true;
+    }
+
+    const int chipFd = ::open(gpioChip_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (chipFd < 0) {
+        error_ = gpioChip_ + ": " + std::strerror(errno);
+        return false;
+    }
+
+    /* EC_INT is active low: a falling edge signals a new event. */
+    struct gpioevent_request req;
+    std::memset(&req, 0, sizeof(req));
+    req.lineoffset = static_cast<uint32_t>(gpioLine_);
+    req.handleflags = GPIOHANDLE_REQUEST_INPUT;
+    req.eventflags = GPIOEVENT_REQUEST_FALLING_EDGE;
+    std::snprintf(req.consumer_label, sizeof(req.consumer_label), "pmg1-ec-int");
+
+    const int rc = ::ioctl(chipFd, GPIO_GET_LINEEVENT_IOCTL, &req);
+    const int err = errno;
+    ::close(chipFd);
+    if (rc < 0) {
+        error_ = gpioChip_ + ": line " + std::to_string(gpioLine_) + ": " + std::strerror(err);
+        return false;
+    }
+
+    eventFd_ = req.fd;
+    ::fcntl(eventFd_, F_SETFL, ::fcntl(eventFd_, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+bool I2cTransport::transfer(const BusOp *ops, size_t count)
+{
+    std::vector<struct i2c_msg> msgs;
+    std::vector<std::vector<uint8_t>> bufs;
+
+    msgs.reserve(count * 2);
+    bufs.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const BusOp &op = ops[i];
+        /* Register address, LSB first. */
+        std::vector<uint8_t> buf = {static_cast<uint8_t>(op.reg), static_cast<uint8_t>(op.reg >> 8)};
+
+        if (op.kind == BusOp::WRITE) {
+            buf.insert(buf.end(), op.data, op.data + op.len);
+        }
+        bufs.push_back(std::move(buf));
+
+        struct i2c_msg msg;
+        msg.addr = slaveAddr_;
+        msg.flags = 0;
+        msg.len = static_cast<uint16_t>(bufs.back().size());
+        msg.buf = bufs.back().data();
+        msgs.push_back(msg);
+
+        if (op.kind == BusOp::READ) {
+            msg.flags = I2C_M_RD;
+            msg.len = static_cast<uint16_t>(op.len);
+            msg.buf = op.data;
+            msgs.push_back(msg);
+        }
+    }
+
+    /* The adapter limits the number of messages per combined transaction. */
+    for (size_t first = 0; first < msgs.size(); first += I2C_RDWR_IOCTL_MAX_MSGS) {
+        struct i2c_rdwr_ioctl_data xfer;
+        xfer.msgs = &msgs[first];
+        xfer.nmsgs = static_cast<uint32_t>(std::min<size_t>(msgs.size() - first, I2C_RDWR_IOCTL_MAX_MSGS));
+
+        if (::ioctl(busFd_, I2C_RDWR, &xfer) < 0) {
+            error_ = bus_ + ": " + std::strerror(errno);
+            return false;
+        }
+    }
+    return true;
+}
+
+void I2cTransport::drain_events()
+{
+    struct gpioevent_data event;
+
+    while (::read(eventFd_, &event, sizeof(event)) == static_cast<ssize_t>(sizeof(event))) {
+    }
+}
+
+bool I2cTransport::line_asserted(bool *asserted)
+{
+    if (eventFd_ >= 0) {
+        struct gpiohandle_data values;
+        if (::ioctl(eventFd_, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &values) < 0) {
+            error_ = gpioChip_ + ": " + std::strerror(errno);
+            return false;
+        }
+        *asserted = (values.values[0] == 0);
+        return true;
+    }
+
+    uint8_t intr = 0;
+    if (!read(hpi::REG_INTR, &intr, 1)) {
+        return false;
+    }
+    *asserted = ((intr & hpi::INTR_DEV) != 0);
+    return true;
+}
+
+bool I2cTransport::interrupt_asserted(bool *asserted)
+{
+    if (eventFd_ >= 0) {
+        drain_events();
+    }
+    return line_asserted(asserted);
+}
+
+bool I2cTransport::wait_interrupt(uint32_t timeoutMs)
+{
+    const uint64_t deadline = now_ns() + static_cast<uint64_t>(timeoutMs) * 1000000u;
+    bool asserted = false;
+
+    for (;;) {
+        /* Drop stale edges first so that only the line level decides. */
+        if (eventFd_ >= 0) {
+            drain_events();
+        }
+        if (!line_asserted(&asserted)) {
+            return false;
+        }
+        if (asserted) {
+            return true;
+        }
+
+        const uint64_t now = now_ns();
+        if (now >= deadline) {
+            error_ = "timeout waiting for EC_INT";
+            return false;
+        }
+
+        if (eventFd_ >= 0) {
+            struct pollfd pfd = {eventFd_, POLLIN, 0};
+            const int waitMs = static_cast<int>((deadline - now + 999999u) / 1000000u);
+            if ((::poll(&pfd, 1, waitMs) < 0) && (errno != EINTR)) {
+                error_ = gpioChip_ + ": " + std::strerror(errno);
+                return false;
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(kPollIntervalUs));
+        }
+    }
+}
+
+uint64_t I2cTransport::now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void I2cTransport::sleep_ms(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+std::string I2cTransport::name() const
+{
+    char addr[8];
+    std::snprintf(addr, sizeof(addr), "0x%02x", slaveAddr_);
+    return bus_ + "@" + addr;
+}
+
+} // namespace pmg1
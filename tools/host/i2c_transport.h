@@ -0,0 +1,83 @@
+/******************************************************************************
+* File Name: i2c_transport.h
+*
+* Description: Transport over Linux i2c-dev. EC_INT is taken from a GPIO
+*              character device line when one is given; otherwise the HPI
+*              interrupt register is polled.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_I2C_TRANSPORT_H
+#define PMG1_HOST_I2C_TRANSPORT_H
+
+#include "transport.h"
+
+namespace pmg1 {
+
+class I2cTransport : public Transport {
+public:
+    /* bus: /dev/i2c-N. gpioChip: /dev/gpiochipN, empty if EC_INT is not wired. */
+    I2cTransport(const std::string &bus, uint8_t slaveAddr,
+                 const std::string &gpioChip = std::string(), int gpioLine = -1);
+    ~I2cTransport() override;
+
+    I2cTransport(const I2cTransport &) = delete;
+    I2cTransport &operator=(const I2cTransport &) = delete;
+
+    bool open();
+
+    bool transfer(const BusOp *ops, size_t count) override;
+    bool wait_interrupt(uint32_t timeoutMs) override;
+    bool interrupt_asserted(bool *asserted) override;
+    int interrupt_fd() const override { return eventFd_; }
+    uint64_t now_ns() override;
+    void sleep_ms(uint32_t ms) override;
+    std::string name() const override;
+
+private:
+    bool line_asserted(bool *asserted);
+    void drain_events();
+
+    std::string bus_;
+    uint8_t slaveAddr_;
+    std::string gpioChip_;
+    int gpioLine_;
+    int busFd_ = -1;
+    int eventFd_ = -1;
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_I2C_TRANSPORT_H */
@@ -0,0 +1,211 @@
+/******************************************************************************
+* File Name: image.cpp
+*
+* Description: Row image of a firmware update.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "image.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "crc32c.h"
+
+extern "C" {
+#include "sha256.h"
+}
+
+namespace pmg1 {
+
+namespace {
+
+std::string hex(uint32_t value)
+{
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "0x%08x", value);
+    return buf;
+}
+
+} // namespace
+
+void image_digest(const uint8_t *data, size_t length, uint8_t *digest)
+{
+    sha256_ctx_t ctx;
+
+    sha256_init(&ctx);
+    sha256_update(&ctx, data, static_cast<uint32_t>(length));
+    sha256_final(&ctx, digest);
+}
+
+Metadata UpdateImage::metadata() const
+{
+    return Metadata::parse(&metadataRow.data[rowSize - kMetadataSize]);
+}
+
+bool make_image_from_segments(const TargetInfo &target, uint8_t slot, const std::vector<Segment> &segments,
+                              const LayoutOptions &options, UpdateImage *image,
+                              std::vector<SegmentCrc> *manifest, std::vector<std::string> *notes,
+                              std::string *error)
+{
+    const uint16_t rowSize = target.rowSize;
+    const uint16_t mdRow = options.rwwLayout ? slot_metadata_row_rww(target, slot) : slot_metadata_row(target, slot);
+    const uint32_t mdStart = options.rwwLayout ? static_cast<uint32_t>(mdRow) * rowSize
+                                               : static_cast<uint32_t>(slot_metadata_row(target, std::max<uint8_t>(slot, 2))) * rowSize;
+    std::vector<Segment> app;
+
+    for (const Segment &seg : segments) {
+        if ((static_cast<uint64_t>(seg.addr) + seg.size) > target.flashSize) {
+            notes->push_back("skipped segment at " + hex(seg.addr) + ": outside the flash");
+        } else if ((seg.addr + seg.size) > mdStart) {
+            /* The metadata row is generated here, not taken from the application. */
+            notes->push_back("skipped segment at " + hex(seg.addr) + ": inside the metadata rows");
+        } else if (seg.size != 0) {
+            app.push_back(seg);
+        }
+    }
+    if (app.empty()) {
+        *error = "no application data";
+        return false;
+    }
+
+    const uint32_t start = app.front().addr;
+    uint32_t end = 0;
+    for (const Segment &seg : app) {
+        end = std::max<uint32_t>(end, seg.addr + static_cast<uint32_t>(seg.size));
+    }
+    if ((start % rowSize) != 0) {
+        *error = "application does not start on a flash row boundary";
+        return false;
+    }
+    if ((start / rowSize) <= target.blLastRow) {
+        *error = "application overlaps the bootloader";
+        return false;
+    }
+    if (options.rwwLayout && ((start / rowSize) < static_cast<uint32_t>(mdRow + 1 - target.row_count() / 2))) {
+        /* The boot-loader refuses an image that leaves the flash macro of its metadata row. */
+        *error = "application starts below the flash macro of slot " + std::to_string(slot);
+        return false;
+    }
+
+    /* Erased flash reads as 0x00: gaps between segments are filled with zeros. */
+    std::vector<uint8_t> flash(((end - start) + rowSize - 1) / rowSize * rowSize, 0);
+    uint32_t covered = start;
+    for (const Segment &seg : app) {
+        if (seg.addr < covered) {
+            *error = "overlapping segments at " + hex(seg.addr);
+            return false;
+        }
+        std::memcpy(&flash[seg.addr - start], seg.data, seg.size);
+        covered = seg.addr + static_cast<uint32_t>(seg.size);
+        manifest->push_back({seg.addr, static_cast<uint32_t>(seg.size), crc32c(seg.data, seg.size)});
+    }
+
+    /* Rows at the end that are all erased need not be sent; the image size shrinks with them. */
+    size_t rowCount = flash.size() / rowSize;
+    if (options.dropErasedTail) {
+        while ((rowCount > 1) &&
+               std::all_of(&flash[(rowCount - 1) * rowSize], &flash[rowCount * rowSize],
+                           [](uint8_t b) { return b == 0; })) {
+            rowCount--;
+        }
+        end = std::min<uint32_t>(end, start + static_cast<uint32_t>(rowCount * rowSize));
+    }
+
+    image->rowSize = rowSize;
+    image->slot = slot;
+    image->rows.clear();
+    for (size_t i = 0; i < rowCount; i++) {
+        ImageRow row;
+        row.row = static_cast<uint16_t>(start / rowSize + i);
+        row.data.assign(&flash[i * rowSize], &flash[(i + 1) * rowSize]);
+        image->rows.push_back(std::move(row));
+    }
+
+    Metadata md;
+    md.appFwStart = start;
+    md.appFwSize = end - start;
+    md.bootWaitTime = options.bootWaitTime;
+    md.bootLastRow = static_cast<uint16_t>(start / rowSize - 1);
+    md.metadataValid = kMetadataValidSig;
+    md.fwCrc32 = crc32c(flash.data(), md.appFwSize);
+    image_digest(flash.data(), md.appFwSize, md.fwDigest.data());
+
+    image->metadataRow.row = mdRow;
+    image->metadataRow.data.assign(rowSize, 0);
+    md.serialize(&image->metadataRow.data[rowSize - kMetadataSize]);
+    return true;
+}
+
+bool make_image_from_binary(const TargetInfo &target, uint8_t slot, uint16_t firstRow,
+                            const std::vector<uint8_t> &binary, uint16_t bootWaitTime,
+                            UpdateImage *image, std::string *error)
+{
+    const Segment seg = {static_cast<uint32_t>(firstRow) * target.rowSize, binary.data(), binary.size(),
+                         static_cast<uint32_t>(firstRow) * target.rowSize};
+    std::vector<SegmentCrc> manifest;
+    std::vector<std::string> notes;
+    LayoutOptions options;
+
+    options.bootWaitTime = bootWaitTime;
+    options.dropErasedTail = false;
+    if (!make_image_from_segments(target, slot, std::vector<Segment>(1, seg), options, image,
+                                  &manifest, &notes, error)) {
+        return false;
+    }
+    if (!notes.empty()) {
+        *error = "image does not fit between the bootloader and the metadata rows";
+        return false;
+    }
+    return true;
+}
+
+bool read_file(const std::string &path, std::vector<uint8_t> *data, std::string *error)
+{
+    std::ifstream in(path, std::ios::binary);
+
+    if (!in) {
+        *error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    data->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+} // namespace pmg1
@@ -0,0 +1,117 @@
+/******************************************************************************
+* File Name: image.h
+*
+* Description: Row image of a firmware update: the application rows of one
+*              slot followed by its metadata row.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_IMAGE_H
+#define PMG1_HOST_IMAGE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "metadata.h"
+#include "segments.h"
+#include "target.h"
+
+namespace pmg1 {
+
+struct ImageRow {
+    uint16_t row;
+    std::vector<uint8_t> data;          /* One full flash row. */
+};
+
+struct UpdateImage {
+    uint16_t rowSize = 0;
+    uint8_t slot = 0;
+    std::vector<ImageRow> rows;         /* Application rows, ascending. */
+    ImageRow metadataRow;               /* Written last. */
+
+    Metadata metadata() const;
+    size_t app_bytes() const { return rows.size() * rowSize; }
+};
+
+/* Metadata row of a slot: rows are packed downwards from the last flash row. */
+inline uint16_t slot_metadata_row(const TargetInfo &target, uint8_t slot)
+{
+    return static_cast<uint16_t>(target.last_row() - (slot - 1));
+}
+
+/* Metadata row of a slot in the read-while-write layout (PMG1_FW_RWW_LAYOUT): the top
+   row of flash macro slot - 1. The parts taking it have two macros of equal size. */
+inline uint16_t slot_metadata_row_rww(const TargetInfo &target, uint8_t slot)
+{
+    return static_cast<uint16_t>((target.row_count() / 2) * slot - 1);
+}
+
+/* CRC-32C of one input segment, for the segment manifest. */
+struct SegmentCrc {
+    uint32_t addr;
+    uint32_t size;
+    uint32_t crc;
+};
+
+struct LayoutOptions {
+    uint16_t bootWaitTime = kWaitTimeDefault;
+    bool dropErasedTail = true;         /* Leave out trailing rows that read as erased (0x00). */
+    bool rwwLayout = false;             /* PMG1_FW_RWW_LAYOUT: slot n lies in flash macro n - 1. */
+};
+
+/* SHA-256 of an image as stored in the fwDigest metadata field, computed with the
+ * boot-loader's own kernel. */
+void image_digest(const uint8_t *data, size_t length, uint8_t *digest);
+
+/* Lay out application segments in flash rows and build the metadata row.
+ * Segments outside the flash or inside the metadata rows are skipped and
+ * reported in notes. */
+bool make_image_from_segments(const TargetInfo &target, uint8_t slot, const std::vector<Segment> &segments,
+                              const LayoutOptions &options, UpdateImage *image,
+                              std::vector<SegmentCrc> *manifest, std::vector<std::string> *notes,
+                              std::string *error);
+
+/* Build an update image from a raw application binary placed at firstRow. */
+bool make_image_from_binary(const TargetInfo &target, uint8_t slot, uint16_t firstRow,
+                            const std::vector<uint8_t> &binary, uint16_t bootWaitTime,
+                            UpdateImage *image, std::string *error);
+
+/* Read a whole file. */
+bool read_file(const std::string &path, std::vector<uint8_t> *data, std::string *error);
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_IMAGE_H */
@@ -0,0 +1,248 @@
+/******************************************************************************
+* File Name: layout_main.cpp
+*
+* Description: pmg1-layout. Reads the linked boot-loader image and writes the
+*              flash layout that follows from it for the application linker
+*              scripts.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "image.h"
+#include "segments.h"
+#include "target.h"
+
+using namespace pmg1;
+
+namespace {
+
+struct Layout {
+    uint32_t blEnd;             /* End of the boot-loader image. */
+    uint16_t blLastRow;         /* Row holding the last byte of the image. */
+    uint32_t appStart;          /* First application byte: the row after blLastRow. */
+    uint32_t appLimit;          /* First metadata row. */
+    uint32_t slotSize;          /* appLimit - appStart split evenly over the slots, in whole rows. */
+    uint16_t rowSize;
+    bool rww;                   /* Read-while-write layout: slot 1 ends at appLimit, slot 2 has its own macro. */
+    uint32_t slot2Start;        /* Read-while-write layout: first byte of flash macro 1. */
+    uint32_t slot2Limit;        /* Read-while-write layout: metadata row of slot 2. */
+};
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: pmg1-layout --target NAME [--slots N | --rww] -o OUTPUT.h|.ld|.icf [-o ...]\n"
+        "                   BOOTLOADER.elf|BOOTLOADER.hex\n"
+        "targets: %s\n", target_names().c_str());
+}
+
+bool ends_with(const std::string &str, const char *suffix)
+{
+    const std::string s(suffix);
+    return (str.size() >= s.size()) && (str.compare(str.size() - s.size(), s.size(), s) == 0);
+}
+
+/* Same rule as flash_get_bl_last_row(): the image ends in the row holding its last byte.
+   Segments outside the flash (the .cymeta and protection sections) are not placed by
+   the boot-loader. In the read-while-write layout (PMG1_FW_RWW_LAYOUT), each of the two
+   slots ends below the metadata row at the top of its flash macro. */
+bool make_layout(const TargetInfo &target, unsigned slots, bool rww, const std::vector<Segment> &segments,
+                 Layout *layout, std::string *error)
+{
+    uint32_t start = target.flashSize;
+    uint32_t end = 0;
+
+    for (const Segment &seg : segments) {
+        if ((seg.size == 0) || (seg.addr >= target.flashSize)) {
+            continue;
+        }
+        start = std::min<uint32_t>(start, seg.addr);
+        end = std::max<uint32_t>(end, seg.addr + static_cast<uint32_t>(seg.size));
+    }
+    if (end == 0) {
+        *error = "no segment in flash";
+        return false;
+    }
+    if (start != 0) {
+        *error = "image does not start at address 0, not a boot-loader";
+        return false;
+    }
+
+    layout->rowSize = target.rowSize;
+    layout->blEnd = end;
+    layout->blLastRow = static_cast<uint16_t>((end - 1) >> target.row_shift());
+    layout->appStart = static_cast<uint32_t>(layout->blLastRow + 1) * target.rowSize;
+    layout->rww = rww;
+    if (rww) {
+        layout->appLimit = static_cast<uint32_t>(slot_metadata_row_rww(target, 1)) * target.rowSize;
+        layout->slot2Start = layout->appLimit + target.rowSize;
+        layout->slot2Limit = static_cast<uint32_t>(slot_metadata_row_rww(target, 2)) * target.rowSize;
+    } else {
+        layout->appLimit = static_cast<uint32_t>(target.row_count() - slots) * target.rowSize;
+        layout->slot2Start = 0;
+        layout->slot2Limit = 0;
+    }
+    if (layout->appStart >= layout->appLimit) {
+        *error = "boot-loader runs into the metadata rows";
+        return false;
+    }
+    layout->slotSize = rww ? (layout->appLimit - layout->appStart)
+                           : ((layout->appLimit - layout->appStart) / target.rowSize / slots) * target.rowSize;
+    return true;
+}
+
+bool write_layout(const std::string &path, const std::string &input, const Layout &layout, std::string *error)
+{
+    const struct {
+        const char *name;
+        uint32_t value;
+        const char *comment;
+        bool rwwOnly;
+    } values[] = {
+        {"PMG1_BL_IMAGE_END",    layout.blEnd,     "End of the boot-loader image.", false},
+        {"PMG1_BL_LAST_ROW",     layout.blLastRow, "Last boot-loader row.", false},
+        {"PMG1_APP_FLASH_START", layout.appStart,  "First application byte.", false},
+        {"PMG1_APP_FLASH_LIMIT", layout.appLimit,  "End of the application area: the first metadata row.", false},
+        {"PMG1_APP_SLOT_SIZE",   layout.slotSize,  "Application area split evenly over the slots, or slot 1 alone.", false},
+        {"PMG1_BL_LAYOUT_ROW_SIZE", layout.rowSize,   "Flash row size.", false},
+        {"PMG1_APP_SLOT2_START", layout.slot2Start, "First byte of slot 2: the start of flash macro 1.", true},
+        {"PMG1_APP_SLOT2_LIMIT", layout.slot2Limit, "End of slot 2: its metadata row.", true},
+    };
+    const bool header = ends_with(path, ".h");
+    const bool icf = ends_with(path, ".icf");
+
+    if (!header && !icf && !ends_with(path, ".ld")) {
+        *error = path + ": unknown output format, use .h, .ld or .icf";
+        return false;
+    }
+
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        *error = path + ": cannot create file";
+        return false;
+    }
+
+    std::fprintf(file, "/* Boot-loader flash layout of %s, generated by pmg1-layout. */\n", input.c_str());
+    if (header) {
+        std::fprintf(file, "#ifndef PMG1_BL_LAYOUT_H\n#define PMG1_BL_LAYOUT_H\n");
+    }
+    for (const auto &v : values) {
+        if (v.rwwOnly && !layout.rww) {
+            continue;
+        }
+        std::fprintf(file, "\n/* %s */\n", v.comment);
+        if (header) {
+            std::fprintf(file, "#define %-24s (0x%08x)\n", v.name, v.value);
+        } else if (icf) {
+            std::fprintf(file, "define exported symbol %-24s = 0x%08x;\n", v.name, v.value);
+        } else {
+            std::fprintf(file, "%-24s = 0x%08x;\n", v.name, v.value);
+        }
+    }
+    if (header) {
+        std::fprintf(file, "\n#endif /* PMG1_BL_LAYOUT_H */\n");
+    }
+    return std::fclose(file) == 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string targetName;
+    std::string input;
+    std::vector<std::string> outputs;
+    unsigned slots = 2;
+    bool rww = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasArg = (i + 1) < argc;
+
+        if ((arg == "--target") && hasArg) {
+            targetName = argv[++i];
+        } else if ((arg == "--slots") && hasArg) {
+            slots = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--rww") {
+            rww = true;
+        } else if ((arg == "-o") && hasArg) {
+            outputs.push_back(argv[++i]);
+        } else if ((arg[0] != '-') && input.empty()) {
+            input = arg;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    const TargetInfo *target = find_target(targetName);
+    if ((target == nullptr) || (slots < 2) || (slots > 4) || (rww && (slots != 2)) || input.empty() ||
+        outputs.empty()) {
+        usage();
+        return 2;
+    }
+
+    std::string error;
+    SegmentFile file;
+    Layout layout;
+
+    if (!file.load(input, &error) || !make_layout(*target, slots, rww, file.segments(), &layout, &error)) {
+        std::fprintf(stderr, "pmg1-layout: %s: %s\n", input.c_str(), error.c_str());
+        return 1;
+    }
+    for (const std::string &output : outputs) {
+        if (!write_layout(output, input, layout, &error)) {
+            std::fprintf(stderr, "pmg1-layout: %s\n", error.c_str());
+            return 1;
+        }
+    }
+
+    const int saved = static_cast<int>(target->blLastRow) - layout.blLastRow;
+    std::printf("%s: boot-loader 0x%x bytes, last row 0x%x (%+d application rows against a 7 KB boot-loader)\n",
+                input.c_str(), layout.blEnd, layout.blLastRow, saved);
+    if (rww) {
+        std::printf("slot 1 0x%08x-0x%08x, slot 2 0x%08x-0x%08x, one flash macro each\n", layout.appStart,
+                    layout.appLimit - 1, layout.slot2Start, layout.slot2Limit - 1);
+    } else {
+        std::printf("application 0x%08x-0x%08x, %u slots of 0x%x bytes\n", layout.appStart, layout.appLimit - 1,
+                    slots, layout.slotSize);
+    }
+    return 0;
+}
@@ -0,0 +1,710 @@
+/******************************************************************************
+* File Name: m0_core.cpp
+*
+* Description: ARMv6-M instruction set interpreter with a cycle model.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "m0_core.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace pmg1 {
+
+const M0Timing kCortexM0     = {"cortex-m0",     3, 4, 3, 3, 3, 4};
+const M0Timing kCortexM0Plus = {"cortex-m0plus", 2, 3, 2, 2, 2, 3};
+
+namespace {
+
+/* Return address given to the called function. Branching to it ends the call. */
+constexpr uint32_t kReturnMagic = 0xF0000000;
+
+constexpr unsigned kSp = 13;
+constexpr unsigned kLr = 14;
+constexpr unsigned kPc = 15;
+
+std::string hex32(uint32_t value)
+{
+    char text[16];
+    std::snprintf(text, sizeof(text), "0x%08X", value);
+    return text;
+}
+
+uint32_t sign_extend(uint32_t value, unsigned bits)
+{
+    const uint32_t sign = 1u << (bits - 1);
+    return (value ^ sign) - sign;
+}
+
+unsigned popcount(uint32_t value)
+{
+    unsigned count = 0;
+    for (; value != 0; value &= value - 1) {
+        count++;
+    }
+    return count;
+}
+
+} // namespace
+
+M0Core::M0Core(uint32_t flashSize, uint32_t ramSize, const M0Config &config)
+    : config_(config), flash_(flashSize, 0), ram_(ramSize, 0)
+{
+}
+
+uint8_t *M0Core::host_ptr(uint32_t addr, unsigned size)
+{
+    if ((addr < flash_.size()) && (size <= flash_.size() - addr)) {
+        return &flash_[addr];
+    }
+    if ((addr >= kM0RamBase) && (addr - kM0RamBase < ram_.size()) && (size <= ram_.size() - (addr - kM0RamBase))) {
+        return &ram_[addr - kM0RamBase];
+    }
+    return nullptr;
+}
+
+bool M0Core::write(uint32_t addr, const uint8_t *data, size_t size)
+{
+    uint8_t *p = host_ptr(addr, static_cast<unsigned>(size));
+    if ((p == nullptr) || (size > 0xFFFFFFFFu)) {
+        return false;
+    }
+    std::memcpy(p, data, size);
+    return true;
+}
+
+bool M0Core::read(uint32_t addr, uint8_t *data, size_t size) const
+{
+    uint8_t *p = const_cast<M0Core *>(this)->host_ptr(addr, static_cast<unsigned>(size));
+    if (p == nullptr) {
+        return false;
+    }
+    std::memcpy(data, p, size);
+    return true;
+}
+
+bool M0Core::fail(const std::string &what)
+{
+    if (!stopped_) {
+        stopped_ = true;
+        stop_ = M0Stop::Fault;
+        fault_ = what + " at pc " + hex32(r_[kPc]);
+    }
+    return false;
+}
+
+bool M0Core::load(uint32_t addr, unsigned size, uint32_t *value)
+{
+    if ((addr & (size - 1)) != 0) {
+        return fail("unaligned " + std::to_string(size) + " byte load from " + hex32(addr));
+    }
+
+    const uint8_t *p = host_ptr(addr, size);
+    if (p != nullptr) {
+        *value = 0;
+        for (unsigned i = 0; i < size; i++) {
+            *value |= static_cast<uint32_t>(p[i]) << (8 * i);
+        }
+        if (addr < flash_.size()) {
+            cycles_ += config_.flashWaitStates;
+        }
+        return true;
+    }
+
+    if (((addr >= kM0SflashBase) && (addr - kM0SflashBase < kM0SflashSize)) || (addr >= kM0PeriphBase)) {
+        *value = 0;
+        return true;
+    }
+    return fail("load from unmapped address " + hex32(addr));
+}
+
+bool M0Core::store(uint32_t addr, unsigned size, uint32_t value)
+{
+    if ((config_.stopWriteAddr != 0) && (addr == config_.stopWriteAddr)) {
+        stopped_ = true;
+        stop_ = M0Stop::Write;
+        return false;
+    }
+    if ((addr & (size - 1)) != 0) {
+        return fail("unaligned " + std::to_string(size) + " byte store to " + hex32(addr));
+    }
+    if (addr < flash_.size()) {
+        return fail("store to flash address " + hex32(addr));
+    }
+
+    uint8_t *p = host_ptr(addr, size);
+    if (p != nullptr) {
+        for (unsigned i = 0; i < size; i++) {
+            p[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+        return true;
+    }
+    if (addr >= kM0PeriphBase) {
+        return true;
+    }
+    return fail("store to unmapped address " + hex32(addr));
+}
+
+bool M0Core::branch_to(uint32_t target, bool exchange)
+{
+    if (exchange && ((target & 1u) == 0)) {
+        return fail("switch to ARM state, target " + hex32(target));
+    }
+    target &= ~1u;
+    if (target == kReturnMagic) {
+        stopped_ = true;
+        stop_ = M0Stop::Return;
+    } else if (target < flash_.size()) {
+        cycles_ += config_.flashWaitStates;
+    }
+    r_[kPc] = target;
+    return true;
+}
+
+void M0Core::set_nz(uint32_t value)
+{
+    n_ = (value & 0x80000000u) != 0;
+    z_ = (value == 0);
+}
+
+uint32_t M0Core::add_with_carry(uint32_t a, uint32_t b, bool carry, bool setFlags)
+{
+    const uint64_t unsignedSum = static_cast<uint64_t>(a) + b + (carry ? 1 : 0);
+    const int64_t signedSum = static_cast<int64_t>(static_cast<int32_t>(a)) + static_cast<int32_t>(b) + (carry ? 1 : 0);
+    const uint32_t result = static_cast<uint32_t>(unsignedSum);
+
+    if (setFlags) {
+        set_nz(result);
+        c_ = (unsignedSum >> 32) != 0;
+        v_ = static_cast<int64_t>(static_cast<int32_t>(result)) != signedSum;
+    }
+    return result;
+}
+
+/* Execute one instruction. Returns false once the call has stopped. */
+bool M0Core::step()
+{
+    const uint32_t pc = r_[kPc];
+    uint32_t insn;
+
+    if ((pc & 1u) != 0) {
+        return fail("odd pc");
+    }
+    const uint8_t *p = host_ptr(pc, 2);
+    if (p == nullptr) {
+        return fail("instruction fetch from unmapped address");
+    }
+    insn = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8);
+
+    auto reg = [&](unsigned n) { return (n == kPc) ? pc + 4 : r_[n]; };
+    const unsigned rd = insn & 7u;
+    const unsigned rn = (insn >> 3) & 7u;
+    const unsigned rm = (insn >> 6) & 7u;
+    uint32_t value;
+    unsigned cycles = 1;
+
+    r_[kPc] = pc + 2;
+
+    switch (insn >> 11) {
+    case 0x00: case 0x01: case 0x02: {
+        /* LSLS, LSRS, ASRS by immediate. */
+        const unsigned shift = (insn >> 6) & 0x1Fu;
+        const uint32_t src = r_[rn];
+        if ((insn >> 11) == 0) {
+            value = src << shift;
+            if (shift != 0) {
+                c_ = ((src >> (32 - shift)) & 1u) != 0;
+            }
+        } else if ((insn >> 11) == 1) {
+            value = (shift == 0) ? 0 : (src >> shift);
+            c_ = ((shift == 0) ? (src >> 31) : (src >> (shift - 1))) & 1u;
+        } else {
+            const unsigned n = (shift == 0) ? 32 : shift;
+            value = (n == 32) ? static_cast<uint32_t>(static_cast<int32_t>(src) >> 31) :
+                                static_cast<uint32_t>(static_cast<int32_t>(src) >> n);
+            c_ = ((static_cast<int32_t>(src) >> (n - 1)) & 1) != 0;
+        }
+        set_nz(value);
+        r_[rd] = value;
+        break;
+    }
+
+    case 0x03: {
+        /* ADDS/SUBS register or 3-bit immediate. */
+        const uint32_t operand = ((insn & 0x0400u) != 0) ? rm : r_[rm];
+        r_[rd] = ((insn & 0x0200u) != 0) ? add_with_carry(r_[rn], ~operand, true, true) :
+                                           add_with_carry(r_[rn], operand, false, true);
+        break;
+    }
+
+    case 0x04: case 0x05: case 0x06: case 0x07: {
+        /* MOVS, CMP, ADDS, SUBS with an 8-bit immediate. */
+        const unsigned rdn = (insn >> 8) & 7u;
+        const uint32_t imm = insn & 0xFFu;
+        switch ((insn >> 11) & 3u) {
+        case 0:
+            r_[rdn] = imm;
+            set_nz(imm);
+            break;
+        case 1:
+            (void)add_with_carry(r_[rdn], ~imm, true, true);
+            break;
+        case 2:
+            r_[rdn] = add_with_carry(r_[rdn], imm, false, true);
+            break;
+        default:
+            r_[rdn] = add_with_carry(r_[rdn], ~imm, true, true);
+            break;
+        }
+        break;
+    }
+
+    case 0x08:
+        if ((insn & 0x0400u) == 0) {
+            /* Data processing register. */
+            const uint32_t a = r_[rd];
+            const uint32_t b = r_[rn];
+            const unsigned amount = b & 0xFFu;
+            switch ((insn >> 6) & 0xFu) {
+            case 0x0: value = a & b; set_nz(value); r_[rd] = value; break;
+            case 0x1: value = a ^ b; set_nz(value); r_[rd] = value; break;
+            case 0x2:
+                if (amount == 0) {
+                    value = a;
+                } else if (amount < 32) {
+                    value = a << amount;
+                    c_ = ((a >> (32 - amount)) & 1u) != 0;
+                } else {
+                    value = 0;
+                    c_ = (amount == 32) && ((a & 1u) != 0);
+                }
+                set_nz(value);
+                r_[rd] = value;
+                break;
+            case 0x3:
+                if (amount == 0) {
+                    value = a;
+                } else if (amount < 32) {
+                    value = a >> amount;
+                    c_ = ((a >> (amount - 1)) & 1u) != 0;
+                } else {
+                    value = 0;
+                    c_ = (amount == 32) && ((a >> 31) != 0);
+                }
+                set_nz(value);
+                r_[rd] = value;
+                break;
+            case 0x4:
+                if (amount == 0) {
+                    value = a;
+                } else if (amount < 32) {
+                    value = static_cast<uint32_t>(static_cast<int32_t>(a) >> amount);
+                    c_ = ((static_cast<int32_t>(a) >> (amount - 1)) & 1) != 0;
+                } else {
+                    value = static_cast<uint32_t>(static_cast<int32_t>(a) >> 31);
+                    c_ = (a >> 31) != 0;
+                }
+                set_nz(value);
+                r_[rd] = value;
+                break;
+            case 0x5: r_[rd] = add_with_carry(a, b, c_, true); break;
+            case 0x6: r_[rd] = add_with_carry(a, ~b, c_, true); break;
+            case 0x7:
+                value = a;
+                if (amount != 0) {
+                    const unsigned rot = amount & 31u;
+                    value = (rot == 0) ? a : ((a >> rot) | (a << (32 - rot)));
+                    c_ = (value >> 31) != 0;
+                }
+                set_nz(value);
+                r_[rd] = value;
+                break;
+            case 0x8: set_nz(a & b); break;
+            case 0x9: r_[rd] = add_with_carry(0, ~b, true, true); break;
+            case 0xA: (void)add_with_carry(a, ~b, true, true); break;
+            case 0xB: (void)add_with_carry(a, b, false, true); break;
+            case 0xC: value = a | b; set_nz(value); r_[rd] = value; break;
+            case 0xD:
+                value = a * b;
+                set_nz(value);
+                r_[rd] = value;
+                cycles = config_.mulCycles;
+                break;
+            case 0xE: value = a & ~b; set_nz(value); r_[rd] = value; break;
+            default: value = ~b; set_nz(value); r_[rd] = value; break;
+            }
+        } else {
+            /* Special data processing and branch exchange. */
+            const unsigned dn = (insn & 7u) | ((insn >> 4) & 8u);
+            const unsigned m = (insn >> 3) & 0xFu;
+            switch ((insn >> 8) & 3u) {
+            case 0:
+                value = reg(dn) + reg(m);
+                if (dn == kPc) {
+                    cycles = config_.timing->writePc;
+                    (void)branch_to(value, false);
+                } else {
+                    r_[dn] = value;
+                }
+                break;
+            case 1:
+                (void)add_with_carry(reg(dn), ~reg(m), true, true);
+                break;
+            case 2:
+                value = reg(m);
+                if (dn == kPc) {
+                    cycles = config_.timing->writePc;
+                    (void)branch_to(value, false);
+                } else {
+                    r_[dn] = value;
+                }
+                break;
+            default:
+                value = reg(m);
+                if ((insn & 0x80u) != 0) {
+                    r_[kLr] = (pc + 2) | 1u;
+                }
+                cycles = config_.timing->branchExchange;
+                if (!branch_to(value, true)) {
+                    return false;
+                }
+                break;
+            }
+        }
+        break;
+
+    case 0x09: {
+        /* LDR literal. */
+        const unsigned rt = (insn >> 8) & 7u;
+        if (!load(((pc + 4) & ~3u) + ((insn & 0xFFu) << 2), 4, &value)) {
+            return false;
+        }
+        r_[rt] = value;
+        cycles = 2;
+        break;
+    }
+
+    case 0x0A: case 0x0B: {
+        /* Load/store register offset. */
+        const uint32_t addr = r_[rn] + r_[rm];
+        cycles = 2;
+        switch ((insn >> 9) & 7u) {
+        case 0: if (!store(addr, 4, r_[rd])) return false; break;
+        case 1: if (!store(addr, 2, r_[rd])) return false; break;
+        case 2: if (!store(addr, 1, r_[rd])) return false; break;
+        case 3: if (!load(addr, 1, &value)) return false; r_[rd] = sign_extend(value, 8); break;
+        case 4: if (!load(addr, 4, &value)) return false; r_[rd] = value; break;
+        case 5: if (!load(addr, 2, &value)) return false; r_[rd] = value; break;
+        case 6: if (!load(addr, 1, &value)) return false; r_[rd] = value; break;
+        default: if (!load(addr, 2, &value)) return false; r_[rd] = sign_extend(value, 16); break;
+        }
+        break;
+    }
+
+    case 0x0C: case 0x0D: case 0x0E: case 0x0F: case 0x10: case 0x11: {
+        /* Load/store word, byte and halfword with a 5-bit immediate offset. */
+        const unsigned size = ((insn >> 11) >= 0x10) ? 2 : (((insn & 0x1000u) != 0) ? 1 : 4);
+        const uint32_t addr = r_[rn] + ((insn >> 6) & 0x1Fu) * size;
+        cycles = 2;
+        if ((insn & 0x0800u) != 0) {
+            if (!load(addr, size, &value)) {
+                return false;
+            }
+            r_[rd] = value;
+        } else if (!store(addr, size, r_[rd])) {
+            return false;
+        }
+        break;
+    }
+
+    case 0x12: case 0x13: {
+        /* Load/store SP relative. */
+        const unsigned rt = (insn >> 8) & 7u;
+        const uint32_t addr = r_[kSp] + ((insn & 0xFFu) << 2);
+        cycles = 2;
+        if ((insn & 0x0800u) != 0) {
+            if (!load(addr, 4, &value)) {
+                return false;
+            }
+            r_[rt] = value;
+        } else if (!store(addr, 4, r_[rt])) {
+            return false;
+        }
+        break;
+    }
+
+    case 0x14: case 0x15:
+        /* ADR, ADD Rd, SP, #imm. */
+        r_[(insn >> 8) & 7u] = (((insn & 0x0800u) != 0) ? r_[kSp] : ((pc + 4) & ~3u)) + ((insn & 0xFFu) << 2);
+        break;
+
+    case 0x16: case 0x17:
+        /* Miscellaneous. */
+        if ((insn & 0xFF00u) == 0xB000u) {
+            const uint32_t imm = (insn & 0x7Fu) << 2;
+            r_[kSp] = ((insn & 0x80u) != 0) ? (r_[kSp] - imm) : (r_[kSp] + imm);
+        } else if ((insn & 0xFF00u) == 0xB200u) {
+            const uint32_t src = r_[rn];
+            switch ((insn >> 6) & 3u) {
+            case 0: r_[rd] = sign_extend(src & 0xFFFFu, 16); break;
+            case 1: r_[rd] = sign_extend(src & 0xFFu, 8); break;
+            case 2: r_[rd] = src & 0xFFFFu; break;
+            default: r_[rd] = src & 0xFFu; break;
+            }
+        } else if ((insn & 0xFE00u) == 0xB400u) {
+            /* PUSH. */
+            const uint32_t list = (insn & 0xFFu) | (((insn & 0x100u) != 0) ? (1u << kLr) : 0);
+            uint32_t addr = r_[kSp] - 4 * popcount(list);
+            r_[kSp] = addr;
+            for (unsigned i = 0; i < 15; i++) {
+                if ((list & (1u << i)) != 0) {
+                    if (!store(addr, 4, r_[i])) {
+                        return false;
+                    }
+                    addr += 4;
+                }
+            }
+            cycles = 1 + popcount(list);
+        } else if ((insn & 0xFFEFu) == 0xB662u) {
+            /* CPSIE/CPSID i. */
+            primask_ = (insn >> 4) & 1u;
+        } else if ((insn & 0xFF00u) == 0xBA00u) {
+            const uint32_t src = r_[rn];
+            switch ((insn >> 6) & 3u) {
+            case 0:
+                r_[rd] = (src >> 24) | ((src >> 8) & 0xFF00u) | ((src << 8) & 0xFF0000u) | (src << 24);
+                break;
+            case 1:
+                r_[rd] = ((src >> 8) & 0x00FF00FFu) | ((src << 8) & 0xFF00FF00u);
+                break;
+            case 3:
+                r_[rd] = sign_extend(((src >> 8) & 0xFFu) | ((src & 0xFFu) << 8), 16);
+                break;
+            default:
+                return fail("undefined instruction " + hex32(insn));
+            }
+        } else if ((insn & 0xFE00u) == 0xBC00u) {
+            /* POP. */
+            uint32_t addr = r_[kSp];
+            const unsigned count = popcount(insn & 0x1FFu);
+            for (unsigned i = 0; i < 8; i++) {
+                if ((insn & (1u << i)) != 0) {
+                    if (!load(addr, 4, &r_[i])) {
+                        return false;
+                    }
+                    addr += 4;
+                }
+            }
+            cycles = 1 + count;
+            if ((insn & 0x100u) != 0) {
+                if (!load(addr, 4, &value)) {
+                    return false;
+                }
+                addr += 4;
+                r_[kSp] = addr;
+                cycles += config_.timing->popPc;
+                if (!branch_to(value, true)) {
+                    return false;
+                }
+            } else {
+                r_[kSp] = addr;
+            }
+        } else if ((insn & 0xFF00u) == 0xBE00u) {
+            stopped_ = true;
+            stop_ = M0Stop::Breakpoint;
+            r_[kPc] = pc;
+            return false;
+        } else if ((insn & 0xFF0Fu) == 0xBF00u) {
+            /* NOP, YIELD, WFE, WFI, SEV. */
+            cycles = (((insn >> 4) & 0xFu) == 0) ? 1 : 2;
+        } else {
+            return fail("undefined instruction " + hex32(insn));
+        }
+        break;
+
+    case 0x18: case 0x19: {
+        /* STM/LDM. */
+        const unsigned base = (insn >> 8) & 7u;
+        const uint32_t list = insn & 0xFFu;
+        uint32_t addr = r_[base];
+        if (list == 0) {
+            return fail("empty register list");
+        }
+        for (unsigned i = 0; i < 8; i++) {
+            if ((list & (1u << i)) != 0) {
+                if ((insn & 0x0800u) != 0) {
+                    if (!load(addr, 4, &r_[i])) {
+                        return false;
+                    }
+                } else if (!store(addr, 4, r_[i])) {
+                    return false;
+                }
+                addr += 4;
+            }
+        }
+        if (((insn & 0x0800u) == 0) || ((list & (1u << base)) == 0)) {
+            r_[base] = addr;
+        }
+        cycles = 1 + popcount(list);
+        break;
+    }
+
+    case 0x1A: case 0x1B: {
+        const unsigned cond = (insn >> 8) & 0xFu;
+        bool taken;
+        if (cond >= 0xE) {
+            /* UDF and SVC end the run like a breakpoint. */
+            stopped_ = true;
+            stop_ = M0Stop::Breakpoint;
+            r_[kPc] = pc;
+            return false;
+        }
+        switch (cond >> 1) {
+        case 0: taken = z_; break;
+        case 1: taken = c_; break;
+        case 2: taken = n_; break;
+        case 3: taken = v_; break;
+        case 4: taken = c_ && !z_; break;
+        case 5: taken = (n_ == v_); break;
+        default: taken = (n_ == v_) && !z_; break;
+        }
+        if ((cond & 1u) != 0) {
+            taken = !taken;
+        }
+        if (taken) {
+            cycles = config_.timing->branchTaken;
+            (void)branch_to(pc + 4 + (sign_extend(insn & 0xFFu, 8) << 1), false);
+        }
+        break;
+    }
+
+    case 0x1C:
+        cycles = config_.timing->branchTaken;
+        (void)branch_to(pc + 4 + (sign_extend(insn & 0x7FFu, 11) << 1), false);
+        break;
+
+    case 0x1E: {
+        /* 32-bit instructions: BL, MSR, MRS and the barriers. */
+        const uint8_t *q = host_ptr(pc + 2, 2);
+        if (q == nullptr) {
+            return fail("instruction fetch from unmapped address");
+        }
+        const uint32_t hw2 = static_cast<uint32_t>(q[0]) | (static_cast<uint32_t>(q[1]) << 8);
+        r_[kPc] = pc + 4;
+
+        if ((hw2 & 0xD000u) == 0xD000u) {
+            const uint32_t s = (insn >> 10) & 1u;
+            const uint32_t i1 = (~((hw2 >> 13) ^ s)) & 1u;
+            const uint32_t i2 = (~((hw2 >> 11) ^ s)) & 1u;
+            const uint32_t offset = (s << 24) | (i1 << 23) | (i2 << 22) | ((insn & 0x3FFu) << 12) | ((hw2 & 0x7FFu) << 1);
+            r_[kLr] = (pc + 4) | 1u;
+            cycles = config_.timing->branchLink;
+            (void)branch_to(pc + 4 + sign_extend(offset, 25), false);
+        } else if (((insn & 0xFFF0u) == 0xF380u) && ((hw2 & 0xFF00u) == 0x8800u)) {
+            const uint32_t src = r_[insn & 0xFu];
+            switch (hw2 & 0xFFu) {
+            case 0: case 1: case 2: case 3:
+                n_ = (src >> 31) != 0;
+                z_ = ((src >> 30) & 1u) != 0;
+                c_ = ((src >> 29) & 1u) != 0;
+                v_ = ((src >> 28) & 1u) != 0;
+                break;
+            case 8: case 9: r_[kSp] = src & ~3u; break;
+            case 16: primask_ = src & 1u; break;
+            default: break;
+            }
+            cycles = config_.timing->system;
+        } else if ((insn == 0xF3EFu) && ((hw2 & 0xF000u) == 0x8000u)) {
+            const unsigned dst = (hw2 >> 8) & 0xFu;
+            switch (hw2 & 0xFFu) {
+            case 0: case 1: case 2: case 3:
+                value = (n_ ? 0x80000000u : 0) | (z_ ? 0x40000000u : 0) | (c_ ? 0x20000000u : 0) | (v_ ? 0x10000000u : 0);
+                break;
+            case 8: case 9: value = r_[kSp]; break;
+            case 16: value = primask_; break;
+            default: value = 0; break;
+            }
+            r_[dst] = value;
+            cycles = config_.timing->system;
+        } else if ((insn == 0xF3BFu) && ((hw2 & 0xFFC0u) == 0x8F40u)) {
+            cycles = config_.timing->system;
+        } else {
+            return fail("undefined instruction " + hex32((insn << 16) | hw2));
+        }
+        break;
+    }
+
+    default:
+        return fail("undefined instruction " + hex32(insn));
+    }
+
+    cycles_ += cycles;
+    return !stopped_;
+}
+
+M0Result M0Core::call(uint32_t entry, const std::vector<uint32_t> &args, uint32_t sp, uint64_t maxInsns)
+{
+    M0Result result;
+
+    std::memset(r_, 0, sizeof(r_));
+    for (size_t i = 0; (i < args.size()) && (i < 4); i++) {
+        r_[i] = args[i];
+    }
+    r_[kSp] = sp;
+    r_[kLr] = kReturnMagic | 1u;
+    r_[kPc] = entry & ~1u;
+    n_ = z_ = c_ = v_ = false;
+    cycles_ = 0;
+    stopped_ = false;
+    fault_.clear();
+
+    while ((result.insns < maxInsns) && step()) {
+        result.insns++;
+    }
+    if (stopped_ && ((stop_ == M0Stop::Return) || (stop_ == M0Stop::Write))) {
+        /* The branch that returns, or the store that was reached, counts as executed. */
+        result.insns += (stop_ == M0Stop::Return) ? 1 : 0;
+    }
+
+    result.stop = stopped_ ? stop_ : M0Stop::Limit;
+    result.cycles = cycles_;
+    result.r0 = r_[0];
+    result.pc = r_[kPc];
+    result.fault = fault_;
+    return result;
+}
+
+} // namespace pmg1
@@ -0,0 +1,135 @@
+/******************************************************************************
+* File Name: m0_core.h
+*
+* Description: ARMv6-M (Cortex-M0/M0+) instruction set interpreter with a
+*              cycle model, used to benchmark boot-loader code on the host.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_M0_CORE_H
+#define PMG1_HOST_M0_CORE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pmg1 {
+
+constexpr uint32_t kM0RamBase       = 0x20000000;
+constexpr uint32_t kM0SflashBase    = 0x0FFFF000;   /* Supervisory flash, reads as zero. */
+constexpr uint32_t kM0SflashSize    = 0x1000;
+constexpr uint32_t kM0PeriphBase    = 0x40000000;   /* Peripherals and PPB read as zero, writes are dropped. */
+constexpr uint32_t kM0CpussSysreq   = 0x40100004;   /* SROM request register: a write starts a flash operation. */
+
+/* Cycle counts from the Cortex-M0 and Cortex-M0+ technical reference manuals,
+ * for zero wait state memory. */
+struct M0Timing {
+    const char *name;
+    unsigned branchTaken;       /* B, B<c> taken. */
+    unsigned branchLink;        /* BL. */
+    unsigned branchExchange;    /* BX, BLX. */
+    unsigned writePc;           /* ADD PC / MOV PC. */
+    unsigned popPc;             /* Added to 1 + N for POP {..., PC}. */
+    unsigned system;            /* MSR, MRS, DMB, DSB, ISB. */
+};
+
+extern const M0Timing kCortexM0;
+extern const M0Timing kCortexM0Plus;
+
+struct M0Config {
+    const M0Timing *timing = &kCortexM0;
+    unsigned mulCycles = 1;             /* 1 for the fast multiplier, 32 for the small one. */
+    unsigned flashWaitStates = 0;       /* Added to each flash data load and each taken branch. */
+    uint32_t stopWriteAddr = 0;         /* Stop before a store to this address; 0 disables. */
+};
+
+enum class M0Stop {
+    Return,                             /* The called function returned. */
+    Write,                              /* Reached the store to stopWriteAddr. */
+    Limit,                              /* Ran out of instructions. */
+    Breakpoint,                         /* BKPT, SVC or UDF. */
+    Fault,                              /* Bad access or undefined instruction. */
+};
+
+struct M0Result {
+    M0Stop stop = M0Stop::Fault;
+    uint64_t cycles = 0;
+    uint64_t insns = 0;
+    uint32_t r0 = 0;
+    uint32_t pc = 0;
+    std::string fault;
+};
+
+class M0Core {
+public:
+    M0Core(uint32_t flashSize, uint32_t ramSize, const M0Config &config);
+
+    /* Host access to the flash and RAM images. Returns false outside both. */
+    bool write(uint32_t addr, const uint8_t *data, size_t size);
+    bool read(uint32_t addr, uint8_t *data, size_t size) const;
+
+    uint32_t ram_top() const { return kM0RamBase + static_cast<uint32_t>(ram_.size()); }
+
+    /* Call a Thumb function (entry with bit 0 set or not) with up to four word
+     * arguments, the stack at sp, and stop after maxInsns instructions. */
+    M0Result call(uint32_t entry, const std::vector<uint32_t> &args, uint32_t sp, uint64_t maxInsns);
+
+private:
+    bool load(uint32_t addr, unsigned size, uint32_t *value);
+    bool store(uint32_t addr, unsigned size, uint32_t value);
+    uint8_t *host_ptr(uint32_t addr, unsigned size);
+    bool step();
+    bool branch_to(uint32_t target, bool exchange);
+    bool fail(const std::string &what);
+
+    uint32_t add_with_carry(uint32_t a, uint32_t b, bool carry, bool setFlags);
+    void set_nz(uint32_t value);
+
+    M0Config config_;
+    std::vector<uint8_t> flash_;
+    std::vector<uint8_t> ram_;
+
+    uint32_t r_[16] = {};
+    bool n_ = false, z_ = false, c_ = false, v_ = false;
+    uint32_t primask_ = 0;
+    uint64_t cycles_ = 0;
+    M0Stop stop_ = M0Stop::Fault;
+    bool stopped_ = false;
+    std::string fault_;
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_M0_CORE_H */
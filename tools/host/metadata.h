@@ -0,0 +1,140 @@
+/******************************************************************************
+* File Name: metadata.h
+*
+* Description: Host side view of the firmware metadata (fw_metadata_t in
+*              src/system/boot.h).
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_METADATA_H
+#define PMG1_HOST_METADATA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace pmg1 {
+
+constexpr size_t   kMetadataSize      = 128;
+constexpr uint16_t kMetadataValidSig  = 0x4946;     /* "IF" */
+constexpr uint16_t kWaitTimeDefault   = 0xFFFF;
+constexpr uint16_t kWaitTimeZero      = 0x4359;
+constexpr uint16_t kBootModeRqtSig    = 0x424C;
+constexpr uint16_t kBootRqtSigBase    = 0x4230;   /* + slot: boot that slot without a wait. */
+constexpr uint16_t kBootTypeStartApp  = 0x80;     /* Soft reset straight into the image. */
+
+/* Byte offsets within the metadata. */
+constexpr size_t kMdAppFwStart        = 0x00;
+constexpr size_t kMdAppFwSize         = 0x04;
+constexpr size_t kMdBootWaitTime      = 0x08;
+constexpr size_t kMdBootLastRow       = 0x0A;
+constexpr size_t kMdBootSeq           = 0x14;
+constexpr size_t kMdMetadataVersion   = 0x54;
+constexpr size_t kMdMetadataValid     = 0x56;
+constexpr size_t kMdFwCrc32           = 0x58;
+constexpr size_t kMdFwDigest          = 0x5C;     /* SHA-256 of the image, for authenticated boot. */
+constexpr size_t kFwDigestSize        = 32;
+
+inline uint32_t get_le32(const uint8_t *p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint16_t get_le16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+inline void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+struct Metadata {
+    uint32_t appFwStart = 0;
+    uint32_t appFwSize = 0;
+    uint16_t bootWaitTime = kWaitTimeDefault;
+    uint16_t bootLastRow = 0;
+    uint32_t bootSeq = 0;
+    uint16_t metadataVersion = 0;
+    uint16_t metadataValid = 0;
+    uint32_t fwCrc32 = 0;
+    std::array<uint8_t, kFwDigestSize> fwDigest{};
+
+    static Metadata parse(const uint8_t *p)
+    {
+        Metadata md;
+        md.appFwStart = get_le32(p + kMdAppFwStart);
+        md.appFwSize = get_le32(p + kMdAppFwSize);
+        md.bootWaitTime = get_le16(p + kMdBootWaitTime);
+        md.bootLastRow = get_le16(p + kMdBootLastRow);
+        md.bootSeq = get_le32(p + kMdBootSeq);
+        md.metadataVersion = get_le16(p + kMdMetadataVersion);
+        md.metadataValid = get_le16(p + kMdMetadataValid);
+        md.fwCrc32 = get_le32(p + kMdFwCrc32);
+        std::memcpy(md.fwDigest.data(), p + kMdFwDigest, kFwDigestSize);
+        return md;
+    }
+
+    /* Serialize into a kMetadataSize byte buffer. Reserved fields are zeroed. */
+    void serialize(uint8_t *p) const
+    {
+        std::memset(p, 0, kMetadataSize);
+        put_le32(p + kMdAppFwStart, appFwStart);
+        put_le32(p + kMdAppFwSize, appFwSize);
+        put_le16(p + kMdBootWaitTime, bootWaitTime);
+        put_le16(p + kMdBootLastRow, bootLastRow);
+        put_le32(p + kMdBootSeq, bootSeq);
+        put_le16(p + kMdMetadataVersion, metadataVersion);
+        put_le16(p + kMdMetadataValid, metadataValid);
+        put_le32(p + kMdFwCrc32, fwCrc32);
+        std::memcpy(p + kMdFwDigest, fwDigest.data(), kFwDigestSize);
+    }
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_METADATA_H */
@@ -0,0 +1,151 @@
+/******************************************************************************
+* File Name: pack_main.cpp
+*
+* Description: pmg1-pack. Turns an application ELF or Intel HEX file into a
+*              row stream file for one firmware slot.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "crc32c.h"
+#include "image.h"
+#include "segments.h"
+#include "stream.h"
+
+using namespace pmg1;
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: pmg1-pack --target NAME --slot N [--wait MS] [--keep-erased] [--rww]\n"
+        "                 [--manifest FILE] -o OUTPUT INPUT.elf|INPUT.hex\n"
+        "targets: %s\n", target_names().c_str());
+}
+
+bool write_manifest(const std::string &path, const std::vector<SegmentCrc> &manifest, std::string *error)
+{
+    FILE *file = std::fopen(path.c_str(), "w");
+
+    if (file == nullptr) {
+        *error = path + ": cannot create file";
+        return false;
+    }
+    std::fprintf(file, "# address    size       crc32c\n");
+    for (const SegmentCrc &seg : manifest) {
+        std::fprintf(file, "0x%08x 0x%08x 0x%08x\n", seg.addr, seg.size, seg.crc);
+    }
+    return std::fclose(file) == 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string targetName;
+    std::string input;
+    std::string output;
+    std::string manifestPath;
+    unsigned slot = 0;
+    LayoutOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasArg = (i + 1) < argc;
+
+        if ((arg == "--target") && hasArg) {
+            targetName = argv[++i];
+        } else if ((arg == "--slot") && hasArg) {
+            slot = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((arg == "--wait") && hasArg) {
+            const unsigned wait = std::strtoul(argv[++i], nullptr, 0);
+            options.bootWaitTime = static_cast<uint16_t>((wait == 0) ? kWaitTimeZero : wait);
+        } else if (arg == "--keep-erased") {
+            options.dropErasedTail = false;
+        } else if (arg == "--rww") {
+            options.rwwLayout = true;
+        } else if ((arg == "--manifest") && hasArg) {
+            manifestPath = argv[++i];
+        } else if ((arg == "-o") && hasArg) {
+            output = argv[++i];
+        } else if ((arg[0] != '-') && input.empty()) {
+            input = arg;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    const TargetInfo *target = find_target(targetName);
+    if ((target == nullptr) || (slot < 1) || (slot > (options.rwwLayout ? 2u : 4u)) || input.empty() || output.empty()) {
+        usage();
+        return 2;
+    }
+
+    std::string error;
+    SegmentFile file;
+    UpdateImage image;
+    std::vector<SegmentCrc> manifest;
+    std::vector<std::string> notes;
+
+    if (!file.load(input, &error) ||
+        !make_image_from_segments(*target, static_cast<uint8_t>(slot), file.segments(), options, &image,
+                                  &manifest, &notes, &error) ||
+        !write_stream(output, image, &error) ||
+        (!manifestPath.empty() && !write_manifest(manifestPath, manifest, &error))) {
+        std::fprintf(stderr, "pmg1-pack: %s\n", error.c_str());
+        return 1;
+    }
+
+    for (const std::string &note : notes) {
+        std::fprintf(stderr, "pmg1-pack: %s\n", note.c_str());
+    }
+
+    const Metadata md = image.metadata();
+    std::printf("%s: FW%u, %zu segments, %zu rows from 0x%04x, metadata row 0x%04x\n", output.c_str(), slot,
+                manifest.size(), image.rows.size(), image.rows.front().row, image.metadataRow.row);
+    std::printf("appFwStart 0x%08x appFwSize 0x%08x fwCrc32 0x%08x (%s)\n", md.appFwStart, md.appFwSize,
+                md.fwCrc32, crc32c_hw_accelerated() ? "sse4.2" : "table");
+    std::printf("fwDigest ");
+    for (uint8_t b : md.fwDigest) {
+        std::printf("%02x", b);
+    }
+    std::printf("\n");
+    return 0;
+}
@@ -0,0 +1,290 @@
+/******************************************************************************
+* File Name: segments.cpp
+*
+* Description: Loadable segments of an application ELF or Intel HEX file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "segments.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pmg1 {
+
+namespace {
+
+int hex_nibble(char c)
+{
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    if ((c >= 'A') && (c <= 'F')) {
+        return c - 'A' + 10;
+    }
+    if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+} // namespace
+
+SegmentFile::~SegmentFile()
+{
+    if (map_ != nullptr) {
+        ::munmap(map_, mapSize_);
+    }
+}
+
+bool SegmentFile::load(const std::string &path, std::string *error)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+
+    path_ = path;
+    if ((fd < 0) || (::fstat(fd, &st) < 0)) {
+        *error = path + ": " + std::strerror(errno);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+
+    mapSize_ = static_cast<size_t>(st.st_size);
+    map_ = (mapSize_ != 0) ? ::mmap(nullptr, mapSize_, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        *error = path + ": cannot map file";
+        return false;
+    }
+
+    const bool ok = ((mapSize_ >= SELFMAG) && (std::memcmp(map_, ELFMAG, SELFMAG) == 0)) ?
+                    load_elf(error) : load_hex(error);
+    if (ok) {
+        std::sort(segments_.begin(), segments_.end(),
+                  [](const Segment &a, const Segment &b) { return a.addr < b.addr; });
+    }
+    return ok;
+}
+
+bool SegmentFile::load_elf(std::string *error)
+{
+    const uint8_t *base = static_cast<const uint8_t *>(map_);
+    Elf32_Ehdr ehdr;
+
+    if (mapSize_ < sizeof(ehdr)) {
+        *error = path_ + ": truncated ELF header";
+        return false;
+    }
+    std::memcpy(&ehdr, base, sizeof(ehdr));
+    if ((ehdr.e_ident[EI_CLASS] != ELFCLASS32) || (ehdr.e_ident[EI_DATA] != ELFDATA2LSB) ||
+        (ehdr.e_machine != EM_ARM)) {
+        *error = path_ + ": not a 32-bit little endian ARM ELF file";
+        return false;
+    }
+    if ((ehdr.e_phentsize != sizeof(Elf32_Phdr)) ||
+        (ehdr.e_phoff + static_cast<size_t>(ehdr.e_phnum) * sizeof(Elf32_Phdr) > mapSize_)) {
+        *error = path_ + ": bad program header table";
+        return false;
+    }
+
+    for (unsigned i = 0; i < ehdr.e_phnum; i++) {
+        Elf32_Phdr phdr;
+        std::memcpy(&phdr, base + ehdr.e_phoff + i * sizeof(Elf32_Phdr), sizeof(phdr));
+
+        /* Initialized data is placed at its load address (LMA) in flash. */
+        if ((phdr.p_type != PT_LOAD) || (phdr.p_filesz == 0)) {
+            continue;
+        }
+        if (static_cast<size_t>(phdr.p_offset) + phdr.p_filesz > mapSize_) {
+            *error = path_ + ": segment " + std::to_string(i) + " runs past the end of the file";
+            return false;
+        }
+        segments_.push_back({phdr.p_paddr, base + phdr.p_offset, phdr.p_filesz, phdr.p_vaddr});
+    }
+
+    load_symbols(base, &ehdr);
+    return true;
+}
+
+void SegmentFile::load_symbols(const uint8_t *base, const void *ehdrP)
+{
+    const Elf32_Ehdr &ehdr = *static_cast<const Elf32_Ehdr *>(ehdrP);
+
+    if ((ehdr.e_shentsize != sizeof(Elf32_Shdr)) ||
+        (ehdr.e_shoff + static_cast<size_t>(ehdr.e_shnum) * sizeof(Elf32_Shdr) > mapSize_)) {
+        return;
+    }
+
+    for (unsigned i = 0; i < ehdr.e_shnum; i++) {
+        Elf32_Shdr shdr;
+        Elf32_Shdr strhdr;
+        std::memcpy(&shdr, base + ehdr.e_shoff + i * sizeof(Elf32_Shdr), sizeof(shdr));
+        if ((shdr.sh_type != SHT_SYMTAB) || (shdr.sh_link >= ehdr.e_shnum) ||
+            (static_cast<size_t>(shdr.sh_offset) + shdr.sh_size > mapSize_)) {
+            continue;
+        }
+        std::memcpy(&strhdr, base + ehdr.e_shoff + shdr.sh_link * sizeof(Elf32_Shdr), sizeof(strhdr));
+        if (static_cast<size_t>(strhdr.sh_offset) + strhdr.sh_size > mapSize_) {
+            continue;
+        }
+
+        const char *strtab = reinterpret_cast<const char *>(base + strhdr.sh_offset);
+        for (size_t off = 0; off + sizeof(Elf32_Sym) <= shdr.sh_size; off += sizeof(Elf32_Sym)) {
+            Elf32_Sym sym;
+            std::memcpy(&sym, base + shdr.sh_offset + off, sizeof(sym));
+            const unsigned type = ELF32_ST_TYPE(sym.st_info);
+            if (((type != STT_FUNC) && (type != STT_OBJECT)) || (sym.st_name >= strhdr.sh_size)) {
+                continue;
+            }
+            symbols_.push_back({std::string(strtab + sym.st_name, strnlen(strtab + sym.st_name, strhdr.sh_size - sym.st_name)),
+                                sym.st_value, sym.st_size, type == STT_FUNC});
+        }
+    }
+}
+
+const Symbol *SegmentFile::find_symbol(const std::string &name) const
+{
+    const Symbol *renamed = nullptr;
+
+    for (const Symbol &sym : symbols_) {
+        if (sym.name == name) {
+            return &sym;
+        }
+        if ((renamed == nullptr) && (sym.name.size() > name.size()) &&
+            (sym.name.compare(0, name.size(), name) == 0) && (sym.name[name.size()] == '.')) {
+            renamed = &sym;
+        }
+    }
+    return renamed;
+}
+
+bool SegmentFile::load_hex(std::string *error)
+{
+    const char *p = static_cast<const char *>(map_);
+    const char *end = p + mapSize_;
+    uint32_t upper = 0;
+    unsigned line = 0;
+    std::vector<uint8_t> *current = nullptr;
+    uint32_t currentAddr = 0;
+    std::vector<uint32_t> addrs;
+
+    while (p < end) {
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        eol = (eol != nullptr) ? eol : end;
+        line++;
+
+        const char *q = p;
+        const char *lineEnd = eol;
+        p = eol + 1;
+        while ((lineEnd > q) && ((lineEnd[-1] == '\r') || (lineEnd[-1] == ' '))) {
+            lineEnd--;
+        }
+        if (q == lineEnd) {
+            continue;
+        }
+
+        uint8_t rec[5 + 255];
+        size_t n = 0;
+        if ((*q != ':') || (((lineEnd - q - 1) % 2) != 0) || (static_cast<size_t>(lineEnd - q - 1) / 2 > sizeof(rec))) {
+            *error = path_ + ":" + std::to_string(line) + ": not an Intel HEX record";
+            return false;
+        }
+        for (q++; q < lineEnd; q += 2) {
+            const int hi = hex_nibble(q[0]);
+            const int lo = hex_nibble(q[1]);
+            if ((hi < 0) || (lo < 0)) {
+                *error = path_ + ":" + std::to_string(line) + ": bad hex digit";
+                return false;
+            }
+            rec[n++] = static_cast<uint8_t>((hi << 4) | lo);
+        }
+
+        uint8_t sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            sum = static_cast<uint8_t>(sum + rec[i]);
+        }
+        if ((n < 5) || (n != static_cast<size_t>(rec[0]) + 5) || (sum != 0)) {
+            *error = path_ + ":" + std::to_string(line) + ": bad record length or checksum";
+            return false;
+        }
+
+        const uint8_t len = rec[0];
+        const uint32_t offset = (static_cast<uint32_t>(rec[1]) << 8) | rec[2];
+        const uint8_t *data = &rec[4];
+
+        switch (rec[3]) {
+        case 0x00: {
+            const uint32_t addr = upper + offset;
+            if ((current == nullptr) || (addr != currentAddr + current->size())) {
+                owned_.emplace_back(new std::vector<uint8_t>());
+                current = owned_.back().get();
+                currentAddr = addr;
+                addrs.push_back(addr);
+            }
+            current->insert(current->end(), data, data + len);
+            break;
+        }
+        case 0x01:
+            p = end;
+            break;
+        case 0x02:
+            upper = ((static_cast<uint32_t>(data[0]) << 8) | data[1]) << 4;
+            break;
+        case 0x04:
+            upper = ((static_cast<uint32_t>(data[0]) << 8) | data[1]) << 16;
+            break;
+        default:
+            /* Start address records. */
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < owned_.size(); i++) {
+        segments_.push_back({addrs[i], owned_[i]->data(), owned_[i]->size(), addrs[i]});
+    }
+    return true;
+}
+
+} // namespace pmg1
@@ -0,0 +1,103 @@
+/******************************************************************************
+* File Name: segments.h
+*
+* Description: Loadable segments of an application ELF or Intel HEX file.
+*              ELF files are memory mapped and their segments point straight
+*              into the mapping.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_SEGMENTS_H
+#define PMG1_HOST_SEGMENTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pmg1 {
+
+struct Segment {
+    uint32_t addr;                      /* Load (flash) address. */
+    const uint8_t *data;
+    size_t size;
+    uint32_t vaddr;                     /* Run address: differs from addr for initialized data. */
+};
+
+/* Function or object symbol of an ELF file. */
+struct Symbol {
+    std::string name;
+    uint32_t addr;                      /* Thumb functions have bit 0 set. */
+    uint32_t size;
+    bool function;
+};
+
+class SegmentFile {
+public:
+    SegmentFile() = default;
+    ~SegmentFile();
+
+    SegmentFile(const SegmentFile &) = delete;
+    SegmentFile &operator=(const SegmentFile &) = delete;
+
+    /* Load an ELF (by its magic) or Intel HEX file. Segments come out sorted by address. */
+    bool load(const std::string &path, std::string *error);
+
+    const std::vector<Segment> &segments() const { return segments_; }
+
+    /* Function and object symbols, local ones included. Empty for Intel HEX files. */
+    const std::vector<Symbol> &symbols() const { return symbols_; }
+
+    /* Look up a symbol by name. LTO renamed copies (name.lto_priv.N, name.constprop.N)
+     * match when there is no exact match. */
+    const Symbol *find_symbol(const std::string &name) const;
+
+private:
+    bool load_elf(std::string *error);
+    bool load_hex(std::string *error);
+    void load_symbols(const uint8_t *base, const void *ehdr);
+
+    std::string path_;
+    void *map_ = nullptr;
+    size_t mapSize_ = 0;
+    std::vector<std::unique_ptr<std::vector<uint8_t>>> owned_;
+    std::vector<Segment> segments_;
+    std::vector<Symbol> symbols_;
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_SEGMENTS_H */
@@ -0,0 +1,727 @@
+/******************************************************************************
+* File Name: sim_device.cpp
+*
+* Description: Host model of a PMG1 device running the bootloader.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "sim_device.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "crc32c.h"
+#include "metadata.h"
+
+namespace pmg1 {
+
+namespace {
+
+constexpr size_t kRegSpaceSize = 0x100;
+constexpr uint64_t kMsToNs = 1000000;
+
+/* Boot-wait limits of the bootloader, in ms. */
+constexpr uint16_t kWaitDefaultMs = 50;
+constexpr uint16_t kWaitMinMs = 20;
+constexpr uint16_t kWaitMaxMs = 1000;
+
+/* Register bytes of one I2C transaction: address + 2 byte register address. */
+constexpr size_t kBusHeaderBytes = 3;
+
+/* Slot fallback order of config.h. */
+const uint8_t kFallbackOrder[] = {2, 1, 3, 4};
+
+} // namespace
+
+SimDevice::SimDevice(const TargetInfo &target, uint8_t slotCount,
+                     const SimTiming &timing, const SimStackModel &stack)
+    : target_(target),
+      slotCount_(std::min<uint8_t>(std::max<uint8_t>(slotCount, 2), 4)),
+      timing_(timing),
+      stackModel_(stack),
+      flash_(target.flashSize, 0),
+      regs_(kRegSpaceSize, 0),
+      flashMem_(std::max<size_t>(target.rowSize, hpi::FLASH_READ_MAX), 0)
+{
+    if (stackModel_.staticRam == 0) {
+        /* Bootloader data + bss, dominated by the HPI context and the shared row buffer. */
+        stackModel_.staticRam = 0x300 + target_.rowSize;
+    }
+}
+
+uint16_t SimDevice::metadata_row(uint8_t slot) const
+{
+    return static_cast<uint16_t>(target_.last_row() - (slot - 1));
+}
+
+uint8_t SimDevice::slot_from_md_row(uint16_t row) const
+{
+    for (uint8_t slot = 1; slot <= slotCount_; slot++) {
+        if (metadata_row(slot) == row) {
+            return slot;
+        }
+    }
+    return 0;
+}
+
+bool SimDevice::slot_valid(uint8_t slot) const
+{
+    return (slot >= 1) && (slot <= slotCount_) && ((imgStatus_ & (1u << (slot + 1))) == 0);
+}
+
+void SimDevice::power_on()
+{
+    runType_ = 0;
+    reset(0);
+}
+
+void SimDevice::soft_reset(uint16_t runType)
+{
+    reset(runType);
+}
+
+void SimDevice::reset(uint16_t runType)
+{
+    /* glActiveFw lives in the no-init RAM: Cy_OnResetUser() starts it again on START_APP. */
+    const uint8_t lastFw = selectedFw_;
+
+    runType_ = runType;
+    flashMode_ = false;
+    activeFw_ = 0;
+    selectedFw_ = 0;
+    waitDeadline_ = 0;
+    resetNs_ = now_;
+    resetCompleteNs_ = 0;
+    intrPending_ = false;
+    pendingResponse_ = hpi::RESP_NONE;
+    std::fill(regs_.begin(), regs_.end(), 0);
+
+    /* RAM is not retained across the reset: the stack is painted again. */
+    stackPeak_ = 0;
+    verifyMismatches_ = 0;
+    verifyLastRow_ = 0;
+    verifyLastAttempts_ = 0;
+    hpiWakes_ = 0;
+    stack_use(stackModel_.startup);
+
+    if ((runType_ == kBootTypeStartApp) && (lastFw != 0)) {
+        runType_ = 0;
+        selectedFw_ = lastFw;
+        start_fw(now_ + timing_.onResetNs);
+        return;
+    }
+    boot();
+}
+
+Metadata SimDevice::slot_metadata(uint8_t slot) const
+{
+    const size_t mdAddr = (static_cast<size_t>(metadata_row(slot)) + 1) * target_.rowSize - kMetadataSize;
+    return Metadata::parse(&flash_[mdAddr]);
+}
+
+bool SimDevice::validate(uint8_t slot, uint64_t *costNs) const
+{
+    const Metadata md = slot_metadata(slot);
+
+    if ((md.metadataValid != kMetadataValidSig) ||
+        ((static_cast<uint64_t>(md.appFwStart) + md.appFwSize) >= target_.flashSize) ||
+        (md.appFwSize == 0)) {
+        return false;
+    }
+
+    if (costNs != nullptr) {
+        *costNs += md.appFwSize * timing_.crcNsPerByte;
+    }
+    return md.fwCrc32 == crc32c(&flash_[md.appFwStart], md.appFwSize);
+}
+
+/* Same fields as boot_record_matches(), after the metadata sanity check of boot_check_task(). */
+bool SimDevice::record_matches(uint8_t slot) const
+{
+    const Metadata md = slot_metadata(slot);
+
+    return bootRecord_ && (recordSlot_ == slot) && (md.metadataValid == kMetadataValidSig) &&
+           (md.appFwStart == recordMd_.appFwStart) && (md.appFwSize == recordMd_.appFwSize) &&
+           (md.bootSeq == recordMd_.bootSeq) && (md.fwCrc32 == recordMd_.fwCrc32) &&
+           (md.fwDigest == recordMd_.fwDigest);
+}
+
+uint32_t SimDevice::next_boot_seq(uint8_t slot) const
+{
+    uint32_t seq = 0;
+
+    for (uint8_t other = 1; other <= slotCount_; other++) {
+        if ((other != slot) && validate(other, nullptr)) {
+            const size_t mdAddr = (static_cast<size_t>(metadata_row(other)) + 1) * target_.rowSize - kMetadataSize;
+            seq = std::max(seq, get_le32(&flash_[mdAddr + kMdBootSeq]));
+        }
+    }
+    return seq + 1;
+}
+
+bool SimDevice::row_protected(uint16_t row) const
+{
+    if ((slotCount_ <= 2) || !slot_valid(slotCount_)) {
+        return false;
+    }
+
+    const size_t mdAddr = (static_cast<size_t>(metadata_row(slotCount_)) + 1) * target_.rowSize - kMetadataSize;
+    const Metadata md = Metadata::parse(&flash_[mdAddr]);
+    const uint32_t first = md.appFwStart >> target_.row_shift();
+    const uint32_t last = (md.appFwStart + md.appFwSize - 1) >> target_.row_shift();
+
+    return (row == metadata_row(slotCount_)) || ((row >= first) && (row <= last));
+}
+
+std::vector<uint8_t> SimDevice::check_order(uint8_t rqtSlot) const
+{
+    std::vector<uint8_t> order;
+
+    /* Same order as boot_check_order(): the requested slot, the other slots by descending
+       boot sequence, golden slots last. */
+    if ((rqtSlot >= 1) && (rqtSlot <= slotCount_)) {
+        order.push_back(rqtSlot);
+    }
+    const size_t first = order.size();
+    for (uint8_t idx = 0; idx < slotCount_; idx++) {
+        const uint8_t slot = kFallbackOrder[idx];
+        const bool golden = (slotCount_ > 2) && (slot == slotCount_);
+        if ((slot != rqtSlot) && !golden) {
+            const uint32_t seq = slot_metadata(slot).bootSeq;
+            auto pos = order.end();
+            while ((pos != order.begin() + first) && (slot_metadata(*(pos - 1)).bootSeq < seq)) {
+                --pos;
+            }
+            order.insert(pos, slot);
+        }
+    }
+    if ((slotCount_ > 2) && (rqtSlot != slotCount_)) {
+        order.push_back(slotCount_);
+    }
+    return order;
+}
+
+void SimDevice::boot()
+{
+    const uint64_t checkStart = now_ + timing_.onResetNs + timing_.startupNs;
+    const uint8_t prevStatus = imgStatus_;
+    const bool bootModeRqt = (runType_ == kBootModeRqtSig);
+    uint8_t rqtSlot = 0;
+
+    for (uint8_t slot = 1; slot <= slotCount_; slot++) {
+        if (runType_ == kBootRqtSigBase + slot) {
+            rqtSlot = slot;
+        }
+    }
+    runType_ = 0;
+
+    /* Slots are checked one after the other; the first valid one is booted. */
+    const std::vector<uint8_t> order = check_order(rqtSlot);
+    std::vector<uint64_t> doneAt(order.size());
+    uint64_t cost = 0;
+    size_t decidedAt = order.size();
+
+    imgStatus_ = 0;
+    stack_use(stackModel_.startup + stackModel_.validate);
+    for (size_t idx = 0; idx < order.size(); idx++) {
+        if (!record_matches(order[idx]) && !validate(order[idx], &cost)) {
+            imgStatus_ |= static_cast<uint8_t>(1u << (order[idx] + 1));
+        } else if (decidedAt == order.size()) {
+            decidedAt = idx;
+        }
+        doneAt[idx] = cost;
+    }
+    if (bootModeRqt) {
+        imgStatus_ |= 0x01;
+    } else if (decidedAt != order.size()) {
+        selectedFw_ = order[decidedAt];
+    }
+
+    /* PMG1_BOOT_DIRECT_HANDOFF: a requested slot is the only one checked, the others keep
+       the state of the previous boot. */
+    const uint64_t allChecked = doneAt.empty() ? 0 : doneAt.back();
+    uint64_t checked = allChecked;
+    if (directHandoff_ && (rqtSlot != 0) && (selectedFw_ == rqtSlot)) {
+        imgStatus_ = static_cast<uint8_t>((prevStatus & ~(1u << (rqtSlot + 1)) & 0x3C) | (imgStatus_ & 0x01));
+        checked = doneAt[0];
+    }
+
+    uint64_t waitMs = 0;
+    if (selectedFw_ != 0) {
+        const uint16_t waitTime = slot_metadata(selectedFw_).bootWaitTime;
+        waitMs = kWaitDefaultMs;
+        if ((rqtSlot != 0) || (waitTime == kWaitTimeZero)) {
+            waitMs = 0;
+        } else if (waitTime != kWaitTimeDefault) {
+            waitMs = std::min(kWaitMaxMs, std::max(kWaitMinMs, waitTime));
+        }
+    }
+
+    /* PMG1_BOOT_BG_CHECK_ENABLE: the images are checked from the main loop once HPI is up,
+       unless the image expected first starts without a boot-wait window. */
+    bool syncCheck = true;
+    if (bgCheck_ && !order.empty()) {
+        const uint16_t firstWait = slot_metadata(order[0]).bootWaitTime;
+        syncCheck = !bootModeRqt && ((rqtSlot != 0) || (firstWait == kWaitTimeZero));
+        if (syncCheck) {
+            checked = (decidedAt != order.size()) ? doneAt[decidedAt] : allChecked;
+        }
+    }
+
+    if (syncCheck && (selectedFw_ != 0) && (waitMs == 0)) {
+        start_fw(checkStart + checked + jump_ns());
+        return;
+    }
+
+    const uint64_t hpiUp = checkStart + (syncCheck ? checked : 0) + timing_.hpiInitNs;
+    uint64_t decision = checkStart + checked;
+    if (!syncCheck) {
+        decision = hpiUp + ((decidedAt != order.size()) ? doneAt[decidedAt] : allChecked);
+    }
+
+    busyUntil_ = hpiUp;
+    if (selectedFw_ != 0) {
+        waitDeadline_ = decision + waitMs * kMsToNs;
+    }
+
+    update_regs();
+    complete(hpi::RESP_RESET_COMPLETE, 0);
+    resetCompleteNs_ = busyUntil_;
+}
+
+uint64_t SimDevice::jump_ns() const
+{
+    /* Without the direct handoff, the firmware is started through a soft reset. */
+    return directHandoff_ ? timing_.handoffNs : timing_.onResetNs;
+}
+
+void SimDevice::start_fw(uint64_t ns)
+{
+    activeFw_ = selectedFw_;
+    bootNs_ = ns;
+    update_regs();
+
+    /* The application brings up its own HPI and reports RESET_COMPLETE. */
+    busyUntil_ = ns + timing_.hpiInitNs;
+    complete(hpi::RESP_RESET_COMPLETE, 0);
+    resetCompleteNs_ = busyUntil_;
+}
+
+uint8_t SimDevice::device_mode() const
+{
+    const uint8_t rowVal = (target_.rowSize == 256) ? 1 : ((target_.rowSize == 64) ? 3 : 0);
+
+    return static_cast<uint8_t>(0x80 | (rowVal << 4) | activeFw_);
+}
+
+void SimDevice::update_regs()
+{
+    regs_[hpi::REG_DEVICE_MODE] = device_mode();
+    regs_[hpi::REG_BOOT_MODE_REASON] = imgStatus_;
+    put_le16(&regs_[hpi::REG_BL_LAST_ROW], target_.blLastRow);
+
+    for (uint8_t slot = 1; slot <= 2; slot++) {
+        uint16_t loc = static_cast<uint16_t>(target_.row_count());
+        if (slot_valid(slot)) {
+            const size_t mdAddr = (static_cast<size_t>(metadata_row(slot)) + 1) * target_.rowSize - kMetadataSize;
+            loc = static_cast<uint16_t>(get_le16(&flash_[mdAddr + kMdBootLastRow]) + 1);
+        }
+        put_le16(&regs_[(slot == 1) ? hpi::REG_FW1_LOCATION : hpi::REG_FW2_LOCATION], loc);
+    }
+
+    update_mem_stats();
+    update_flash_verify();
+}
+
+void SimDevice::stack_use(uint32_t depth)
+{
+    stackPeak_ = std::max(stackPeak_, depth);
+}
+
+void SimDevice::update_mem_stats()
+{
+    uint8_t *p = &regs_[HPI_EXT_REG_MEM_STATS];
+
+    put_le16(p + 0, static_cast<uint16_t>(std::min<uint32_t>(target_.ramSize, 0xFFFF)));
+    put_le16(p + 2, static_cast<uint16_t>(stackModel_.staticRam));
+    put_le16(p + 4, static_cast<uint16_t>(target_.stackSize));
+    put_le16(p + 6, static_cast<uint16_t>(stackPeak_));
+}
+
+void SimDevice::update_flash_verify()
+{
+    uint8_t *p = &regs_[HPI_EXT_REG_FLASH_VERIFY];
+
+    put_le16(p + 0, verifyMismatches_);
+    put_le16(p + 2, 0);
+    put_le16(p + 4, verifyLastRow_);
+    put_le16(p + 6, verifyLastAttempts_);
+}
+
+void SimDevice::update_sleep_stats()
+{
+    /* bl_sleep_stats_t: every deep sleep of the model ends with an address match. */
+    const uint16_t ackUs = static_cast<uint16_t>(timing_.wakeAckNs / 1000);
+    uint8_t *p = &regs_[HPI_EXT_REG_SLEEP_STATS];
+    put_le16(p + 0, hpiWakes_);
+    put_le16(p + 2, hpiWakes_);
+    put_le16(p + 4, ackUs);
+    put_le16(p + 6, ackUs);
+}
+
+void SimDevice::advance_to(uint64_t ns)
+{
+    now_ = std::max(now_, ns);
+
+    if ((now_ >= busyUntil_) && (pendingResponse_ != hpi::RESP_NONE)) {
+        regs_[hpi::REG_RESPONSE] = pendingResponse_;
+        regs_[hpi::REG_RESPONSE + 1] = 0;
+        pendingResponse_ = hpi::RESP_NONE;
+        intrPending_ = true;
+    }
+
+    /* Boot-wait window elapsed without the host entering flashing mode. */
+    if ((activeFw_ == 0) && (selectedFw_ != 0) && !flashMode_ && (now_ >= waitDeadline_)) {
+        activeFw_ = selectedFw_;
+        bootNs_ = waitDeadline_ + jump_ns();
+        update_regs();
+    }
+}
+
+void SimDevice::bus_transfer(size_t bytes)
+{
+    /* The address match interrupt nests over the command in progress. */
+    if (now_ < busyUntil_) {
+        stack_use(busyDepth_ + stackModel_.isr);
+    }
+
+    /* Clock stretching: the transfer starts once the device is idle. */
+    advance_to(std::max(now_, busyUntil_));
+
+    /* SYS_DEEPSLEEP_ENABLE: an idle bootloader sleeps in deep sleep unless the boot-wait
+       timer runs. The address match wakes it and the clock is stretched until the ACK. */
+    if (deepSleep_ && in_bootloader() && (flashMode_ || (selectedFw_ == 0))) {
+        advance_to(now_ + timing_.deepSleepWakeNs + timing_.wakeAckNs);
+        hpiWakes_ = static_cast<uint16_t>(std::min<uint32_t>(hpiWakes_ + 1u, 0xFFFFu));
+        update_sleep_stats();
+    }
+
+    const uint64_t bits = static_cast<uint64_t>(bytes + kBusHeaderBytes) * 9;
+    advance_to(now_ + (bits * 1000000000ull) / timing_.i2cBitRateHz);
+    busBytes_ += bytes;
+
+    /* Idle main loop: the ISR nests over Cy_Hpi_Task(). */
+    stack_use(stackModel_.startup + stackModel_.hpiTask + stackModel_.isr);
+}
+
+void SimDevice::complete(uint8_t response, uint64_t costNs, uint32_t depth)
+{
+    busyDepth_ = std::max(depth, stackModel_.startup + stackModel_.hpiTask);
+    stack_use(busyDepth_);
+    busyUntil_ = std::max(busyUntil_, now_) + timing_.cmdNs + costNs;
+    pendingResponse_ = response;
+}
+
+void SimDevice::write(uint16_t addr, const uint8_t *data, size_t len)
+{
+    bus_transfer(len);
+
+    if (addr >= hpi::REG_FLASH_MEM) {
+        const size_t off = addr - hpi::REG_FLASH_MEM;
+        if (off < flashMem_.size()) {
+            std::memcpy(&flashMem_[off], data, std::min(len, flashMem_.size() - off));
+        }
+        return;
+    }
+
+    if ((addr == hpi::REG_INTR) && (len >= 1)) {
+        if ((data[0] & hpi::INTR_DEV) != 0) {
+            intrPending_ = false;
+        }
+        return;
+    }
+
+    if ((addr == HPI_EXT_REG_FLASH_READ) && (len >= HPI_EXT_REG_FLASH_READ_SIZE)) {
+        handle_flash_read(data);
+        return;
+    }
+
+    if ((addr == HPI_EXT_REG_FLASH_CHUNK) && (len >= HPI_EXT_FLASH_CHUNK_HDR_SIZE)) {
+        handle_flash_chunk(data, len);
+        return;
+    }
+
+    /* Other host writable registers are all below the response register. */
+    if ((addr + len) > hpi::REG_RESPONSE) {
+        return;
+    }
+    std::memcpy(&regs_[addr], data, len);
+    handle_command(addr);
+}
+
+void SimDevice::read(uint16_t addr, uint8_t *data, size_t len)
+{
+    bus_transfer(len);
+
+    for (size_t i = 0; i < len; i++) {
+        const size_t a = addr + i;
+        if (a >= hpi::REG_FLASH_MEM) {
+            const size_t off = a - hpi::REG_FLASH_MEM;
+            data[i] = (off < flashMem_.size()) ? flashMem_[off] : 0;
+        } else if (a == hpi::REG_INTR) {
+            data[i] = intrPending_ ? hpi::INTR_DEV : 0;
+        } else {
+            data[i] = (a < regs_.size()) ? regs_[a] : 0;
+        }
+    }
+}
+
+void SimDevice::handle_command(uint16_t addr)
+{
+    const uint8_t sig = regs_[addr];
+
+    switch (addr) {
+    case hpi::REG_JUMP_TO_BOOT:
+        if ((sig == hpi::SIG_JUMP_TO_BOOT) && !in_bootloader()) {
+            reset(kBootModeRqtSig);
+        } else if (sig == hpi::SIG_JUMP_TO_ALT_FW) {
+            /* Boot the other image of the dual application layout. */
+            reset(static_cast<uint16_t>(kBootRqtSigBase + ((active_fw() == 1) ? 2 : 1)));
+        } else {
+            complete(hpi::RESP_INVALID_ARGUMENT, 0);
+        }
+        break;
+
+    case hpi::REG_RESET:
+        if ((sig == hpi::SIG_RESET) && (regs_[addr + 1] == hpi::RESET_TYPE_DEVICE)) {
+            reset(0);
+        } else if (sig == hpi::SIG_RESET) {
+            complete(hpi::RESP_SUCCESS, 0);
+        } else {
+            complete(hpi::RESP_INVALID_ARGUMENT, 0);
+        }
+        break;
+
+    case hpi::REG_ENTER_FLASH_MODE:
+        complete(set_flash_mode(sig == hpi::SIG_FLASH_MODE), 0);
+        break;
+
+    case hpi::REG_VALIDATE_FW: {
+        uint64_t cost = 0;
+        const uint8_t resp = validate_slot(sig, &cost);
+        complete(resp, cost, stackModel_.startup + stackModel_.hpiTask + stackModel_.validate);
+        break;
+    }
+
+    case hpi::REG_FLASH_RW:
+        handle_flash_rw();
+        break;
+
+    default:
+        break;
+    }
+}
+
+void SimDevice::handle_flash_read(const uint8_t *cmd)
+{
+    const uint16_t length = get_le16(cmd + 2);
+    const uint32_t addr = get_le32(cmd + 4);
+    const uint8_t *data = nullptr;
+
+    if ((cmd[0] != HPI_EXT_FLASH_READ_SIG) || !in_bootloader()) {
+        complete(hpi::RESP_INVALID_COMMAND, 0);
+        return;
+    }
+    if (length > hpi::FLASH_READ_MAX) {
+        complete(hpi::RESP_INVALID_ARGUMENT, 0);
+        return;
+    }
+
+    const uint8_t resp = read_flash(addr, length, &data);
+    if (resp == hpi::RESP_FLASH_DATA_AVAIL) {
+        std::memcpy(flashMem_.data(), data, length);
+    }
+    complete(resp, 0);
+}
+
+/* Same checks as hpi_ext_flash_chunk() and flash_row_chunk_write(). */
+void SimDevice::handle_flash_chunk(const uint8_t *cmd, size_t len)
+{
+    const uint8_t length = cmd[1];
+    const uint16_t row = get_le16(cmd + 2);
+    const uint16_t offset = get_le16(cmd + 4);
+
+    if ((cmd[0] != HPI_EXT_FLASH_CHUNK_SIG) || !in_bootloader()) {
+        complete(hpi::RESP_INVALID_COMMAND, 0);
+        return;
+    }
+    if ((length > HPI_EXT_FLASH_CHUNK_MAX) || (len < HPI_EXT_FLASH_CHUNK_HDR_SIZE + length)) {
+        complete(hpi::RESP_INVALID_ARGUMENT, 0);
+        return;
+    }
+    if (!flashMode_) {
+        complete(hpi::RESP_FLASH_UPDATE_FAILED, 0);
+        return;
+    }
+    if ((length == 0) || (offset >= target_.rowSize) || (length > target_.rowSize - offset) ||
+        ((offset != 0) && ((row != chunkRowNum_) || (offset != chunkNext_)))) {
+        complete(hpi::RESP_INVALID_ARGUMENT, 0);
+        return;
+    }
+
+    chunkRow_.resize(target_.rowSize);
+    chunkRowNum_ = row;
+    std::memcpy(&chunkRow_[offset], cmd + HPI_EXT_FLASH_CHUNK_HDR_SIZE, length);
+    chunkNext_ = static_cast<uint16_t>(offset + length);
+    if (chunkNext_ != target_.rowSize) {
+        complete(hpi::RESP_SUCCESS, 0);
+        return;
+    }
+
+    uint64_t cost = 0;
+    chunkNext_ = 0;
+    const uint8_t resp = program_row(row, chunkRow_.data(), &cost);
+    complete(resp, cost, stackModel_.startup + stackModel_.hpiTask + stackModel_.flashWrite);
+    update_mem_stats();
+}
+
+void SimDevice::handle_flash_rw()
+{
+    const uint8_t sig = regs_[hpi::REG_FLASH_RW];
+    const uint8_t cmd = regs_[hpi::REG_FLASH_RW + 1];
+    const uint16_t row = get_le16(&regs_[hpi::REG_FLASH_RW + 2]);
+
+    if ((sig != hpi::SIG_FLASH_RW) || !in_bootloader()) {
+        complete(hpi::RESP_INVALID_COMMAND, 0);
+        return;
+    }
+
+    if (cmd == hpi::FLASH_CMD_READ) {
+        /* flash_row_read() goes through flash_read(). */
+        const uint8_t *data = nullptr;
+        const uint8_t resp = read_flash(static_cast<uint32_t>(row) * target_.rowSize, target_.rowSize, &data);
+        if (resp == hpi::RESP_FLASH_DATA_AVAIL) {
+            std::memcpy(flashMem_.data(), data, target_.rowSize);
+        }
+        complete(resp, 0);
+    } else if (cmd == hpi::FLASH_CMD_WRITE) {
+        uint64_t cost = 0;
+        const uint8_t resp = program_row(row, flashMem_.data(), &cost);
+        complete(resp, cost, stackModel_.startup + stackModel_.hpiTask + stackModel_.flashWrite);
+        update_mem_stats();
+    } else {
+        complete(flashMode_ ? hpi::RESP_INVALID_ARGUMENT : hpi::RESP_FLASH_UPDATE_FAILED, 0);
+    }
+}
+
+uint8_t SimDevice::set_flash_mode(bool enable)
+{
+    if (!in_bootloader()) {
+        return hpi::RESP_NOT_SUPPORTED;
+    }
+    /* boot_record_revoke(): the SFLASH row write is not part of the modeled command time. */
+    if (enable && (recordSlot_ != 0) && !row_protected(metadata_row(recordSlot_))) {
+        recordSlot_ = 0;
+    }
+    flashMode_ = enable;
+    chunkNext_ = 0;
+    return hpi::RESP_SUCCESS;
+}
+
+uint8_t SimDevice::read_flash(uint32_t addr, uint16_t length, const uint8_t **dataP) const
+{
+    /* Same checks as flash_read(). */
+    if (!flashMode_) {
+        return hpi::RESP_FLASH_UPDATE_FAILED;
+    }
+    if ((length == 0) || (length > hpi::FLASH_SPAN_MAX) || (addr >= target_.flashSize) ||
+        (length > (target_.flashSize - addr)) || ((addr >> target_.row_shift()) <= target_.blLastRow)) {
+        return hpi::RESP_INVALID_ARGUMENT;
+    }
+
+    *dataP = &flash_[addr];
+    return hpi::RESP_FLASH_DATA_AVAIL;
+}
+
+uint8_t SimDevice::program_row(uint16_t row, uint8_t *data, uint64_t *costNs)
+{
+    if (!flashMode_) {
+        return hpi::RESP_FLASH_UPDATE_FAILED;
+    }
+    if ((row <= target_.blLastRow) || (row > target_.last_row()) || row_protected(row)) {
+        return hpi::RESP_INVALID_ARGUMENT;
+    }
+
+    /* A marginal row is caught by the read back and programmed once more. */
+    const uint64_t programNs = timing_.rowWriteNs + timing_.verifyNsPerByte * target_.rowSize;
+    *costNs += programNs;
+    rowWrites_++;
+    if ((marginalEvery_ != 0) && ((rowWrites_ % marginalEvery_) == 0) && (timing_.verifyRetries != 0)) {
+        *costNs += programNs;
+        verifyMismatches_++;
+        verifyLastRow_ = row;
+        verifyLastAttempts_ = 2;
+    }
+    const uint8_t slot = slot_from_md_row(row);
+    if (slot != 0) {
+        /* boot_get_next_boot_seq() validates each of the other slots. */
+        for (uint8_t other = 1; other <= slotCount_; other++) {
+            if (other != slot) {
+                validate(other, costNs);
+            }
+        }
+        put_le32(&data[target_.rowSize - kMetadataSize + kMdBootSeq], next_boot_seq(slot));
+    }
+
+    std::memcpy(&flash_[static_cast<size_t>(row) * target_.rowSize], data, target_.rowSize);
+    update_flash_verify();
+    return hpi::RESP_SUCCESS;
+}
+
+uint8_t SimDevice::validate_slot(uint8_t slot, uint64_t *costNs)
+{
+    const bool ok = (slot >= 1) && (slot <= slotCount_) && validate(slot, costNs);
+
+    /* boot_record_commit() only writes the SFLASH row when the record changes. */
+    if (ok && bootRecord_ && !record_matches(slot)) {
+        recordSlot_ = slot;
+        recordMd_ = slot_metadata(slot);
+        *costNs += timing_.rowWriteNs;
+    }
+
+    return ok ? hpi::RESP_SUCCESS : hpi::RESP_INVALID_FW;
+}
+
+} // namespace pmg1
@@ -0,0 +1,237 @@
+/******************************************************************************
+* File Name: sim_device.h
+*
+* Description: Host model of a PMG1 device running the bootloader. The model
+*              implements the HPI register interface, the flash access rules
+*              and boot selection of the firmware, a timing model driven by a
+*              virtual clock, and a stack usage model that is published
+*              through the HPI_EXT_REG_MEM_STATS register.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_SIM_DEVICE_H
+#define PMG1_HOST_SIM_DEVICE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "hpi_proto.h"
+#include "metadata.h"
+#include "target.h"
+
+namespace pmg1 {
+
+/* Device timing, in nanoseconds unless noted otherwise. */
+struct SimTiming {
+    uint32_t i2cBitRateHz = 400000;     /* SCL frequency. */
+    uint64_t rowWriteNs = 8000000;      /* SROM erase + program of one row. */
+    uint64_t crcNsPerByte = 330;        /* calculate_crc32() at 48 MHz. */
+    uint64_t verifyNsPerByte = 50;      /* Read back compare after programming, one word at a time. */
+    uint32_t verifyRetries = 2;         /* PMG1_FLASH_VERIFY_RETRIES. */
+    uint64_t cmdNs = 20000;             /* Cy_Hpi_Task() command dispatch. */
+    uint64_t onResetNs = 1000000;       /* Reset to Cy_OnResetUser(), which starts the image on
+                                           PMG1_BOOT_TYPE_START_APP. */
+    uint64_t startupNs = 500000;        /* Cy_OnResetUser() to the image check: C start-up, clock. */
+    uint64_t hpiInitNs = 300000;        /* Peripheral, pin and HPI set-up after the boot decision. */
+    uint64_t handoffNs = 30000;         /* PMG1_BOOT_DIRECT_HANDOFF: peripheral and clock reset. */
+    uint64_t deepSleepWakeNs = 35000;   /* SYS_DEEPSLEEP_ENABLE: deep sleep wake-up of the device. */
+    uint64_t wakeAckNs = 12000;         /* CPU resume to the end of the HPI interrupt that ACKs. */
+};
+
+/* Stack frames of the bootloader call paths, in bytes. The values are upper
+ * bounds taken from the -Os GCC build (-fstack-usage) and are refined by the
+ * device reported high-water mark on real hardware.
+ */
+struct SimStackModel {
+    uint32_t startup = 64;              /* Reset handler, main. */
+    uint32_t hpiTask = 72;              /* Cy_Hpi_Task() and command dispatch. */
+    uint32_t flashWrite = 56;           /* hpi_flash_row_write() down to the SROM call. */
+    uint32_t validate = 48;             /* boot_validate_firmware(), calculate_crc32(). */
+    uint32_t isr = 32 + 48;             /* Exception frame and the HPI I2C ISR. */
+    uint32_t staticRam = 0;             /* data + bss; 0 selects the target default. */
+};
+
+class SimDevice {
+public:
+    explicit SimDevice(const TargetInfo &target, uint8_t slotCount = 2,
+                       const SimTiming &timing = SimTiming(),
+                       const SimStackModel &stack = SimStackModel());
+
+    const TargetInfo &target() const { return target_; }
+    uint8_t slot_count() const { return slotCount_; }
+    const SimTiming &timing() const { return timing_; }
+
+    /* Power cycle: the no-init RAM state is lost. */
+    void power_on();
+
+    /* Software reset with a boot-loader run type in the no-init RAM, as set by the
+       application: kBootModeRqtSig, kBootRqtSigBase + slot or kBootTypeStartApp. */
+    void soft_reset(uint16_t runType);
+
+    /* Boot-loader build options that change the boot sequence. */
+    void set_background_check(bool enable) { bgCheck_ = enable; }
+    void set_direct_handoff(bool enable) { directHandoff_ = enable; }
+    void set_deep_sleep(bool enable) { deepSleep_ = enable; }
+
+    /* PMG1_BOOT_RECORD_ENABLE: validating a slot stores its boot-decision record, which
+       survives power cycles like the SFLASH row holding it. */
+    void set_boot_record(bool enable) { bootRecord_ = enable; }
+
+    /* HPI register access. Accesses stall while a command is being processed,
+       as the SCB stretches the clock while the CPU is busy. */
+    void write(uint16_t addr, const uint8_t *data, size_t len);
+    void read(uint16_t addr, uint8_t *data, size_t len);
+
+    /* EC_INT line, active low on the board: true when asserted. */
+    bool ec_int() const { return intrPending_; }
+
+    /* Virtual clock. */
+    uint64_t now_ns() const { return now_; }
+    void advance_to(uint64_t ns);
+    uint64_t busy_until_ns() const { return busyUntil_; }
+
+    /* Direct flash access, as through the SWD programmer. */
+    std::vector<uint8_t> &flash() { return flash_; }
+    uint16_t metadata_row(uint8_t slot) const;
+
+    /* Boot state. */
+    uint8_t active_fw() const { return activeFw_; }
+    bool in_bootloader() const { return activeFw_ == 0; }
+    bool slot_valid(uint8_t slot) const;
+    uint64_t last_boot_ns() const { return bootNs_; }
+
+    /* DEVICE_MODE and BOOT_MODE_REASON register values. */
+    uint8_t device_mode() const;
+    uint8_t boot_reason() const { return imgStatus_; }
+
+    /* Time of the last reset, and of its RESET_COMPLETE event: 0 if the firmware was
+       started without bringing up HPI. */
+    uint64_t last_reset_ns() const { return resetNs_; }
+    uint64_t reset_complete_ns() const { return resetCompleteNs_; }
+
+    /* Make every Nth row write read back wrong once, as a marginal row would.
+       0 disables the fault. */
+    void set_marginal_rows(uint32_t every) { marginalEvery_ = every; }
+
+    /* Flashing operations behind the HPI commands, also used by the framed command layer
+       of SimUartLink. They return the HPI response code; costNs collects the device time. */
+    uint8_t set_flash_mode(bool enable);
+    uint8_t read_flash(uint32_t addr, uint16_t length, const uint8_t **dataP) const;
+    uint8_t program_row(uint16_t row, uint8_t *data, uint64_t *costNs);
+    uint8_t validate_slot(uint8_t slot, uint64_t *costNs);
+
+    /* Number of bytes moved over the bus, for throughput reporting. */
+    uint64_t bus_bytes() const { return busBytes_; }
+
+private:
+    void reset(uint16_t runType);
+    void boot();
+    std::vector<uint8_t> check_order(uint8_t rqtSlot) const;
+    Metadata slot_metadata(uint8_t slot) const;
+    bool validate(uint8_t slot, uint64_t *costNs) const;
+    bool record_matches(uint8_t slot) const;
+    uint64_t jump_ns() const;
+    void start_fw(uint64_t ns);
+    uint32_t next_boot_seq(uint8_t slot) const;
+    bool row_protected(uint16_t row) const;
+    uint8_t slot_from_md_row(uint16_t row) const;
+
+    void bus_transfer(size_t bytes);
+    void complete(uint8_t response, uint64_t costNs, uint32_t depth = 0);
+    void handle_command(uint16_t addr);
+    void handle_flash_rw();
+    void handle_flash_read(const uint8_t *cmd);
+    void handle_flash_chunk(const uint8_t *cmd, size_t len);
+    void update_regs();
+
+    void stack_use(uint32_t depth);
+    void update_mem_stats();
+    void update_flash_verify();
+    void update_sleep_stats();
+
+    const TargetInfo &target_;
+    uint8_t slotCount_;
+    SimTiming timing_;
+    SimStackModel stackModel_;
+
+    std::vector<uint8_t> flash_;
+    std::vector<uint8_t> regs_;
+    std::vector<uint8_t> flashMem_;
+
+    /* Row assembled from HPI_EXT_REG_FLASH_CHUNK commands: chunkNext_ is 0 when none. */
+    std::vector<uint8_t> chunkRow_;
+    uint16_t chunkRowNum_ = 0;
+    uint16_t chunkNext_ = 0;
+
+    uint64_t now_ = 0;
+    uint64_t busyUntil_ = 0;
+    uint64_t bootNs_ = 0;
+    uint64_t resetNs_ = 0;
+    uint64_t resetCompleteNs_ = 0;
+    uint64_t waitDeadline_ = 0;
+    uint64_t busBytes_ = 0;
+
+    uint8_t pendingResponse_ = hpi::RESP_NONE;
+    bool intrPending_ = false;
+    bool flashMode_ = false;
+    uint8_t activeFw_ = 0;
+    uint8_t selectedFw_ = 0;
+    uint8_t imgStatus_ = 0;
+    uint16_t runType_ = 0;
+    bool bgCheck_ = false;
+    bool directHandoff_ = false;
+    bool deepSleep_ = false;
+    bool bootRecord_ = false;
+
+    /* Boot-decision record: slot 0 when there is none. */
+    uint8_t recordSlot_ = 0;
+    Metadata recordMd_;
+
+    uint32_t stackPeak_ = 0;
+    uint32_t busyDepth_ = 0;
+
+    uint32_t marginalEvery_ = 0;
+    uint32_t rowWrites_ = 0;
+    uint16_t verifyMismatches_ = 0;
+    uint16_t verifyLastRow_ = 0;
+    uint16_t verifyLastAttempts_ = 0;
+
+    uint16_t hpiWakes_ = 0;
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_SIM_DEVICE_H */
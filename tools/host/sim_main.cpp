@@ -0,0 +1,317 @@
+/******************************************************************************
+* File Name: sim_main.cpp
+*
+* Description: pmg1-sim. Runs an update session against the device model and
+*              checks the RAM usage reported through HPI_EXT_REG_MEM_STATS.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "frame_updater.h"
+#include "image.h"
+#include "sim_device.h"
+#include "sim_transport.h"
+#include "uart_link.h"
+#include "updater.h"
+
+using namespace pmg1;
+
+namespace {
+
+struct MemStats {
+    uint16_t ramSize;
+    uint16_t staticSize;
+    uint16_t stackSize;
+    uint16_t stackPeak;
+};
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: pmg1-sim [--target NAME] [--slots N] [--slot N] [--size BYTES]\n"
+        "                [--stack-margin PERCENT] [--marginal N] [--uart BAUD] [--chunk BYTES]\n"
+        "                [--no-sleep]\n"
+        "targets: %s\n", target_names().c_str());
+}
+
+struct VerifyStats {
+    uint16_t mismatches;
+    uint16_t failedRows;
+};
+
+bool read_verify_stats(Transport &transport, VerifyStats *stats)
+{
+    uint8_t raw[HPI_EXT_REG_FLASH_VERIFY_SIZE];
+
+    if (!transport.read(HPI_EXT_REG_FLASH_VERIFY, raw, sizeof(raw))) {
+        return false;
+    }
+    stats->mismatches = get_le16(raw + 0);
+    stats->failedRows = get_le16(raw + 2);
+    return true;
+}
+
+struct SleepStats {
+    uint16_t deepSleeps;
+    uint16_t hpiWakes;
+    uint16_t wakeLastUs;
+    uint16_t wakeMaxUs;
+};
+
+bool read_sleep_stats(Transport &transport, SleepStats *stats)
+{
+    uint8_t raw[HPI_EXT_REG_SLEEP_STATS_SIZE];
+
+    if (!transport.read(HPI_EXT_REG_SLEEP_STATS, raw, sizeof(raw))) {
+        return false;
+    }
+    stats->deepSleeps = get_le16(raw + 0);
+    stats->hpiWakes = get_le16(raw + 2);
+    stats->wakeLastUs = get_le16(raw + 4);
+    stats->wakeMaxUs = get_le16(raw + 6);
+    return true;
+}
+
+bool read_mem_stats(Transport &transport, MemStats *stats)
+{
+    uint8_t raw[HPI_EXT_REG_MEM_STATS_SIZE];
+
+    if (!transport.read(HPI_EXT_REG_MEM_STATS, raw, sizeof(raw))) {
+        return false;
+    }
+    stats->ramSize = get_le16(raw + 0);
+    stats->staticSize = get_le16(raw + 2);
+    stats->stackSize = get_le16(raw + 4);
+    stats->stackPeak = get_le16(raw + 6);
+    return true;
+}
+
+/* Flash the image, then back it up and fetch its metadata while still in flashing mode.
+   Updater and FrameUpdater run the same sequence over HPI and over a framed link. */
+template <typename U>
+bool update_and_read_back(U &updater, const UpdateImage &image, uint32_t imageAddr, uint32_t imageSize,
+                          uint32_t mdAddr, std::vector<uint8_t> *backup, uint32_t *backupCmds,
+                          std::vector<uint8_t> *mdData)
+{
+    if (!updater.run(image) || !updater.read_flash(imageAddr, imageSize, backup)) {
+        return false;
+    }
+    *backupCmds = updater.read_commands();
+    return updater.read_flash(mdAddr, kMetadataSize, mdData);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string targetName = "PMG1-CY7110";
+    unsigned slots = 2;
+    unsigned slot = 1;
+    unsigned imageSize = 0;
+    unsigned margin = 25;
+    unsigned marginal = 0;
+    unsigned baud = 0;
+    unsigned chunk = 0;
+    bool sleep = true;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasArg = (i + 1) < argc;
+        if ((std::strcmp(argv[i], "--target") == 0) && hasArg) {
+            targetName = argv[++i];
+        } else if ((std::strcmp(argv[i], "--slots") == 0) && hasArg) {
+            slots = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--slot") == 0) && hasArg) {
+            slot = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--size") == 0) && hasArg) {
+            imageSize = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--stack-margin") == 0) && hasArg) {
+            margin = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--marginal") == 0) && hasArg) {
+            marginal = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--uart") == 0) && hasArg) {
+            baud = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--chunk") == 0) && hasArg) {
+            chunk = std::strtoul(argv[++i], nullptr, 0);
+        } else if (std::strcmp(argv[i], "--no-sleep") == 0) {
+            sleep = false;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    const TargetInfo *target = find_target(targetName);
+    if ((target == nullptr) || (slots < 2) || (slots > 4) || (slot < 1) || (slot > slots) ||
+        (chunk > HPI_EXT_FLASH_CHUNK_MAX) || ((chunk != 0) && (baud != 0))) {
+        usage();
+        return 2;
+    }
+
+    SimDevice dev(*target, static_cast<uint8_t>(slots));
+    dev.set_marginal_rows(marginal);
+    /* SYS_DEEPSLEEP_ENABLE is set by the project Makefile; the UART transport keeps the
+       device in CPU sleep. */
+    dev.set_deep_sleep(sleep && (baud == 0));
+    SimTransport transport(dev, true);
+    const uint16_t appRows = static_cast<uint16_t>(target->last_row() - slots - target->blLastRow);
+    const uint16_t slotRows = static_cast<uint16_t>(appRows / slots);
+    const uint16_t firstRow = static_cast<uint16_t>(target->blLastRow + 1 + (slot - 1) * slotRows);
+
+    if (imageSize == 0) {
+        imageSize = slotRows * target->rowSize;
+    }
+    if (imageSize > static_cast<unsigned>(slotRows) * target->rowSize) {
+        std::fprintf(stderr, "image of %u bytes does not fit a %u row slot\n", imageSize, slotRows);
+        return 2;
+    }
+
+    /* Pseudo random image, so that the CRC check is meaningful. */
+    std::vector<uint8_t> binary(imageSize);
+    uint32_t lfsr = 0x1234567u;
+    for (uint8_t &b : binary) {
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xD0000001u);
+        b = static_cast<uint8_t>(lfsr);
+    }
+
+    std::string error;
+    UpdateImage image;
+    if (!make_image_from_binary(*target, static_cast<uint8_t>(slot), firstRow, binary, kWaitTimeDefault,
+                                &image, &error)) {
+        std::fprintf(stderr, "pmg1-sim: %s\n", error.c_str());
+        return 2;
+    }
+
+    /* Read the RAM usage before the jump, while the bootloader is still running. */
+    UpdateOptions options;
+    options.jump = false;
+    options.chunkSize = static_cast<uint16_t>(chunk);
+    Updater updater(transport, options);
+    dev.power_on();
+
+    std::vector<uint8_t> backup;
+    std::vector<uint8_t> mdData;
+    uint32_t backupCmds = 0;
+    uint32_t mdCmds = 0;
+    std::vector<PhaseStats> phases;
+    std::string updateError;
+    const uint32_t mdAddr = (image.metadataRow.row + 1u) * target->rowSize - static_cast<uint32_t>(kMetadataSize);
+    bool ok;
+
+    /* The same session can run over the UART; HPI stays up for the statistics registers. */
+    std::unique_ptr<SimUartLink> link;
+    std::unique_ptr<FrameUpdater> frameUpdater;
+    if (baud == 0) {
+        ok = update_and_read_back(updater, image, firstRow * target->rowSize, imageSize, mdAddr, &backup,
+                                  &backupCmds, &mdData);
+        mdCmds = updater.read_commands();
+    } else {
+        link.reset(new SimUartLink(dev, baud));
+        frameUpdater.reset(new FrameUpdater(*link, options));
+        ok = update_and_read_back(*frameUpdater, image, firstRow * target->rowSize, imageSize, mdAddr, &backup,
+                                  &backupCmds, &mdData);
+        mdCmds = frameUpdater->read_commands();
+    }
+
+    MemStats stats = {};
+    VerifyStats verify = {};
+    SleepStats sleepStats = {};
+    ok = ok && read_mem_stats(transport, &stats) && read_verify_stats(transport, &verify) &&
+         read_sleep_stats(transport, &sleepStats);
+
+    /* The framed reset does not wait for the application: give it the boot-wait window. */
+    if (baud == 0) {
+        ok = ok && updater.jump();
+        phases = updater.phases();
+        updateError = updater.error();
+    } else {
+        ok = ok && frameUpdater->jump();
+        link->sleep_ms(options.resetTimeoutMs);
+        phases = frameUpdater->phases();
+        updateError = frameUpdater->error();
+    }
+
+    if (!ok) {
+        std::fprintf(stderr, "pmg1-sim: %s\n", updateError.c_str());
+    } else if (dev.active_fw() != slot) {
+        std::fprintf(stderr, "device booted FW%u, expected FW%u\n", dev.active_fw(), slot);
+        ok = false;
+    } else if (backup != binary) {
+        std::fprintf(stderr, "pmg1-sim: image read back does not match\n");
+        ok = false;
+    } else if (Metadata::parse(mdData.data()).fwCrc32 != image.metadata().fwCrc32) {
+        std::fprintf(stderr, "pmg1-sim: metadata read back does not match\n");
+        ok = false;
+    }
+
+    uint64_t updateNs = 0;
+    for (const PhaseStats &phase : phases) {
+        updateNs += (phase.name != "jump") ? phase.ns : 0;
+    }
+
+    std::printf("target        %s, %u slots, %u byte rows\n", target->name, slots, target->rowSize);
+    std::printf("image         FW%u, %u bytes at row 0x%04x, %.1f ms, %.1f KB/s\n", slot, imageSize,
+                firstRow, updateNs / 1e6, (imageSize / 1024.0) / (updateNs / 1e9));
+    if (baud != 0) {
+        std::printf("transport     UART at %u baud\n", baud);
+    }
+    std::printf("flash verify  %u rows programmed again, %u failed\n", verify.mismatches, verify.failedRows);
+    std::printf("flash read    %u bytes in %u commands, metadata in %u\n", imageSize, backupCmds, mdCmds);
+    std::printf("deep sleep    %u wake-ups, wake to ACK %u us, max %u us\n", sleepStats.hpiWakes,
+                sleepStats.wakeLastUs, sleepStats.wakeMaxUs);
+    std::printf("ram           %u bytes, %u static, %u stack\n", stats.ramSize, stats.staticSize,
+                stats.stackSize);
+    std::printf("stack peak    %u bytes (%u%%)\n", stats.stackPeak,
+                (stats.stackSize != 0) ? (stats.stackPeak * 100u) / stats.stackSize : 0u);
+
+    /* Keep the requested headroom so that the unused stack can be given to transfer buffers safely. */
+    if ((stats.stackSize == 0) ||
+        (static_cast<unsigned>(stats.stackPeak) * 100u > static_cast<unsigned>(stats.stackSize) * (100u - margin))) {
+        std::fprintf(stderr, "stack peak %u leaves less than %u%% of the %u byte stack\n",
+                     stats.stackPeak, margin, stats.stackSize);
+        ok = false;
+    }
+    if ((stats.staticSize + stats.stackSize) > stats.ramSize) {
+        std::fprintf(stderr, "static RAM and stack exceed the device RAM\n");
+        ok = false;
+    }
+
+    return ok ? 0 : 1;
+}
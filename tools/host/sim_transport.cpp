@@ -0,0 +1,153 @@
+/******************************************************************************
+* File Name: sim_transport.cpp
+*
+* Description: Transport to a device model.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "sim_transport.h"
+
+#include <algorithm>
+
+#include "hpi_proto.h"
+
+namespace pmg1 {
+
+namespace {
+
+/* INTR poll interval, as used by the I2C transport. */
+constexpr uint64_t kPollIntervalNs = 500000;
+
+} // namespace
+
+/* Bring the device up to the bus time. */
+void SimTransport::sync()
+{
+    if (clock_ != nullptr) {
+        device_.advance_to(clock_->ns);
+    }
+}
+
+/* The device time after an access is the new bus time. */
+void SimTransport::publish()
+{
+    if (clock_ != nullptr) {
+        clock_->ns = std::max(clock_->ns, device_.now_ns());
+    }
+}
+
+uint64_t SimTransport::now_ns()
+{
+    sync();
+    return device_.now_ns();
+}
+
+bool SimTransport::interrupt_asserted(bool *asserted)
+{
+    sync();
+    *asserted = device_.ec_int();
+    return true;
+}
+
+bool SimTransport::transfer(const BusOp *ops, size_t count)
+{
+    sync();
+    for (size_t i = 0; i < count; i++) {
+        if (ops[i].kind == BusOp::WRITE) {
+            device_.write(ops[i].reg, ops[i].data, ops[i].len);
+        } else {
+            device_.read(ops[i].reg, ops[i].data, ops[i].len);
+        }
+    }
+    publish();
+    return true;
+}
+
+bool SimTransport::wait_interrupt(uint32_t timeoutMs)
+{
+    sync();
+
+    const uint64_t deadline = device_.now_ns() + static_cast<uint64_t>(timeoutMs) * 1000000u;
+    const bool ok = pollIntr_ ? poll_interrupt(deadline) : watch_interrupt(deadline);
+
+    publish();
+    return ok;
+}
+
+bool SimTransport::poll_interrupt(uint64_t deadline)
+{
+    uint8_t intr = 0;
+
+    for (;;) {
+        device_.read(hpi::REG_INTR, &intr, 1);
+        if ((intr & hpi::INTR_DEV) != 0) {
+            return true;
+        }
+        if (device_.now_ns() >= deadline) {
+            error_ = "timeout waiting for EC_INT";
+            return false;
+        }
+        device_.advance_to(device_.now_ns() + kPollIntervalNs);
+    }
+}
+
+bool SimTransport::watch_interrupt(uint64_t deadline)
+{
+    if (!device_.ec_int() && (device_.busy_until_ns() <= deadline)) {
+        device_.advance_to(device_.busy_until_ns());
+    }
+    if (!device_.ec_int()) {
+        device_.advance_to(deadline);
+        if (!device_.ec_int()) {
+            error_ = "timeout waiting for EC_INT";
+            return false;
+        }
+    }
+    return true;
+}
+
+void SimTransport::sleep_ms(uint32_t ms)
+{
+    sync();
+    device_.advance_to(device_.now_ns() + static_cast<uint64_t>(ms) * 1000000u);
+    publish();
+}
+
+std::string SimTransport::name() const
+{
+    return std::string("sim:") + device_.target().name;
+}
+
+} // namespace pmg1
@@ -0,0 +1,86 @@
+/******************************************************************************
+* File Name: sim_transport.h
+*
+* Description: Transport to a device model. Time is the virtual clock of the
+*              model, so throughput figures reflect the modelled bus and
+*              flash timing rather than the speed of the host.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_SIM_TRANSPORT_H
+#define PMG1_HOST_SIM_TRANSPORT_H
+
+#include "sim_device.h"
+#include "transport.h"
+
+namespace pmg1 {
+
+/* Clock of a bus shared by several device models. Transfers to one device
+ * take bus time from all of them. */
+struct SimClock {
+    uint64_t ns = 0;
+};
+
+class SimTransport : public Transport {
+public:
+    /* pollIntr: poll the INTR register instead of watching EC_INT, as the I2C
+       transport does when EC_INT is not wired. Each poll runs the HPI ISR on
+       top of the command in progress, which exercises the deepest stack path. */
+    explicit SimTransport(SimDevice &device, bool pollIntr = false, SimClock *clock = nullptr)
+        : device_(device), pollIntr_(pollIntr), clock_(clock) {}
+
+    bool transfer(const BusOp *ops, size_t count) override;
+    bool wait_interrupt(uint32_t timeoutMs) override;
+    bool interrupt_asserted(bool *asserted) override;
+    uint64_t now_ns() override;
+    void sleep_ms(uint32_t ms) override;
+    std::string name() const override;
+
+    SimDevice &device() { return device_; }
+
+private:
+    void sync();
+    void publish();
+    bool poll_interrupt(uint64_t deadline);
+    bool watch_interrupt(uint64_t deadline);
+
+    SimDevice &device_;
+    bool pollIntr_;
+    SimClock *clock_;
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_SIM_TRANSPORT_H */
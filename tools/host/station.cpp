@@ -0,0 +1,214 @@
+/******************************************************************************
+* File Name: station.cpp
+*
+* Description: Update pipeline for all devices on one bus.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "station.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <limits>
+#include <memory>
+
+#include <poll.h>
+
+namespace pmg1 {
+
+namespace {
+
+/* Poll interval for devices without an EC_INT line. */
+constexpr int kPollIntervalMs = 1;
+
+} // namespace
+
+BusPipeline::BusPipeline(const std::vector<StationDevice> &devices, const UpdateImage &image,
+                         const UpdateOptions &options, SimClock *clock, bool interleave)
+    : devices_(devices), image_(image), options_(options), clock_(clock), interleave_(interleave),
+      results_(devices.size())
+{
+    for (size_t i = 0; i < devices_.size(); i++) {
+        results_[i].label = devices_[i].label;
+    }
+}
+
+uint64_t BusPipeline::now_ns()
+{
+    if (clock_ != nullptr) {
+        return clock_->ns;
+    }
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void BusPipeline::run()
+{
+    const uint64_t start = now_ns();
+
+    if (interleave_) {
+        std::vector<size_t> all(devices_.size());
+        for (size_t i = 0; i < all.size(); i++) {
+            all[i] = i;
+        }
+        run_group(all);
+    } else {
+        for (size_t i = 0; i < devices_.size(); i++) {
+            run_group(std::vector<size_t>(1, i));
+        }
+    }
+    elapsedNs_ = now_ns() - start;
+}
+
+void BusPipeline::run_group(const std::vector<size_t> &members)
+{
+    std::vector<std::unique_ptr<UpdateSession>> owned;
+    std::vector<UpdateSession *> sessions;
+    std::vector<UpdateSession::Wait> waits;
+    std::vector<uint64_t> starts;
+
+    for (size_t idx : members) {
+        owned.emplace_back(new UpdateSession(*devices_[idx].transport, &image_, options_));
+        sessions.push_back(owned.back().get());
+        starts.push_back(now_ns());
+        waits.push_back(sessions.back()->step());
+    }
+
+    for (;;) {
+        bool active = false;
+        bool progressed = false;
+
+        /* Round robin: every device that can make progress issues its next command. */
+        for (size_t k = 0; k < members.size(); k++) {
+            UpdateSession &session = *sessions[k];
+            bool asserted = false;
+
+            switch (waits[k]) {
+            case UpdateSession::Wait::INTERRUPT:
+                active = true;
+                if (!session.transport().interrupt_asserted(&asserted)) {
+                    session.abort(session.transport().last_error());
+                    waits[k] = UpdateSession::Wait::FAILED;
+                    progressed = true;
+                } else if (asserted) {
+                    waits[k] = session.step();
+                    progressed = true;
+                } else if (now_ns() >= session.wake_ns()) {
+                    session.abort("timeout waiting for EC_INT");
+                    waits[k] = UpdateSession::Wait::FAILED;
+                    progressed = true;
+                }
+                break;
+
+            case UpdateSession::Wait::TIME:
+                active = true;
+                if (now_ns() >= session.wake_ns()) {
+                    waits[k] = session.step();
+                    progressed = true;
+                }
+                break;
+
+            default:
+                break;
+            }
+
+            if (((waits[k] == UpdateSession::Wait::DONE) || (waits[k] == UpdateSession::Wait::FAILED)) &&
+                (results_[members[k]].ns == 0)) {
+                StationResult &result = results_[members[k]];
+                result.ok = (waits[k] == UpdateSession::Wait::DONE);
+                result.error = session.error();
+                result.ns = std::max<uint64_t>(now_ns() - starts[k], 1);
+                result.phases = session.phases();
+                result.deviceMode = session.device_mode();
+            }
+        }
+
+        if (!active) {
+            break;
+        }
+        if (!progressed) {
+            wait_any(members, waits, sessions);
+        }
+    }
+}
+
+/* Block until one of the devices can make progress. */
+void BusPipeline::wait_any(const std::vector<size_t> &members, const std::vector<UpdateSession::Wait> &waits,
+                           const std::vector<UpdateSession *> &sessions)
+{
+    uint64_t next = std::numeric_limits<uint64_t>::max();
+
+    if (clock_ != nullptr) {
+        /* Device models: move the bus clock to the next response or wake-up time. */
+        for (size_t k = 0; k < members.size(); k++) {
+            if (waits[k] == UpdateSession::Wait::INTERRUPT) {
+                const uint64_t busy = devices_[members[k]].model->busy_until_ns();
+                next = std::min(next, (busy > clock_->ns) ? busy : sessions[k]->wake_ns());
+            } else if (waits[k] == UpdateSession::Wait::TIME) {
+                next = std::min(next, sessions[k]->wake_ns());
+            }
+        }
+        if (next != std::numeric_limits<uint64_t>::max()) {
+            clock_->ns = std::max(clock_->ns, next);
+        }
+        return;
+    }
+
+    std::vector<struct pollfd> fds;
+    bool polled = false;
+    for (size_t k = 0; k < members.size(); k++) {
+        if ((waits[k] == UpdateSession::Wait::INTERRUPT) || (waits[k] == UpdateSession::Wait::TIME)) {
+            next = std::min(next, sessions[k]->wake_ns());
+        }
+        if (waits[k] == UpdateSession::Wait::INTERRUPT) {
+            const int fd = devices_[members[k]].transport->interrupt_fd();
+            if (fd >= 0) {
+                fds.push_back({fd, POLLIN, 0});
+            } else {
+                polled = true;
+            }
+        }
+    }
+
+    const uint64_t now = now_ns();
+    int timeoutMs = (next > now) ? static_cast<int>(std::min<uint64_t>((next - now + 999999u) / 1000000u, 1000u)) : 0;
+    if (polled) {
+        timeoutMs = std::min(timeoutMs, kPollIntervalMs);
+    }
+    ::poll(fds.data(), fds.size(), timeoutMs);
+}
+
+} // namespace pmg1
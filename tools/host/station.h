@@ -0,0 +1,99 @@
+/******************************************************************************
+* File Name: station.h
+*
+* Description: Update pipeline for all devices on one bus. A single thread
+*              drives one update session per device and interleaves their
+*              commands, so that the time one device spends programming a
+*              row is used to transfer to another.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_STATION_H
+#define PMG1_HOST_STATION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sim_device.h"
+#include "sim_transport.h"
+#include "updater.h"
+
+namespace pmg1 {
+
+struct StationDevice {
+    std::string label;
+    Transport *transport;
+    SimDevice *model;                   /* Device model behind the transport, null on hardware. */
+};
+
+struct StationResult {
+    std::string label;
+    bool ok = false;
+    std::string error;
+    uint64_t ns = 0;                    /* From the first command to the end of the session. */
+    std::vector<PhaseStats> phases;
+    uint8_t deviceMode = 0;
+};
+
+class BusPipeline {
+public:
+    /* clock: shared clock of the device models, null on hardware. */
+    BusPipeline(const std::vector<StationDevice> &devices, const UpdateImage &image,
+                const UpdateOptions &options, SimClock *clock, bool interleave);
+
+    void run();
+
+    const std::vector<StationResult> &results() const { return results_; }
+    uint64_t elapsed_ns() const { return elapsedNs_; }
+
+private:
+    void run_group(const std::vector<size_t> &members);
+    void wait_any(const std::vector<size_t> &members, const std::vector<UpdateSession::Wait> &waits,
+                  const std::vector<UpdateSession *> &sessions);
+    uint64_t now_ns();
+
+    std::vector<StationDevice> devices_;
+    const UpdateImage &image_;
+    UpdateOptions options_;
+    SimClock *clock_;
+    bool interleave_;
+    std::vector<StationResult> results_;
+    uint64_t elapsedNs_ = 0;
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_STATION_H */
@@ -0,0 +1,247 @@
+/******************************************************************************
+* File Name: station_main.cpp
+*
+* Description: pmg1-station. Updates many devices in parallel: one thread per
+*              I2C bus, with the devices on a bus (up to three, at the FLOAT,
+*              LOW and HIGH HPI addresses) interleaved by a single pipeline.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "i2c_transport.h"
+#include "station.h"
+#include "stream.h"
+
+using namespace pmg1;
+
+namespace {
+
+/* Address selections of get_hpi_slave_addr(), in glHpiHwConfig order. */
+const char *const kAddrNames[] = {"FLOAT", "LOW", "HIGH"};
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: pmg1-station --image FILE.p1rw [--no-verify] [--no-jump] [--no-interleave]\n"
+        "                    DEVICES\n"
+        "devices:\n"
+        "  --device /dev/i2c-N:ADDR[:/dev/gpiochipN:LINE]   (repeat, one per device)\n"
+        "  --sim TARGET --buses N [--per-bus 1..3] [--app-running]\n"
+        "targets: %s\n", target_names().c_str());
+}
+
+struct Bus {
+    std::string name;
+    std::unique_ptr<SimClock> clock;
+    std::vector<std::unique_ptr<SimDevice>> models;
+    std::vector<std::unique_ptr<Transport>> transports;
+    std::vector<StationDevice> devices;
+    std::unique_ptr<BusPipeline> pipeline;
+};
+
+/* Program the image straight into a device model, as done by the factory programmer. */
+void preload(SimDevice &model, const UpdateImage &image)
+{
+    for (const ImageRow &row : image.rows) {
+        std::copy(row.data.begin(), row.data.end(), model.flash().begin() + row.row * image.rowSize);
+    }
+    std::copy(image.metadataRow.data.begin(), image.metadataRow.data.end(),
+              model.flash().begin() + image.metadataRow.row * image.rowSize);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string streamPath;
+    std::string simTarget;
+    std::vector<std::string> deviceSpecs;
+    unsigned buses = 0;
+    unsigned perBus = 3;
+    bool interleave = true;
+    bool appRunning = false;
+    UpdateOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasArg = (i + 1) < argc;
+
+        if ((arg == "--image") && hasArg) {
+            streamPath = argv[++i];
+        } else if ((arg == "--device") && hasArg) {
+            deviceSpecs.push_back(argv[++i]);
+        } else if ((arg == "--sim") && hasArg) {
+            simTarget = argv[++i];
+        } else if ((arg == "--buses") && hasArg) {
+            buses = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((arg == "--per-bus") && hasArg) {
+            perBus = std::strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--app-running") {
+            appRunning = true;
+        } else if (arg == "--no-interleave") {
+            interleave = false;
+        } else if (arg == "--no-verify") {
+            options.verify = false;
+        } else if (arg == "--no-jump") {
+            options.jump = false;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    const TargetInfo *target = simTarget.empty() ? nullptr : find_target(simTarget);
+    const bool sim = (target != nullptr);
+    if (streamPath.empty() || (sim == !deviceSpecs.empty()) || (!simTarget.empty() && !sim) ||
+        (sim && ((buses == 0) || (perBus < 1) || (perBus > 3)))) {
+        usage();
+        return 2;
+    }
+
+    std::string error;
+    UpdateImage image;
+    if (!read_stream(streamPath, &image, &error)) {
+        std::fprintf(stderr, "pmg1-station: %s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Bus>> busList;
+    if (sim) {
+        for (unsigned b = 0; b < buses; b++) {
+            std::unique_ptr<Bus> bus(new Bus);
+            bus->name = "bus" + std::to_string(b);
+            bus->clock.reset(new SimClock);
+            for (unsigned d = 0; d < perBus; d++) {
+                SimDevice *model = new SimDevice(*target);
+                bus->models.emplace_back(model);
+                if (appRunning) {
+                    preload(*model, image);
+                }
+                model->power_on();
+                model->advance_to(bus->clock->ns);
+                bus->transports.emplace_back(new SimTransport(*model, false, bus->clock.get()));
+                bus->devices.push_back({bus->name + "/" + kAddrNames[d], bus->transports.back().get(), model});
+            }
+            busList.push_back(std::move(bus));
+        }
+        /* Let the models come out of reset and through their boot-wait window. */
+        for (auto &bus : busList) {
+            bus->clock->ns = 100000000u;
+        }
+    } else {
+        std::map<std::string, Bus *> byName;
+        for (const std::string &spec : deviceSpecs) {
+            const size_t c1 = spec.find(':');
+            const size_t c2 = (c1 == std::string::npos) ? std::string::npos : spec.find(':', c1 + 1);
+            const std::string busName = spec.substr(0, c1);
+            const std::string addr = (c1 == std::string::npos) ? "" : spec.substr(c1 + 1, c2 - c1 - 1);
+            std::string chip;
+            int line = -1;
+
+            if (c2 != std::string::npos) {
+                const size_t c3 = spec.rfind(':');
+                chip = spec.substr(c2 + 1, c3 - c2 - 1);
+                line = (c3 > c2) ? std::atoi(spec.c_str() + c3 + 1) : -1;
+            }
+            if (addr.empty() || ((c2 != std::string::npos) && (line < 0))) {
+                usage();
+                return 2;
+            }
+
+            Bus *&bus = byName[busName];
+            if (bus == nullptr) {
+                busList.emplace_back(new Bus);
+                bus = busList.back().get();
+                bus->name = busName;
+            }
+
+            I2cTransport *i2c = new I2cTransport(busName, static_cast<uint8_t>(std::strtoul(addr.c_str(), nullptr, 0)),
+                                                 chip, line);
+            bus->transports.emplace_back(i2c);
+            if (!i2c->open()) {
+                std::fprintf(stderr, "pmg1-station: %s\n", i2c->last_error().c_str());
+                return 1;
+            }
+            bus->devices.push_back({i2c->name(), i2c, nullptr});
+        }
+    }
+
+    /* One pipeline thread per bus. */
+    std::vector<std::thread> threads;
+    const auto wallStart = std::chrono::steady_clock::now();
+    for (auto &bus : busList) {
+        bus->pipeline.reset(new BusPipeline(bus->devices, image, options, bus->clock.get(), interleave));
+        threads.emplace_back([&bus]() { bus->pipeline->run(); });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    const double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    unsigned ok = 0;
+    unsigned total = 0;
+    uint64_t stationNs = 0;
+    for (auto &bus : busList) {
+        for (const StationResult &result : bus->pipeline->results()) {
+            total++;
+            ok += result.ok ? 1 : 0;
+            if (!result.ok || (busList.size() * bus->devices.size() <= 12)) {
+                std::printf("%-24s %-6s %9.1f ms  %s\n", result.label.c_str(), result.ok ? "ok" : "FAILED",
+                            result.ns / 1e6, result.ok ? "" : result.error.c_str());
+            }
+        }
+        stationNs = std::max(stationNs, bus->pipeline->elapsed_ns());
+    }
+
+    const double stationS = stationNs / 1e9;
+    const double bytes = static_cast<double>(image.rows.size() + 1) * image.rowSize * ok;
+    std::printf("%u/%u devices updated on %zu buses (%s)\n", ok, total, busList.size(),
+                interleave ? "interleaved" : "one device at a time");
+    std::printf("station time %.2f s%s, %.0f devices/hour, %.1f KB/s aggregate\n", stationS,
+                sim ? " (virtual)" : "", (stationS > 0) ? ok * 3600.0 / stationS : 0.0,
+                (stationS > 0) ? bytes / 1024.0 / stationS : 0.0);
+    if (sim) {
+        std::printf("host time %.2f s\n", wallS);
+    }
+    return (ok == total) ? 0 : 1;
+}
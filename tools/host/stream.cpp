@@ -0,0 +1,153 @@
+/******************************************************************************
+* File Name: stream.cpp
+*
+* Description: Row stream file written by pmg1-pack and sent by pmg1-update.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "stream.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include "crc32c.h"
+
+namespace pmg1 {
+
+namespace {
+
+void append_record(std::vector<uint8_t> *out, const ImageRow &row)
+{
+    uint8_t hdr[kStreamRecordHeaderSize] = {0};
+
+    put_le16(hdr, row.row);
+    out->insert(out->end(), hdr, hdr + sizeof(hdr));
+    out->insert(out->end(), row.data.begin(), row.data.end());
+}
+
+} // namespace
+
+bool write_stream(const std::string &path, const UpdateImage &image, std::string *error)
+{
+    const Metadata md = image.metadata();
+    std::vector<uint8_t> out(kStreamHeaderSize, 0);
+
+    std::memcpy(&out[0x00], kStreamMagic, sizeof(kStreamMagic));
+    put_le16(&out[0x04], kStreamVersion);
+    put_le16(&out[0x06], static_cast<uint16_t>(kStreamHeaderSize));
+    put_le16(&out[0x08], image.rowSize);
+    put_le16(&out[0x0A], static_cast<uint16_t>(image.rows.size() + 1));
+    out[0x0C] = image.slot;
+    put_le16(&out[0x0E], image.metadataRow.row);
+    put_le32(&out[0x10], md.appFwStart);
+    put_le32(&out[0x14], md.appFwSize);
+    put_le32(&out[0x18], md.fwCrc32);
+
+    out.reserve(kStreamHeaderSize + (image.rows.size() + 1) * (kStreamRecordHeaderSize + image.rowSize));
+    for (const ImageRow &row : image.rows) {
+        append_record(&out, row);
+    }
+    append_record(&out, image.metadataRow);
+
+    uint32_t crc = crc32c_update(0xFFFFFFFFu, out.data(), 0x1C);
+    crc = ~crc32c_update(crc, &out[kStreamHeaderSize], out.size() - kStreamHeaderSize);
+    put_le32(&out[0x1C], crc);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(reinterpret_cast<const char *>(out.data()), out.size()) || !file.flush()) {
+        *error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool read_stream(const std::string &path, UpdateImage *image, std::string *error)
+{
+    std::vector<uint8_t> in;
+
+    if (!read_file(path, &in, error)) {
+        return false;
+    }
+    if ((in.size() < kStreamHeaderSize) || (std::memcmp(in.data(), kStreamMagic, sizeof(kStreamMagic)) != 0)) {
+        *error = path + ": not a row stream file";
+        return false;
+    }
+    if (get_le16(&in[0x04]) != kStreamVersion) {
+        *error = path + ": unsupported stream version " + std::to_string(get_le16(&in[0x04]));
+        return false;
+    }
+
+    const size_t hdrSize = get_le16(&in[0x06]);
+    const uint16_t rowSize = get_le16(&in[0x08]);
+    const size_t count = get_le16(&in[0x0A]);
+    const size_t recSize = kStreamRecordHeaderSize + rowSize;
+
+    if ((hdrSize < kStreamHeaderSize) || (rowSize < kMetadataSize) || (count == 0) ||
+        (in.size() != hdrSize + count * recSize)) {
+        *error = path + ": bad stream size";
+        return false;
+    }
+
+    uint32_t crc = crc32c_update(0xFFFFFFFFu, in.data(), 0x1C);
+    crc = ~crc32c_update(crc, &in[hdrSize], in.size() - hdrSize);
+    if (crc != get_le32(&in[0x1C])) {
+        *error = path + ": stream CRC mismatch";
+        return false;
+    }
+
+    image->rowSize = rowSize;
+    image->slot = in[0x0C];
+    image->rows.clear();
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *rec = &in[hdrSize + i * recSize];
+        ImageRow row;
+        row.row = get_le16(rec);
+        row.data.assign(rec + kStreamRecordHeaderSize, rec + recSize);
+        if (i + 1 < count) {
+            image->rows.push_back(std::move(row));
+        } else {
+            image->metadataRow = std::move(row);
+        }
+    }
+
+    if (image->metadataRow.row != get_le16(&in[0x0E])) {
+        *error = path + ": last record is not the metadata row";
+        return false;
+    }
+    return true;
+}
+
+} // namespace pmg1
@@ -0,0 +1,81 @@
+/******************************************************************************
+* File Name: stream.h
+*
+* Description: Row stream file written by pmg1-pack and sent by pmg1-update.
+*
+*              All fields are little endian.
+*
+*              Header (32 bytes):
+*                0x00  magic "P1RW"
+*                0x04  u16 format version (1)
+*                0x06  u16 header size
+*                0x08  u16 flash row size
+*                0x0A  u16 number of row records, metadata row included
+*                0x0C  u8  firmware slot
+*                0x0D  u8  reserved
+*                0x0E  u16 metadata row number
+*                0x10  u32 appFwStart
+*                0x14  u32 appFwSize
+*                0x18  u32 fwCrc32
+*                0x1C  u32 CRC-32C of the header bytes 0x00-0x1B and all records
+*
+*              Row record (4 + row size bytes), in programming order with the
+*              metadata row last:
+*                0x00  u16 row number
+*                0x02  u16 reserved
+*                0x04  row data
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_STREAM_H
+#define PMG1_HOST_STREAM_H
+
+#include <string>
+
+#include "image.h"
+
+namespace pmg1 {
+
+constexpr char kStreamMagic[4] = {'P', '1', 'R', 'W'};
+constexpr uint16_t kStreamVersion = 1;
+constexpr size_t kStreamHeaderSize = 32;
+constexpr size_t kStreamRecordHeaderSize = 4;
+
+bool write_stream(const std::string &path, const UpdateImage &image, std::string *error);
+bool read_stream(const std::string &path, UpdateImage *image, std::string *error);
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_STREAM_H */
@@ -0,0 +1,91 @@
+/******************************************************************************
+* File Name: target.cpp
+*
+* Description: Flash and RAM geometry of the PMG1 targets supported by the
+*              bootloader, as used by the host tools.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "target.h"
+
+namespace pmg1 {
+
+namespace {
+
+/* Values match the linker templates. The boot-loader last row is the one of a 7 KB
+   image; a device reports the row its linked image ends in. */
+const TargetInfo kTargets[] = {
+    {"PMG1-CY7110",          "S0", 0x10000, 128, 0x2000, 0x400, 0x37},
+    {"EVAL_PMG1_S1_DRP",     "S1", 0x20000, 256, 0x3000, 0x400, 0x1B},
+    {"PMG1-CY7112",          "S2", 0x20000, 128, 0x2000, 0x400, 0x37},
+    {"PMG1-CY7113",          "S3", 0x40000, 256, 0x8000, 0x400, 0x1B},
+    {"EVAL_PMG1_S3_DUALDRP", "S3", 0x40000, 256, 0x8000, 0x400, 0x1B},
+};
+
+} // namespace
+
+uint16_t TargetInfo::row_shift() const
+{
+    uint16_t shift = 0;
+    while ((1u << shift) < rowSize) {
+        shift++;
+    }
+    return shift;
+}
+
+const TargetInfo *find_target(const std::string &name)
+{
+    for (const TargetInfo &target : kTargets) {
+        if ((name == target.name) || (name == target.series) ||
+            (std::string("PMG1-") + name == target.name)) {
+            return &target;
+        }
+    }
+    return nullptr;
+}
+
+std::string target_names()
+{
+    std::string names;
+    for (const TargetInfo &target : kTargets) {
+        if (!names.empty()) {
+            names += ", ";
+        }
+        names += target.name;
+    }
+    return names;
+}
+
+} // namespace pmg1
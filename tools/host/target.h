@@ -0,0 +1,71 @@
+/******************************************************************************
+* File Name: target.h
+*
+* Description: Flash and RAM geometry of the PMG1 targets supported by the
+*              bootloader, as used by the host tools.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_TARGET_H
+#define PMG1_HOST_TARGET_H
+
+#include <cstdint>
+#include <string>
+
+namespace pmg1 {
+
+struct TargetInfo {
+    const char *name;           /* BSP name, e.g. PMG1-CY7110. */
+    const char *series;         /* Device series, e.g. S0. */
+    uint32_t flashSize;         /* Bytes. */
+    uint16_t rowSize;           /* Bytes. */
+    uint32_t ramSize;           /* Bytes. */
+    uint32_t stackSize;         /* __STACK_SIZE of the linker templates. */
+    uint16_t blLastRow;         /* Boot-loader last row of the model: a 7 KB boot-loader. */
+
+    uint16_t row_count() const { return static_cast<uint16_t>(flashSize / rowSize); }
+    uint16_t last_row() const { return static_cast<uint16_t>(row_count() - 1); }
+    uint16_t row_shift() const;
+};
+
+/* Look up a target by BSP name or series (S0..S3). Returns nullptr if unknown. */
+const TargetInfo *find_target(const std::string &name);
+
+/* Comma separated list of the known target names. */
+std::string target_names();
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_TARGET_H */
@@ -0,0 +1,106 @@
+/******************************************************************************
+* File Name: transport.h
+*
+* Description: Access to the HPI register space of one device. Implemented
+*              over Linux i2c-dev and over the device model.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_TRANSPORT_H
+#define PMG1_HOST_TRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pmg1 {
+
+/* One register access. A batch of accesses is sent as a single bus
+ * transaction (repeated starts) where the transport allows it.
+ */
+struct BusOp {
+    enum Kind { WRITE, READ };
+
+    Kind kind;
+    uint16_t reg;
+    uint8_t *data;
+    size_t len;
+};
+
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    /* Perform the register accesses in order. */
+    virtual bool transfer(const BusOp *ops, size_t count) = 0;
+
+    /* Wait until EC_INT is asserted. Returns false on timeout. */
+    virtual bool wait_interrupt(uint32_t timeoutMs) = 0;
+
+    /* Check EC_INT without blocking. */
+    virtual bool interrupt_asserted(bool *asserted) = 0;
+
+    /* Descriptor that becomes readable on an EC_INT edge, -1 if there is none. */
+    virtual int interrupt_fd() const { return -1; }
+
+    /* Monotonic clock used for throughput reporting. The device model
+       uses its virtual clock. */
+    virtual uint64_t now_ns() = 0;
+
+    /* Let time pass, e.g. while the device resets. */
+    virtual void sleep_ms(uint32_t ms) = 0;
+
+    virtual std::string name() const = 0;
+    const std::string &last_error() const { return error_; }
+
+    bool write(uint16_t reg, const uint8_t *data, size_t len)
+    {
+        const BusOp op = {BusOp::WRITE, reg, const_cast<uint8_t *>(data), len};
+        return transfer(&op, 1);
+    }
+
+    bool read(uint16_t reg, uint8_t *data, size_t len)
+    {
+        const BusOp op = {BusOp::READ, reg, data, len};
+        return transfer(&op, 1);
+    }
+
+protected:
+    std::string error_;
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_TRANSPORT_H */
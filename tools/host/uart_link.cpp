@@ -0,0 +1,289 @@
+/******************************************************************************
+* File Name: uart_link.cpp
+*
+* Description: Loopback UART between the host tools and the device model,
+*              served by the bootloader's framed command layer.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "uart_link.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "hpi_proto.h"
+
+extern "C" {
+#include "bl_cmd.h"
+#include "status.h"
+}
+
+namespace pmg1 {
+
+namespace {
+
+/* Start bit, 8 data bits, stop bit. */
+constexpr uint64_t kBitsPerByte = 10;
+
+int8_t to_status(uint8_t resp)
+{
+    switch (resp) {
+    case hpi::RESP_SUCCESS:
+    case hpi::RESP_FLASH_DATA_AVAIL:
+        return PMG1_STAT_SUCCESS;
+    case hpi::RESP_INVALID_ARGUMENT:
+        return PMG1_STAT_BAD_PARAM;
+    case hpi::RESP_FLASH_UPDATE_FAILED:
+        return PMG1_STAT_NOT_READY;
+    default:
+        return PMG1_STAT_FAILURE;
+    }
+}
+
+} // namespace
+
+/* Transport and command callbacks of the device end. bl_cmd.c calls them without a
+ * context, so they work on the one active link. */
+struct UartDeviceEnd {
+    static SimUartLink *link;
+
+    static uint8_t *receive(uint16_t *lengthP)
+    {
+        if (!link->ready_) {
+            return nullptr;
+        }
+        *lengthP = static_cast<uint16_t>(link->frame_.size());
+        return link->frame_.data();
+    }
+
+    static void release()
+    {
+        link->frame_.clear();
+        link->expected_ = 0;
+        link->ready_ = false;
+    }
+
+    static void send(const uint8_t *data, uint16_t length)
+    {
+        link->queue_to_host(data, length);
+    }
+
+    static void flush()
+    {
+    }
+
+    static void get_info(bl_cmd_info_t *infoP)
+    {
+        const SimDevice &dev = link->device_;
+
+        infoP->deviceMode = dev.device_mode();
+        infoP->bootReason = dev.boot_reason();
+        infoP->blLastRow = dev.target().blLastRow;
+        infoP->rowSize = dev.target().rowSize;
+        infoP->readMax = hpi::FLASH_SPAN_MAX;
+    }
+
+    static void enter_flash_mode(bool enable)
+    {
+        (void)link->device_.set_flash_mode(enable);
+    }
+
+    static int8_t row_write(uint16_t rowNum, uint8_t *data)
+    {
+        return to_status(link->device_.program_row(rowNum, data, &link->costNs_));
+    }
+
+    static int8_t read(uint32_t addr, uint16_t length, const uint8_t **dataP)
+    {
+        return to_status(link->device_.read_flash(addr, length, dataP));
+    }
+
+    static int8_t validate_fw(uint8_t slot)
+    {
+        return to_status(link->device_.validate_slot(slot, &link->costNs_));
+    }
+
+    /* NVIC_SystemReset() once the response is on the line. */
+    static void reset()
+    {
+        link->resetPending_ = true;
+        link->resetAtNs_ = link->devTxFreeNs_;
+    }
+};
+
+SimUartLink *UartDeviceEnd::link = nullptr;
+
+namespace {
+
+const bl_transport_t kUartTransport = {
+    UartDeviceEnd::receive,
+    UartDeviceEnd::release,
+    UartDeviceEnd::send,
+    UartDeviceEnd::flush,
+};
+
+const bl_cmd_cbk_t kUartCmdCbk = {
+    UartDeviceEnd::get_info,
+    UartDeviceEnd::enter_flash_mode,
+    UartDeviceEnd::row_write,
+    UartDeviceEnd::read,
+    UartDeviceEnd::validate_fw,
+    UartDeviceEnd::reset,
+};
+
+} // namespace
+
+SimUartLink::SimUartLink(SimDevice &device, uint32_t baud)
+    : device_(device),
+      baud_(baud),
+      byteNs_((kBitsPerByte * 1000000000ull + baud - 1) / baud)
+{
+    UartDeviceEnd::link = this;
+    bl_cmd_init(&kUartCmdCbk, device_.target().rowSize);
+}
+
+SimUartLink::~SimUartLink()
+{
+    bl_cmd_init(nullptr, 0);
+    UartDeviceEnd::link = nullptr;
+}
+
+/* Move the device clock, resetting the device once a RESET response has been sent. */
+void SimUartLink::advance(uint64_t ns)
+{
+    if (resetPending_ && (ns >= resetAtNs_)) {
+        resetPending_ = false;
+        device_.advance_to(resetAtNs_);
+        device_.soft_reset(0);
+    }
+    device_.advance_to(ns);
+}
+
+/* Same frame collection as bl_uart_rx_byte(). */
+void SimUartLink::rx_byte(uint8_t byte)
+{
+    if (ready_ || (frame_.empty() && (byte != BL_FRAME_SOF))) {
+        return;
+    }
+
+    frame_.push_back(byte);
+    if (frame_.size() == BL_FRAME_HDR_SIZE) {
+        const uint16_t length = get_le16(&frame_[2]);
+        if (length > BL_CMD_MAX_PAYLOAD(device_.target().rowSize)) {
+            frame_.clear();
+            return;
+        }
+        expected_ = BL_FRAME_HDR_SIZE + length + BL_FRAME_CRC_SIZE;
+    }
+
+    if ((frame_.size() > BL_FRAME_HDR_SIZE) && (frame_.size() == expected_)) {
+        ready_ = true;
+    }
+}
+
+/* Response bytes leave once the command has been processed, back to back. */
+void SimUartLink::queue_to_host(const uint8_t *data, size_t len)
+{
+    uint64_t ns = std::max(devTxFreeNs_, device_.now_ns() + costNs_);
+
+    for (size_t i = 0; i < len; i++) {
+        ns += byteNs_;
+        toHost_.push_back({ns, data[i]});
+    }
+    devTxFreeNs_ = ns;
+    lineBytes_ += len;
+}
+
+bool SimUartLink::send(const uint8_t *data, size_t len)
+{
+    uint64_t ns = std::max(device_.now_ns(), hostTxFreeNs_);
+
+    for (size_t i = 0; i < len; i++) {
+        ns += byteNs_;
+        advance(ns);
+
+        /* The receiver comes up with HPI, and only the bootloader runs it. A reset
+           loses the frame collected so far. */
+        if (device_.last_reset_ns() != resetNs_) {
+            resetNs_ = device_.last_reset_ns();
+            UartDeviceEnd::release();
+        }
+        if (!device_.in_bootloader() || (device_.now_ns() < device_.reset_complete_ns())) {
+            continue;
+        }
+
+        rx_byte(data[i]);
+        if (ready_) {
+            costNs_ = device_.timing().cmdNs;
+            (void)bl_cmd_task(&kUartTransport);
+            costNs_ = 0;
+        }
+    }
+    hostTxFreeNs_ = ns;
+    lineBytes_ += len;
+    return true;
+}
+
+bool SimUartLink::receive(uint8_t *data, size_t len, uint32_t timeoutMs)
+{
+    const uint64_t deadline = device_.now_ns() + static_cast<uint64_t>(timeoutMs) * 1000000u;
+
+    if ((toHost_.size() < len) || ((len != 0) && (toHost_[len - 1].ns > deadline))) {
+        advance(deadline);
+        error_ = "timeout waiting for a response frame";
+        return false;
+    }
+
+    if (len != 0) {
+        advance(toHost_[len - 1].ns);
+    }
+    for (size_t i = 0; i < len; i++) {
+        data[i] = toHost_.front().value;
+        toHost_.pop_front();
+    }
+    return true;
+}
+
+void SimUartLink::sleep_ms(uint32_t ms)
+{
+    advance(device_.now_ns() + static_cast<uint64_t>(ms) * 1000000u);
+}
+
+std::string SimUartLink::name() const
+{
+    return std::string("sim-uart:") + device_.target().name + "@" + std::to_string(baud_);
+}
+
+} // namespace pmg1
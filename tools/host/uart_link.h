@@ -0,0 +1,138 @@
+/******************************************************************************
+* File Name: uart_link.h
+*
+* Description: Byte stream links to the framed command layer of the
+*              bootloader (bl_cmd.h), and the loopback link that connects it
+*              to the device model over a modeled UART line.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_UART_LINK_H
+#define PMG1_HOST_UART_LINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "sim_device.h"
+
+namespace pmg1 {
+
+/* A byte stream carrying bl_cmd.h frames in both directions. */
+class ByteLink {
+public:
+    virtual ~ByteLink() = default;
+
+    /* Put bytes on the line. */
+    virtual bool send(const uint8_t *data, size_t len) = 0;
+
+    /* Receive exactly len bytes. Returns false on timeout. */
+    virtual bool receive(uint8_t *data, size_t len, uint32_t timeoutMs) = 0;
+
+    /* Drop received bytes that have not been read, e.g. after a timeout. */
+    virtual void discard() = 0;
+
+    /* Monotonic clock used for throughput reporting. The device model
+       uses its virtual clock. */
+    virtual uint64_t now_ns() = 0;
+
+    /* Let time pass, e.g. while the device resets. */
+    virtual void sleep_ms(uint32_t ms) = 0;
+
+    virtual std::string name() const = 0;
+    const std::string &last_error() const { return error_; }
+
+protected:
+    std::string error_;
+};
+
+/* Loopback UART to the device model. The device end collects frames as bl_uart.c
+ * does and serves them with the bootloader's own bl_cmd.c, mapped to the SimDevice
+ * flashing operations. A byte takes 10 bit times on the line in each direction.
+ * Only one link can exist at a time, as bl_cmd.c keeps its callbacks in a global.
+ */
+class SimUartLink : public ByteLink {
+public:
+    SimUartLink(SimDevice &device, uint32_t baud);
+    ~SimUartLink() override;
+
+    bool send(const uint8_t *data, size_t len) override;
+    bool receive(uint8_t *data, size_t len, uint32_t timeoutMs) override;
+    void discard() override { toHost_.clear(); }
+    uint64_t now_ns() override { return device_.now_ns(); }
+    void sleep_ms(uint32_t ms) override;
+    std::string name() const override;
+
+    uint32_t baud() const { return baud_; }
+
+    /* Number of bytes moved over the line, for throughput reporting. */
+    uint64_t line_bytes() const { return lineBytes_; }
+
+private:
+    friend struct UartDeviceEnd;
+
+    struct LineByte {
+        uint64_t ns;                    /* Time the stop bit has been received. */
+        uint8_t value;
+    };
+
+    void advance(uint64_t ns);
+    void rx_byte(uint8_t byte);
+    void queue_to_host(const uint8_t *data, size_t len);
+
+    SimDevice &device_;
+    uint32_t baud_;
+    uint64_t byteNs_;
+    uint64_t lineBytes_ = 0;
+    uint64_t hostTxFreeNs_ = 0;
+    uint64_t devTxFreeNs_ = 0;
+
+    /* Device end: frame buffer of bl_uart.c, and the time spent on the command served. */
+    std::vector<uint8_t> frame_;
+    size_t expected_ = 0;
+    bool ready_ = false;
+    uint64_t resetNs_ = 0;
+    uint64_t costNs_ = 0;
+    bool resetPending_ = false;
+    uint64_t resetAtNs_ = 0;
+
+    std::deque<LineByte> toHost_;
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_UART_LINK_H */
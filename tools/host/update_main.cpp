@@ -0,0 +1,205 @@
+/******************************************************************************
+* File Name: update_main.cpp
+*
+* Description: pmg1-update. Flashes a firmware slot over HPI, either on an
+*              I2C bus or on the device model.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "i2c_transport.h"
+#include "image.h"
+#include "sim_device.h"
+#include "sim_transport.h"
+#include "stream.h"
+#include "updater.h"
+
+using namespace pmg1;
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+        "usage: pmg1-update TRANSPORT IMAGE [--no-verify] [--no-jump] [--chunk BYTES]\n"
+        "transport:\n"
+        "  --bus /dev/i2c-N --addr ADDR [--ec-int /dev/gpiochipN:LINE]\n"
+        "  --sim [--sim-slots N]\n"
+        "image:\n"
+        "  --image FILE.p1rw (from pmg1-pack)\n"
+        "  --bin FILE --slot N --row FIRST_ROW [--wait MS]\n"
+        "--target NAME is needed with --bin and --sim\n"
+        "targets: %s\n", target_names().c_str());
+}
+
+void print_phases(const Updater &updater)
+{
+    uint64_t totalNs = 0;
+
+    std::printf("%-10s %10s %10s %10s %8s %10s\n", "phase", "ms", "bytes", "KB/s", "cmds", "ms/cmd");
+    for (const PhaseStats &phase : updater.phases()) {
+        const double ms = phase.ns / 1e6;
+        const double rate = (phase.ns != 0) ? (phase.bytes / 1024.0) / (phase.ns / 1e9) : 0.0;
+        const double perCmd = (phase.commands != 0) ? ms / phase.commands : 0.0;
+
+        std::printf("%-10s %10.1f %10llu %10.1f %8u %10.2f\n", phase.name.c_str(), ms,
+                    static_cast<unsigned long long>(phase.bytes), rate, phase.commands, perCmd);
+        totalNs += phase.ns;
+    }
+    std::printf("%-10s %10.1f\n", "total", totalNs / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string bus;
+    std::string ecInt;
+    std::string targetName;
+    std::string binPath;
+    std::string streamPath;
+    unsigned addr = 0;
+    unsigned slot = 0;
+    unsigned firstRow = 0;
+    unsigned wait = kWaitTimeDefault;
+    unsigned simSlots = 2;
+    bool sim = false;
+    UpdateOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasArg = (i + 1) < argc;
+
+        if ((arg == "--bus") && hasArg) {
+            bus = argv[++i];
+        } else if ((arg == "--addr") && hasArg) {
+            addr = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((arg == "--ec-int") && hasArg) {
+            ecInt = argv[++i];
+        } else if (arg == "--sim") {
+            sim = true;
+        } else if ((arg == "--sim-slots") && hasArg) {
+            simSlots = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((arg == "--target") && hasArg) {
+            targetName = argv[++i];
+        } else if ((arg == "--image") && hasArg) {
+            streamPath = argv[++i];
+        } else if ((arg == "--bin") && hasArg) {
+            binPath = argv[++i];
+        } else if ((arg == "--slot") && hasArg) {
+            slot = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((arg == "--row") && hasArg) {
+            firstRow = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((arg == "--wait") && hasArg) {
+            wait = std::strtoul(argv[++i], nullptr, 0);
+            wait = (wait == 0) ? kWaitTimeZero : wait;
+        } else if (arg == "--no-verify") {
+            options.verify = false;
+        } else if (arg == "--no-jump") {
+            options.jump = false;
+        } else if ((arg == "--chunk") && hasArg) {
+            options.chunkSize = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    const TargetInfo *target = find_target(targetName);
+    const bool fromBin = !binPath.empty();
+    if ((fromBin == !streamPath.empty()) || ((fromBin || sim) && (target == nullptr)) ||
+        (fromBin && ((slot < 1) || (slot > 4))) || (sim == !bus.empty()) || (!sim && (addr == 0)) ||
+        (options.chunkSize > HPI_EXT_FLASH_CHUNK_MAX)) {
+        usage();
+        return 2;
+    }
+
+    std::string error;
+    std::vector<uint8_t> binary;
+    UpdateImage image;
+    const bool loaded = fromBin ?
+        (read_file(binPath, &binary, &error) &&
+         make_image_from_binary(*target, static_cast<uint8_t>(slot), static_cast<uint16_t>(firstRow),
+                                binary, static_cast<uint16_t>(wait), &image, &error)) :
+        read_stream(streamPath, &image, &error);
+    if (!loaded) {
+        std::fprintf(stderr, "pmg1-update: %s\n", error.c_str());
+        return 1;
+    }
+
+    std::unique_ptr<SimDevice> device;
+    std::unique_ptr<Transport> transport;
+    if (sim) {
+        device.reset(new SimDevice(*target, static_cast<uint8_t>(simSlots)));
+        device->power_on();
+        transport.reset(new SimTransport(*device));
+    } else {
+        std::string chip;
+        int line = -1;
+        const size_t colon = ecInt.rfind(':');
+        if (colon != std::string::npos) {
+            chip = ecInt.substr(0, colon);
+            line = std::atoi(ecInt.c_str() + colon + 1);
+        }
+
+        I2cTransport *i2c = new I2cTransport(bus, static_cast<uint8_t>(addr), chip, line);
+        transport.reset(i2c);
+        if (!i2c->open()) {
+            std::fprintf(stderr, "pmg1-update: %s\n", i2c->last_error().c_str());
+            return 1;
+        }
+    }
+
+    Updater updater(*transport, options);
+    const bool ok = updater.run(image);
+
+    std::printf("device  %s\n", transport->name().c_str());
+    std::printf("image   FW%u, %zu rows from 0x%04x, metadata row 0x%04x\n", image.slot, image.rows.size(),
+                image.rows.front().row, image.metadataRow.row);
+    print_phases(updater);
+    if (!ok) {
+        std::fprintf(stderr, "pmg1-update: %s\n", updater.error().c_str());
+        return 1;
+    }
+    if (options.jump) {
+        std::printf("running FW%u\n", updater.device_mode() & 0x03);
+    }
+    return 0;
+}
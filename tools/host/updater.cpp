@@ -0,0 +1,532 @@
+/******************************************************************************
+* File Name: updater.cpp
+*
+* Description: HPI flashing sequence of the PMG1 bootloader.
+*
+*              Each row goes out as one combined bus transaction: the row data
+*              into the flash memory window followed by the FLASH_RW command.
+*              Completion is signalled on EC_INT, and the response read and
+*              interrupt clear are again combined into one transaction. The
+*              HPI protocol has a single flash memory window and one command
+*              in flight, so this is the deepest overlap the device allows.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "updater.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "hpi_proto.h"
+
+namespace pmg1 {
+
+namespace {
+
+/* Poll interval for the device mode once the bootloader has been reset. */
+constexpr uint64_t kModePollNs = 5000000;
+
+constexpr uint64_t kMsToNs = 1000000;
+
+uint16_t row_size_from_mode(uint8_t mode)
+{
+    switch ((mode >> 4) & 0x03) {
+    case 0:  return 128;
+    case 1:  return 256;
+    case 3:  return 64;
+    default: return 0;
+    }
+}
+
+std::string hex(unsigned value)
+{
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "0x%x", value);
+    return buf;
+}
+
+} // namespace
+
+UpdateSession::UpdateSession(Transport &transport, const UpdateImage *image, const UpdateOptions &options,
+                             Stage first)
+    : transport_(transport), image_(image), options_(options), stage_(first)
+{
+    if (first == Stage::EXIT_FLASH) {
+        begin_phase("jump");
+    }
+}
+
+size_t UpdateSession::begin_phase(const char *name)
+{
+    phases_.emplace_back();
+    phases_.back().name = name;
+    phases_.back().ns = transport_.now_ns();
+    phase_ = phases_.size() - 1;
+    return phase_;
+}
+
+void UpdateSession::end_phase()
+{
+    phases_[phase_].ns = transport_.now_ns() - phases_[phase_].ns;
+}
+
+void UpdateSession::abort(const std::string &reason)
+{
+    fail(std::string(what_) + ": " + reason);
+}
+
+void UpdateSession::fail(const std::string &error)
+{
+    error_ = error;
+    stage_ = Stage::FAILED;
+}
+
+UpdateSession::Wait UpdateSession::send(const BusOp *ops, size_t count, uint8_t expected, uint32_t timeoutMs,
+                                        const char *what)
+{
+    if (!transport_.transfer(ops, count)) {
+        fail(std::string(what) + ": " + transport_.last_error());
+        return Wait::FAILED;
+    }
+
+    inFlight_ = true;
+    expected_ = expected;
+    what_ = what;
+    wakeNs_ = transport_.now_ns() + timeoutMs * kMsToNs;
+    return Wait::INTERRUPT;
+}
+
+bool UpdateSession::read_mode()
+{
+    uint8_t regs[2] = {0, 0};
+
+    if (!transport_.read(hpi::REG_DEVICE_MODE, regs, sizeof(regs))) {
+        fail("connect: " + transport_.last_error());
+        return false;
+    }
+    deviceMode_ = regs[0];
+    bootReason_ = regs[1];
+    return true;
+}
+
+/* Handle the response of the command in flight. */
+bool UpdateSession::complete()
+{
+    uint8_t resp[2] = {0, 0};
+    uint8_t clear = hpi::INTR_DEV;
+    const BusOp ack[] = {
+        {BusOp::READ, hpi::REG_RESPONSE, resp, sizeof(resp)},
+        {BusOp::WRITE, hpi::REG_INTR, &clear, 1},
+    };
+
+    inFlight_ = false;
+    if (!transport_.transfer(ack, 2)) {
+        fail(std::string(what_) + ": " + transport_.last_error());
+        return false;
+    }
+
+    /* An event queued ahead of the response: the response raises EC_INT again. */
+    if ((resp[0] == HPI_EXT_EVENT_CHECK_DONE) && (expected_ != HPI_EXT_EVENT_CHECK_DONE)) {
+        inFlight_ = true;
+        return true;
+    }
+    if (resp[0] != expected_) {
+        std::string error = std::string(what_) + ": " + hpi::response_name(resp[0]) + " (" + hex(resp[0]) + ")";
+        if ((stage_ == Stage::PROGRAM) || (stage_ == Stage::VERIFY)) {
+            const uint16_t row = (index_ < image_->rows.size()) ? image_->rows[index_].row : image_->metadataRow.row;
+            error += " at row " + hex(row);
+        } else if (stage_ == Stage::METADATA) {
+            error += " at row " + hex(image_->metadataRow.row);
+        }
+        fail(error);
+        return false;
+    }
+
+    switch (stage_) {
+    case Stage::JUMP_TO_BOOT:
+        if (!read_mode()) {
+            return false;
+        }
+        if ((deviceMode_ & hpi::MODE_FW_MASK) != hpi::MODE_BOOTLOADER) {
+            fail("jump to bootloader: device still in FW" + std::to_string(deviceMode_ & hpi::MODE_FW_MASK));
+            return false;
+        }
+        stage_ = Stage::ENTER_FLASH;
+        break;
+
+    case Stage::ENTER_FLASH:
+        phases_[phase_].commands++;
+        end_phase();
+        begin_phase("program");
+        stage_ = Stage::PROGRAM;
+        index_ = 0;
+        break;
+
+    case Stage::PROGRAM:
+        phases_[phase_].commands++;
+        chunkOffset_ = static_cast<uint16_t>(chunkOffset_ + chunkLen_);
+        if (chunkOffset_ < rowSize_) {
+            break;
+        }
+        chunkOffset_ = 0;
+        phases_[phase_].bytes += rowSize_;
+        index_++;
+        break;
+
+    case Stage::METADATA:
+        phases_[phase_].commands++;
+        chunkOffset_ = static_cast<uint16_t>(chunkOffset_ + chunkLen_);
+        if (chunkOffset_ < rowSize_) {
+            break;
+        }
+        chunkOffset_ = 0;
+        phases_[phase_].bytes = rowSize_;
+        end_phase();
+        if (options_.verify) {
+            begin_phase("verify");
+            stage_ = Stage::VERIFY;
+            index_ = 0;
+        } else {
+            stage_ = Stage::VALIDATE;
+        }
+        break;
+
+    case Stage::VERIFY: {
+        const bool isMd = (index_ == image_->rows.size());
+        const ImageRow &row = isMd ? image_->metadataRow : image_->rows[index_];
+
+        rowBuf_.resize(rowSize_);
+        if (!transport_.read(hpi::REG_FLASH_MEM, rowBuf_.data(), rowBuf_.size())) {
+            fail("flash read: " + transport_.last_error());
+            return false;
+        }
+
+        /* The bootloader assigns the boot sequence number: leave it out of the compare. */
+        if (isMd) {
+            const size_t seqOffset = rowSize_ - kMetadataSize + kMdBootSeq;
+            std::memcpy(&rowBuf_[seqOffset], &row.data[seqOffset], 4);
+        }
+        if (rowBuf_ != row.data) {
+            fail(std::string("verify: ") + (isMd ? "metadata " : "") + "mismatch at row " + hex(row.row));
+            return false;
+        }
+
+        phases_[phase_].bytes += rowSize_;
+        phases_[phase_].commands++;
+        index_++;
+        if (index_ > image_->rows.size()) {
+            end_phase();
+            stage_ = Stage::VALIDATE;
+        }
+        break;
+    }
+
+    case Stage::VALIDATE:
+        phases_[phase_].commands = 1;
+        end_phase();
+        if (options_.jump) {
+            begin_phase("jump");
+            stage_ = Stage::EXIT_FLASH;
+        } else {
+            stage_ = Stage::DONE;
+        }
+        break;
+
+    case Stage::EXIT_FLASH:
+        phases_[phase_].commands++;
+        stage_ = Stage::RESET;
+        break;
+
+    case Stage::RESET:
+        phases_[phase_].commands++;
+        stage_ = Stage::AWAIT_APP;
+        deadlineNs_ = transport_.now_ns() + options_.resetTimeoutMs * kMsToNs;
+        break;
+
+    default:
+        break;
+    }
+    return true;
+}
+
+/* Issue the next command, or handle a stage that needs no command. */
+UpdateSession::Wait UpdateSession::issue()
+{
+    for (;;) {
+        switch (stage_) {
+        case Stage::CONNECT: {
+            uint8_t clear = hpi::INTR_DEV;
+
+            begin_phase("connect");
+
+            /* Drop any event left over from before, such as the reset complete event. */
+            if (!transport_.write(hpi::REG_INTR, &clear, 1)) {
+                fail("connect: " + transport_.last_error());
+                return Wait::FAILED;
+            }
+            if (!read_mode()) {
+                return Wait::FAILED;
+            }
+
+            /* An application is running: ask it to return to the bootloader. */
+            if ((deviceMode_ & hpi::MODE_FW_MASK) != hpi::MODE_BOOTLOADER) {
+                stage_ = Stage::JUMP_TO_BOOT;
+            } else {
+                stage_ = Stage::ENTER_FLASH;
+            }
+            break;
+        }
+
+        case Stage::JUMP_TO_BOOT: {
+            cmd_[0] = hpi::SIG_JUMP_TO_BOOT;
+            const BusOp op = {BusOp::WRITE, hpi::REG_JUMP_TO_BOOT, cmd_, 1};
+            return send(&op, 1, hpi::RESP_RESET_COMPLETE, options_.resetTimeoutMs, "jump to bootloader");
+        }
+
+        case Stage::ENTER_FLASH: {
+            rowSize_ = row_size_from_mode(deviceMode_);
+            if (rowSize_ != image_->rowSize) {
+                fail("connect: device row size " + std::to_string(rowSize_) + ", image row size " +
+                     std::to_string(image_->rowSize));
+                return Wait::FAILED;
+            }
+            cmd_[0] = hpi::SIG_FLASH_MODE;
+            const BusOp op = {BusOp::WRITE, hpi::REG_ENTER_FLASH_MODE, cmd_, 1};
+            return send(&op, 1, hpi::RESP_SUCCESS, options_.cmdTimeoutMs, "enter flashing mode");
+        }
+
+        case Stage::PROGRAM:
+        case Stage::METADATA: {
+            if ((stage_ == Stage::PROGRAM) && (index_ == image_->rows.size())) {
+                /* The metadata goes last so that an interrupted update leaves the slot invalid. */
+                end_phase();
+                begin_phase("metadata");
+                stage_ = Stage::METADATA;
+                break;
+            }
+
+            const ImageRow &row = (stage_ == Stage::PROGRAM) ? image_->rows[index_] : image_->metadataRow;
+
+            /* Chunked: the bootloader assembles the row and programs it with the last chunk. */
+            if (options_.chunkSize != 0) {
+                chunkLen_ = static_cast<uint16_t>(std::min<size_t>(options_.chunkSize, rowSize_ - chunkOffset_));
+                rowBuf_.resize(HPI_EXT_FLASH_CHUNK_HDR_SIZE + chunkLen_);
+                rowBuf_[0] = HPI_EXT_FLASH_CHUNK_SIG;
+                rowBuf_[1] = static_cast<uint8_t>(chunkLen_);
+                put_le16(&rowBuf_[2], row.row);
+                put_le16(&rowBuf_[4], chunkOffset_);
+                std::memcpy(&rowBuf_[HPI_EXT_FLASH_CHUNK_HDR_SIZE], &row.data[chunkOffset_], chunkLen_);
+                const BusOp op = {BusOp::WRITE, HPI_EXT_REG_FLASH_CHUNK, rowBuf_.data(), rowBuf_.size()};
+                return send(&op, 1, hpi::RESP_SUCCESS, options_.cmdTimeoutMs, "flash chunk write");
+            }
+
+            chunkLen_ = rowSize_;
+            cmd_[0] = hpi::SIG_FLASH_RW;
+            cmd_[1] = hpi::FLASH_CMD_WRITE;
+            cmd_[2] = static_cast<uint8_t>(row.row);
+            cmd_[3] = static_cast<uint8_t>(row.row >> 8);
+
+            /* Row data and command in one combined transaction. */
+            const BusOp ops[] = {
+                {BusOp::WRITE, hpi::REG_FLASH_MEM, const_cast<uint8_t *>(row.data.data()), row.data.size()},
+                {BusOp::WRITE, hpi::REG_FLASH_RW, cmd_, sizeof(cmd_)},
+            };
+            return send(ops, 2, hpi::RESP_SUCCESS, options_.cmdTimeoutMs, "flash write");
+        }
+
+        case Stage::VERIFY: {
+            const uint16_t row = (index_ < image_->rows.size()) ? image_->rows[index_].row
+                                                                : image_->metadataRow.row;
+            cmd_[0] = hpi::SIG_FLASH_RW;
+            cmd_[1] = hpi::FLASH_CMD_READ;
+            cmd_[2] = static_cast<uint8_t>(row);
+            cmd_[3] = static_cast<uint8_t>(row >> 8);
+            const BusOp op = {BusOp::WRITE, hpi::REG_FLASH_RW, cmd_, sizeof(cmd_)};
+            return send(&op, 1, hpi::RESP_FLASH_DATA_AVAIL, options_.cmdTimeoutMs, "flash read");
+        }
+
+        case Stage::VALIDATE: {
+            begin_phase("validate");
+            cmd_[0] = image_->slot;
+            const BusOp op = {BusOp::WRITE, hpi::REG_VALIDATE_FW, cmd_, 1};
+            return send(&op, 1, hpi::RESP_SUCCESS, options_.cmdTimeoutMs, "validate");
+        }
+
+        case Stage::EXIT_FLASH: {
+            cmd_[0] = 0;
+            const BusOp op = {BusOp::WRITE, hpi::REG_ENTER_FLASH_MODE, cmd_, 1};
+            return send(&op, 1, hpi::RESP_SUCCESS, options_.cmdTimeoutMs, "exit flashing mode");
+        }
+
+        case Stage::RESET: {
+            cmd_[0] = hpi::SIG_RESET;
+            cmd_[1] = hpi::RESET_TYPE_DEVICE;
+            const BusOp op = {BusOp::WRITE, hpi::REG_RESET, cmd_, 2};
+            return send(&op, 1, hpi::RESP_RESET_COMPLETE, options_.resetTimeoutMs, "device reset");
+        }
+
+        case Stage::AWAIT_APP: {
+            /* The bootloader hands over to the new image once its boot-wait window has elapsed. */
+            if (!transport_.read(hpi::REG_DEVICE_MODE, &deviceMode_, 1)) {
+                fail("jump: " + transport_.last_error());
+                return Wait::FAILED;
+            }
+            if ((deviceMode_ & hpi::MODE_FW_MASK) != hpi::MODE_BOOTLOADER) {
+                end_phase();
+                stage_ = Stage::DONE;
+                break;
+            }
+            if (transport_.now_ns() >= deadlineNs_) {
+                fail("jump: device stayed in the bootloader");
+                return Wait::FAILED;
+            }
+            wakeNs_ = std::min(deadlineNs_, transport_.now_ns() + kModePollNs);
+            return Wait::TIME;
+        }
+
+        case Stage::DONE:
+            return Wait::DONE;
+
+        case Stage::FAILED:
+        default:
+            return Wait::FAILED;
+        }
+    }
+}
+
+UpdateSession::Wait UpdateSession::step()
+{
+    if (inFlight_ && !complete()) {
+        return Wait::FAILED;
+    }
+    if (inFlight_) {
+        return Wait::INTERRUPT;
+    }
+    return issue();
+}
+
+Updater::Updater(Transport &transport, const UpdateOptions &options)
+    : transport_(transport), options_(options)
+{
+}
+
+bool Updater::drive(UpdateSession &session)
+{
+    for (;;) {
+        switch (session.step()) {
+        case UpdateSession::Wait::INTERRUPT: {
+            const uint64_t now = transport_.now_ns();
+            const uint64_t left = (session.wake_ns() > now) ? session.wake_ns() - now : 0;
+            if (!transport_.wait_interrupt(static_cast<uint32_t>((left + kMsToNs - 1) / kMsToNs))) {
+                session.abort(transport_.last_error());
+            }
+            break;
+        }
+        case UpdateSession::Wait::TIME: {
+            const uint64_t now = transport_.now_ns();
+            if (session.wake_ns() > now) {
+                transport_.sleep_ms(static_cast<uint32_t>((session.wake_ns() - now + kMsToNs - 1) / kMsToNs));
+            }
+            break;
+        }
+        case UpdateSession::Wait::DONE:
+        case UpdateSession::Wait::FAILED:
+            phases_.insert(phases_.end(), session.phases().begin(), session.phases().end());
+            error_ = session.error();
+            deviceMode_ = session.device_mode();
+            bootReason_ = (session.stage() == UpdateSession::Stage::DONE) ? session.boot_reason() : bootReason_;
+            return session.stage() == UpdateSession::Stage::DONE;
+        }
+    }
+}
+
+bool Updater::run(const UpdateImage &image)
+{
+    UpdateSession session(transport_, &image, options_);
+
+    phases_.clear();
+    return drive(session);
+}
+
+bool Updater::jump()
+{
+    UpdateSession session(transport_, nullptr, options_, UpdateSession::Stage::EXIT_FLASH);
+
+    return drive(session);
+}
+
+bool Updater::read_flash(uint32_t addr, uint32_t length, std::vector<uint8_t> *data)
+{
+    data->clear();
+    readCommands_ = 0;
+
+    while (data->size() < length) {
+        const uint16_t chunk = static_cast<uint16_t>(std::min<size_t>(hpi::FLASH_READ_MAX, length - data->size()));
+        uint8_t cmd[HPI_EXT_REG_FLASH_READ_SIZE] = {HPI_EXT_FLASH_READ_SIG, 0};
+        put_le16(&cmd[2], chunk);
+        put_le32(&cmd[4], addr);
+
+        if (!transport_.write(HPI_EXT_REG_FLASH_READ, cmd, sizeof(cmd)) ||
+            !transport_.wait_interrupt(options_.cmdTimeoutMs)) {
+            error_ = "flash read: " + transport_.last_error();
+            return false;
+        }
+
+        /* Response, data and interrupt clear in one combined transaction. */
+        uint8_t resp[2] = {0, 0};
+        uint8_t clear = hpi::INTR_DEV;
+        const size_t at = data->size();
+        data->resize(at + chunk);
+        const BusOp ops[] = {
+            {BusOp::READ, hpi::REG_RESPONSE, resp, sizeof(resp)},
+            {BusOp::READ, hpi::REG_FLASH_MEM, &(*data)[at], chunk},
+            {BusOp::WRITE, hpi::REG_INTR, &clear, 1},
+        };
+        if (!transport_.transfer(ops, 3)) {
+            error_ = "flash read: " + transport_.last_error();
+            return false;
+        }
+        readCommands_++;
+        if (resp[0] != hpi::RESP_FLASH_DATA_AVAIL) {
+            error_ = std::string("flash read: ") + hpi::response_name(resp[0]) + " (" + hex(resp[0]) + ") at " + hex(addr);
+            return false;
+        }
+        addr += chunk;
+    }
+    return true;
+}
+
+} // namespace pmg1
@@ -0,0 +1,173 @@
+/******************************************************************************
+* File Name: updater.h
+*
+* Description: HPI flashing sequence of the PMG1 bootloader: enter flashing
+*              mode, program, verify, validate and jump.
+*
+*              UpdateSession runs the sequence one command at a time without
+*              blocking, so that one thread can drive several devices on a
+*              bus. Updater drives a single session to completion.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef PMG1_HOST_UPDATER_H
+#define PMG1_HOST_UPDATER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "image.h"
+#include "transport.h"
+
+namespace pmg1 {
+
+struct PhaseStats {
+    std::string name;
+    uint64_t ns = 0;
+    uint64_t bytes = 0;                 /* Payload bytes moved in the phase. */
+    uint32_t commands = 0;
+};
+
+struct UpdateOptions {
+    bool verify = true;
+    bool jump = true;                   /* Reset into the new image once validated. */
+    uint32_t cmdTimeoutMs = 1000;       /* Covers a row write plus the metadata CRC checks. */
+    uint32_t resetTimeoutMs = 2000;
+    uint16_t chunkSize = 0;             /* Send rows in HPI_EXT_REG_FLASH_CHUNK commands of up to
+                                           this many bytes; 0 sends whole rows. */
+};
+
+class UpdateSession {
+public:
+    enum class Stage {
+        CONNECT, JUMP_TO_BOOT, ENTER_FLASH, PROGRAM, METADATA, VERIFY, VALIDATE,
+        EXIT_FLASH, RESET, AWAIT_APP, DONE, FAILED
+    };
+
+    /* What the session needs before step() can make progress. */
+    enum class Wait { INTERRUPT, TIME, DONE, FAILED };
+
+    /* image may be null when starting at EXIT_FLASH. */
+    UpdateSession(Transport &transport, const UpdateImage *image, const UpdateOptions &options,
+                  Stage first = Stage::CONNECT);
+
+    /* Collect the response of the command in flight, if any, and issue the next one.
+       Call once EC_INT is asserted (Wait::INTERRUPT) or wake_ns() is reached (Wait::TIME). */
+    Wait step();
+
+    /* Wait::INTERRUPT: response deadline. Wait::TIME: time to call step() again. */
+    uint64_t wake_ns() const { return wakeNs_; }
+
+    /* Abort the command in flight, e.g. when its response deadline has passed. */
+    void abort(const std::string &reason);
+
+    Stage stage() const { return stage_; }
+    Transport &transport() { return transport_; }
+    const std::vector<PhaseStats> &phases() const { return phases_; }
+    const std::string &error() const { return error_; }
+    uint8_t device_mode() const { return deviceMode_; }
+    uint8_t boot_reason() const { return bootReason_; }
+
+private:
+    Wait issue();
+    void fail(const std::string &error);
+    bool complete();
+    Wait send(const BusOp *ops, size_t count, uint8_t expected, uint32_t timeoutMs, const char *what);
+    bool read_mode();
+    size_t begin_phase(const char *name);
+    void end_phase();
+
+    Transport &transport_;
+    const UpdateImage *image_;
+    UpdateOptions options_;
+    Stage stage_;
+    size_t index_ = 0;
+    bool inFlight_ = false;
+    uint8_t expected_ = 0;
+    const char *what_ = "";
+    uint64_t wakeNs_ = 0;
+    uint64_t deadlineNs_ = 0;
+    uint8_t cmd_[4] = {0, 0, 0, 0};
+
+    std::vector<PhaseStats> phases_;
+    size_t phase_ = 0;
+    std::string error_;
+    uint8_t deviceMode_ = 0;
+    uint8_t bootReason_ = 0;
+    uint16_t rowSize_ = 0;
+    std::vector<uint8_t> rowBuf_;
+    uint16_t chunkOffset_ = 0;          /* Row bytes sent in chunks so far. */
+    uint16_t chunkLen_ = 0;             /* Length of the chunk in flight. */
+};
+
+class Updater {
+public:
+    Updater(Transport &transport, const UpdateOptions &options = UpdateOptions());
+
+    /* Run the whole sequence. On failure, error() describes the failing step. */
+    bool run(const UpdateImage &image);
+
+    /* Leave flashing mode and reset into the new image. */
+    bool jump();
+
+    /* Read any span of flash above the bootloader, e.g. to back up an image or to fetch
+       the metadata. Each command returns up to hpi::FLASH_READ_MAX bytes, across row
+       boundaries. The device has to be in flashing mode. */
+    bool read_flash(uint32_t addr, uint32_t length, std::vector<uint8_t> *data);
+
+    /* Flash read commands issued by the last read_flash() call. */
+    uint32_t read_commands() const { return readCommands_; }
+
+    const std::vector<PhaseStats> &phases() const { return phases_; }
+    const std::string &error() const { return error_; }
+    uint8_t device_mode() const { return deviceMode_; }
+    uint8_t boot_reason() const { return bootReason_; }
+
+private:
+    bool drive(UpdateSession &session);
+
+    Transport &transport_;
+    UpdateOptions options_;
+    std::vector<PhaseStats> phases_;
+    std::string error_;
+    uint8_t deviceMode_ = 0;
+    uint8_t bootReason_ = 0;
+    uint32_t readCommands_ = 0;
+};
+
+} // namespace pmg1
+
+#endif /* PMG1_HOST_UPDATER_H */